@@ -0,0 +1,76 @@
+/** --------------------------------------------------------
+ *
+ *                ALIGNED ALLOCATOR
+ *
+ * Standard allocator handing out storage aligned to a
+ *   given boundary (a cache line by default), so that
+ *    contiguous sample buffers start on a line boundary
+ *     and can be streamed with aligned vector loads.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_ALIGNED_ALLOCATOR_H
+#define MOTION_ALIGNED_ALLOCATOR_H
+
+#include <new>
+#include <cstddef>
+
+namespace Motion
+{
+
+/** Cache line size assumed for alignment */
+constexpr size_t CacheLineSize = 64;
+
+/** Allocator with a fixed minimum alignment */
+template<typename T, size_t Alignment = CacheLineSize>
+struct AlignedAllocator
+{
+    static_assert( Alignment >= alignof(T), "Alignment must not be weaker than the type's own" );
+
+    using value_type = T;
+
+    /** Rebind for containers allocating other types */
+    template<typename U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    /** Constructor */
+    AlignedAllocator() noexcept = default;
+
+    /** Converting constructor */
+    template<typename U>
+    AlignedAllocator( const AlignedAllocator<U, Alignment>& ) noexcept
+    {}
+
+    /** Allocate storage for n objects */
+    inline T* allocate( size_t n )
+    {
+        return static_cast<T*>( ::operator new( n * sizeof(T), std::align_val_t( Alignment ) ) );
+    }
+
+    /** Release storage */
+    inline void deallocate( T* pointer, size_t )
+    {
+        ::operator delete( pointer, std::align_val_t( Alignment ) );
+    }
+
+    /** All instances are interchangeable */
+    template<typename U>
+    inline bool operator==( const AlignedAllocator<U, Alignment>& ) const noexcept
+    {
+        return true;
+    }
+
+    /** All instances are interchangeable */
+    template<typename U>
+    inline bool operator!=( const AlignedAllocator<U, Alignment>& ) const noexcept
+    {
+        return false;
+    }
+};
+
+} // namespace Motion
+
+#endif /** MOTION_ALIGNED_ALLOCATOR_H */
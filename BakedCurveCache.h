@@ -0,0 +1,246 @@
+/** --------------------------------------------------------
+ *
+ *               BAKED CURVE CACHE
+ *
+ * Process-wide cache of precomputed motion curves, baked
+ *   once from 0 to 1 and shared by every motion playing the
+ *    same plan, whatever its starting and ending values.
+ *
+ * Curves are reference counted: the cache only keeps weak
+ *   references, so a curve is released as soon as the last
+ *    motion using it lets go.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_BAKED_CURVE_CACHE_H
+#define MOTION_BAKED_CURVE_CACHE_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstring>
+#include <unordered_map>
+
+#include "MotionPlan.h"
+#include "AlignedAllocator.h"
+#include "MotionStats.h"
+
+namespace Motion
+{
+
+/** Normalized ( 0 to 1 ) baked curve samples */
+using BakedSamples = std::vector<double, AlignedAllocator<double>>;
+
+/** Shared baked curve */
+using BakedCurvePtr = std::shared_ptr<const BakedSamples>;
+
+/** Cache usage counters */
+struct BakedCurveStats
+{
+    /** Requests served by an already baked curve */
+    size_t hits {};
+
+    /** Requests that had to bake a curve */
+    size_t misses {};
+
+    /** Curves currently alive */
+    size_t curves {};
+
+    /** Samples held by the curves currently alive */
+    size_t samples {};
+};
+
+/** Baked curve cache, one per easing policy since curves depend on it */
+template<typename EasingPolicy = DynamicEasing>
+class BakedCurveCache
+{
+    using Key = std::vector<double>;
+
+    /** FNV-1a hash of the key values */
+    struct KeyHash
+    {
+        inline size_t operator()( const Key& key ) const
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for( const auto value : key )
+            {
+                uint64_t bits;
+                std::memcpy( &bits, &value, sizeof(bits) );
+                for( int byte = 0; byte < 8; ++byte )
+                {
+                    hash ^= ( bits >> (byte*8) ) & 0xFF;
+                    hash *= 1099511628211ull;
+                }
+            }
+            return static_cast<size_t>( hash );
+        }
+    };
+
+private:
+
+    /** Guards every member below */
+    std::mutex mutex;
+
+    /** Curves by plan key */
+    std::unordered_map<Key, std::weak_ptr<const BakedSamples>, KeyHash> curves;
+
+    /** Map size at which released curves get purged */
+    size_t purge_threshold { 64 };
+
+    /** Requests served by an already baked curve */
+    size_t hits {};
+
+    /** Requests that had to bake a curve */
+    size_t misses {};
+
+    /** Constructor */
+    BakedCurveCache() = default;
+
+public:
+
+    /** Get the process-wide cache */
+    static BakedCurveCache& Instance()
+    {
+        static BakedCurveCache cache;
+        return cache;
+    }
+
+    /** Build cache key from everything a baked curve depends on */
+    static Key MakeKey( const MotionPlan& plan )
+    {
+        Key key;
+        key.reserve( 3 + plan.GetSegmentCount() * 15 );
+        key.emplace_back( plan.GetFrameDuration() );
+        key.emplace_back( plan.GetInitialElapsed() );
+        key.emplace_back( plan.GetSegmentCount() );
+
+        for( const auto& segment : plan.GetSegments() )
+        {
+            key.emplace_back( static_cast<double>( segment.motion_type ) );
+            key.emplace_back( static_cast<double>( segment.accel_type ) );
+            key.emplace_back( segment.modifier );
+            key.emplace_back( segment.gravity );
+            key.emplace_back( segment.frame_scale );
+            key.emplace_back( segment.end_frame );
+            key.emplace_back( segment.length );
+            key.emplace_back( segment.window_from );
+            key.emplace_back( segment.window_span );
+            key.emplace_back( segment.window_start );
+            key.emplace_back( segment.window_scale );
+
+            const auto bezier = ( segment.bezier ? segment.bezier->GetPoints() : BezierPoints{ 0, 0, 0, 0 } );
+            key.emplace_back( bezier.x1 );
+            key.emplace_back( bezier.y1 );
+            key.emplace_back( bezier.x2 );
+            key.emplace_back( bezier.y2 );
+        }
+
+        // Equal keys must hash equally, -0 and 0 included
+        for( auto& value : key )
+        {
+            value += 0.0;
+        }
+
+        return key;
+    }
+
+    /** Get the curve baked for a plan, baking it with bake() on a miss ( outside the lock, so hits on other curves never wait for it ) */
+    template<typename Baker>
+    BakedCurvePtr Acquire( const MotionPlan& plan, Baker&& bake )
+    {
+        auto key = MakeKey( plan );
+
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+
+            const auto it = curves.find( key );
+            if( it != curves.end() )
+            {
+                if( auto curve = it->second.lock() )
+                {
+                    hits++;
+                    Stats::Add( StatsCounter::CURVE_CACHE_HITS );
+                    return curve;
+                }
+            }
+
+            misses++;
+        }
+
+        Stats::Add( StatsCounter::CURVE_CACHE_MISSES );
+        BakedCurvePtr curve = std::make_shared<const BakedSamples>( bake() );
+
+        std::lock_guard<std::mutex> lock( mutex );
+
+        // Another thread may have baked the same curve meanwhile, the one already shared wins
+        const auto it = curves.find( key );
+        if( it != curves.end() )
+        {
+            if( auto baked = it->second.lock() )
+            {
+                return baked;
+            }
+            it->second = curve;
+            return curve;
+        }
+
+        if( curves.size() >= purge_threshold )
+        {
+            Purge();
+            purge_threshold = 2 * curves.size() + 64;
+        }
+
+        curves.emplace( std::move(key), curve );
+        return curve;
+    }
+
+    /** Get usage counters */
+    BakedCurveStats GetStats()
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+
+        BakedCurveStats stats;
+        stats.hits = hits;
+        stats.misses = misses;
+        for( const auto& entry : curves )
+        {
+            if( auto curve = entry.second.lock() )
+            {
+                stats.curves++;
+                stats.samples += curve->size();
+            }
+        }
+        return stats;
+    }
+
+    /** Clear hit and miss counters */
+    void ResetStats()
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        hits = 0;
+        misses = 0;
+    }
+
+private:
+
+    /** Drop entries of released curves */
+    void Purge()
+    {
+        for( auto it = curves.begin(); it != curves.end(); )
+        {
+            if( it->second.expired() )
+            {
+                it = curves.erase( it );
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+}; // class BakedCurveCache
+
+} // namespace Motion
+
+#endif /** MOTION_BAKED_CURVE_CACHE_H */
@@ -0,0 +1,233 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+#include "../Motion.h"
+#include "../MotionSystem.h"
+
+// The replacement operators below pair malloc() with free(), GCC can't tell once they are inlined
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_motions = 256;
+    constexpr uint32_t default_rounds = 40;
+    constexpr uint32_t frames = 90;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+
+    /** Heap allocations made so far */
+    size_t allocations = 0;
+
+    /** Allocations and time of one case */
+    struct Report
+    {
+        size_t start_allocations {};
+        size_t frame_allocations {};
+        size_t starts {};
+        size_t frames {};
+        double start_ns {};
+    };
+}
+
+void* operator new( size_t size )
+{
+    allocations++;
+    if( auto* p = std::malloc( size ? size : 1 ) ) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[]( size_t size )
+{
+    return operator new( size );
+}
+
+void* operator new( size_t size, std::align_val_t alignment )
+{
+    allocations++;
+    const auto align = static_cast<size_t>( alignment );
+    if( auto* p = std::aligned_alloc( align, ( size + align - 1 ) / align * align ) ) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete( void* p ) noexcept { std::free( p ); }
+void operator delete[]( void* p ) noexcept { std::free( p ); }
+void operator delete( void* p, size_t ) noexcept { std::free( p ); }
+void operator delete[]( void* p, size_t ) noexcept { std::free( p ); }
+void operator delete( void* p, std::align_val_t ) noexcept { std::free( p ); }
+void operator delete( void* p, size_t, std::align_val_t ) noexcept { std::free( p ); }
+
+/** Queue of 1 to MotionQueueCapacity segments, built without allocating */
+template<typename ValueType>
+Motion::MotionQueue<ValueType> MakeQueue( uint32_t i )
+{
+    const auto segments = 1 + i % Motion::MotionQueueCapacity;
+
+    Motion::MotionQueue<ValueType> queue;
+    for( uint32_t s = 0; s < segments; ++s )
+    {
+        queue.push_back( { static_cast<Motion::Type>( (i + s) % type_count ), ( s % 2 ? Motion::Acceleration::OUT : Motion::Acceleration::IN ),
+                           1.0 / segments, 1.0 / segments, 0, 1, 2, 3 } );
+    }
+    return queue;
+}
+
+/** Start every motion once per round, then play a few frames, counting the allocations of each ( the first round warms up ) */
+template<typename Start, typename Frame>
+Report Measure( uint32_t motions, uint32_t rounds, Start&& start, Frame&& frame )
+{
+    Report report;
+    for( uint32_t r = 0; r <= rounds; ++r )
+    {
+        const auto start_before = allocations;
+        const auto begin = Clock::now();
+        for( uint32_t i = 0; i < motions; ++i )
+        {
+            start( i, r * 7 + i );
+        }
+        const auto end = Clock::now();
+        const auto frame_before = allocations;
+
+        for( uint32_t f = 0; f < frames; ++f )
+        {
+            frame();
+        }
+
+        if( r > 0 )
+        {
+            report.start_allocations += frame_before - start_before;
+            report.frame_allocations += allocations - frame_before;
+            report.starts += motions;
+            report.frames += frames;
+            report.start_ns += std::chrono::duration<double, std::nano>( end - begin ).count();
+        }
+    }
+    report.start_ns /= report.starts;
+    return report;
+}
+
+/** Measure starting and playing a vector of motion objects */
+template<typename Motions, typename Start>
+Report MeasureObjects( Motions& motions, uint32_t rounds, Start&& start )
+{
+    return Measure( static_cast<uint32_t>( motions.size() ), rounds,
+        [&]( uint32_t m, uint32_t i ) { start( motions[m], i ); },
+        [&]()
+        {
+            for( auto& motion : motions )
+            {
+                motion.AdvanceToNext();
+            }
+        } );
+}
+
+/** A plan handed out by a motion keeps its easing when the motion is restarted with another one, observed or held */
+template<typename Core, typename Point>
+size_t ValidateHandedPlan( Point start, Point end )
+{
+    const auto easing = []( const Motion::MotionPlanPtr& plan ) { return plan->GetSegments().front().motion_type; };
+
+    Core observing, holding;
+    observing.SetParameters( start, end, frames, Motion::Type::SINE );
+    holding.SetParameters( start, end, frames, Motion::Type::SINE );
+    const std::weak_ptr<const Motion::MotionPlan> observed = observing.GetMotionPlan();
+    const auto held = holding.GetMotionPlan();
+    observing.SetParameters( start, end, frames, Motion::Type::BOUNCE );
+    holding.SetParameters( start, end, frames, Motion::Type::BOUNCE );
+
+    const auto locked = observed.lock();
+    const bool failed = ( ( locked && easing( locked ) != Motion::Type::SINE ) || easing( held ) != Motion::Type::SINE
+                       || easing( observing.GetMotionPlan() ) != Motion::Type::BOUNCE );
+    if( failed )
+    {
+        std::cout << "handed out plan changed on restart" << std::endl;
+    }
+    return failed;
+}
+
+/** Print a case, returns true if it allocated after warming up */
+bool Print( const std::string& name, const Report& report )
+{
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(8) << double(report.start_allocations) / report.starts << " allocs/start  "
+              << std::setw(8) << double(report.frame_allocations) / report.frames << " allocs/frame  "
+              << std::setw(9) << std::setprecision(1) << report.start_ns << " ns/start" << std::endl;
+
+    return report.start_allocations + report.frame_allocations > 0;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t motions = ( argc > 1 ? std::stoul( argv[1] ) : default_motions );
+    const uint32_t rounds = ( argc > 2 ? std::stoul( argv[2] ) : default_rounds );
+
+    size_t failures = ValidateHandedPlan<Motion::MotionCore<double>>( 0.0, 100.0 )
+                    + ValidateHandedPlan<Motion::MotionVectorCore<double, 2>>( std::array<double, 2> { 0, 10 }, std::array<double, 2> { 100, -10 } );
+
+    {
+        std::vector<Motion::MotionCore<double>> cores( motions );
+        failures += Print( "core simple", MeasureObjects( cores, rounds,
+            []( auto& core, uint32_t i ) { core.SetParameters( i % 100, 500 + i % 700, frames/2 + i % frames, static_cast<Motion::Type>( i % type_count ) ); } ) );
+
+        failures += Print( "core queue 1-8", MeasureObjects( cores, rounds,
+            []( auto& core, uint32_t i ) { core.SetParameters( i % 100, 500 + i % 700, frames/2 + i % frames, MakeQueue<double>( i ) ); } ) );
+    }
+
+    {
+        std::vector<Motion::MotionCore<int, Motion::DynamicEasing, Motion::FixedPointMath<>>> cores( motions );
+        failures += Print( "core fixed point", MeasureObjects( cores, rounds,
+            []( auto& core, uint32_t i ) { core.SetParameters( i % 100, 500 + i % 700, frames/2 + i % frames, MakeQueue<int>( i ) ); } ) );
+    }
+
+    {
+        std::vector<Motion::Motion2D<double>> points( motions );
+        failures += Print( "2D shared queue", MeasureObjects( points, rounds,
+            []( auto& point, uint32_t i ) { point.SetParameters( {0, 10}, {500.0 + i % 700, -300}, frames/2 + i % frames, MakeQueue<double>( i ) ); } ) );
+    }
+
+    {
+        std::vector<Motion::Motion3D<double>> points( motions );
+        failures += Print( "3D per axis queues", MeasureObjects( points, rounds,
+            []( auto& point, uint32_t i )
+            {
+                const auto queue = MakeQueue<double>( i );
+                point.SetParameters( {0, 10, 20}, {500.0 + i % 700, 300, -200}, frames/2 + i % frames, queue, queue, MakeQueue<double>( i + 3 ) );
+            } ) );
+    }
+
+    {
+        std::vector<Motion::MotionND<double, 4>> points( motions );
+        failures += Print( "4D simple", MeasureObjects( points, rounds,
+            []( auto& point, uint32_t i )
+            {
+                Motion::PointND<double, 4> from, to;
+                from.values = { 0, 1, 2, 3 };
+                to.values = { 500.0 + i % 700, 300, -200, 9 };
+                point.SetParameters( from, to, frames/2 + i % frames, static_cast<Motion::Type>( i % type_count ) );
+            } ) );
+    }
+
+    {
+        // Every channel is replaced once per round
+        Motion::MotionSystem<double> system;
+        system.Reserve( motions, Motion::MotionQueueCapacity );
+        std::vector<Motion::ChannelHandle> handles( motions );
+        failures += Print( "system add", Measure( motions, rounds,
+            [&]( uint32_t m, uint32_t i )
+            {
+                system.Remove( handles[m] );
+                handles[m] = system.Add( i % 100, 500 + i % 700, frames/2 + i % frames, MakeQueue<double>( i ) );
+            },
+            [&]() { system.Update(); } ) );
+    }
+
+    std::cout << "motions:       " << motions << std::endl;
+    std::cout << "rounds:        " << rounds << std::endl;
+    std::cout << "failures:      " << failures << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
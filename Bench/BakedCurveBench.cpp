@@ -0,0 +1,150 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <thread>
+#include <atomic>
+
+#include "../MotionCore.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_cores = 10000;
+    constexpr uint32_t default_curves = 16;
+    constexpr uint32_t frames = 600;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+
+    /** Largest allowed difference from own baking, relative to the motion range */
+    constexpr double max_error = 1e-12;
+}
+
+double Bake( std::vector<Motion::MotionCore<double>>& cores, uint32_t curves, bool shared )
+{
+    const auto begin = Clock::now();
+    for( uint32_t i = 0; i < cores.size(); ++i )
+    {
+        const auto curve = i % curves;
+        cores[i].SetRuntimeCalculation( false );
+        cores[i].SetSharedBaking( shared );
+        cores[i].SetParameters( i % 100, 500 + i % 700, frames/2 + curve, static_cast<Motion::Type>( curve % type_count ) );
+    }
+    const auto end = Clock::now();
+    return std::chrono::duration<double, std::milli>( end - begin ).count();
+}
+
+/** Plan of a single easing over a duration */
+std::shared_ptr<const Motion::MotionPlan> MakePlan( Motion::Type type, Motion::TimeType duration )
+{
+    Motion::MotionQueue<double> queue;
+    queue.push_back( { type, Motion::Acceleration::IN, 1.0, 1.0, 0, 1 } );
+    return Motion::MotionPlan::Compile( queue, duration );
+}
+
+/** A slow bake on another thread must not hold up hits on other curves */
+size_t ValidateConcurrentBake( Motion::BakedCurveCache<>& cache )
+{
+    const auto ready = MakePlan( Motion::Type::SINE, 1234 );
+    const auto slow = MakePlan( Motion::Type::BOUNCE, 4321 );
+    const auto held = cache.Acquire( *ready, []{ return Motion::BakedSamples( 8, 0.5 ); } );
+
+    std::atomic<bool> baking { false }, served { false };
+    bool blocked = false;
+    std::thread baker( [&]
+    {
+        cache.Acquire( *slow, [&]
+        {
+            // Waits for the hit below, giving up after a while if it never comes
+            baking = true;
+            const auto give_up = Clock::now() + std::chrono::seconds( 2 );
+            while( !served && Clock::now() < give_up )
+            {
+                std::this_thread::yield();
+            }
+            blocked = !served;
+            return Motion::BakedSamples( 8, 0.5 );
+        } );
+    } );
+
+    while( !baking )
+    {
+        std::this_thread::yield();
+    }
+    const auto hit = cache.Acquire( *ready, []{ return Motion::BakedSamples(); } );
+    served = true;
+    baker.join();
+
+    if( blocked || hit != held )
+    {
+        std::cout << "hit waited for a bake on another thread" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t count = ( argc > 1 ? std::stoul( argv[1] ) : default_cores );
+    const uint32_t curves = ( argc > 2 ? std::stoul( argv[2] ) : default_curves );
+
+    auto& cache = Motion::BakedCurveCache<>::Instance();
+    size_t failures = ValidateConcurrentBake( cache );
+    cache.ResetStats();
+
+    double own_ms = 0, shared_ms = 0, error = 0;
+    size_t own_bytes = 0, shared_bytes = 0;
+    Motion::BakedCurveStats stats;
+    {
+        std::vector<Motion::MotionCore<double>> own( count ), shared( count );
+        own_ms = Bake( own, curves, false );
+        shared_ms = Bake( shared, curves, true );
+        stats = cache.GetStats();
+
+        for( auto& core : own )
+        {
+            own_bytes += core.GetInterpolatedValues().capacity() * sizeof(double);
+        }
+        shared_bytes = stats.samples * sizeof(double);
+
+        // Shared curves scaled into each range must play like own baking
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            const auto range = std::fabs( shared[i].GetEndingValue() - shared[i].GetStartingValue() );
+            while( !own[i].HasFinished() )
+            {
+                own[i].AdvanceToNext();
+                shared[i].AdvanceToNext();
+                error = std::fmax( error, std::fabs( own[i].GetCurrentValue() - shared[i].GetCurrentValue() ) / range );
+            }
+
+            if( !shared[i].HasFinished() )
+            {
+                failures++;
+            }
+        }
+    }
+
+    // Curves are released along with the last motion using them
+    const auto released = cache.GetStats();
+
+    if( stats.misses != curves || stats.hits != count - curves || stats.curves != curves || released.curves != 0 || error > max_error )
+    {
+        failures++;
+    }
+
+    std::cout << "motions:       " << count << std::endl;
+    std::cout << "unique curves: " << curves << std::endl;
+    std::cout << "hits/misses:   " << stats.hits << "/" << stats.misses << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "own bake:      " << own_ms << " ms, " << own_bytes / 1024.0 << " KiB" << std::endl;
+    std::cout << "shared bake:   " << shared_ms << " ms, " << shared_bytes / 1024.0 << " KiB" << std::endl;
+    std::cout << "speedup:       " << own_ms / shared_ms << "x" << std::endl;
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "max error:     " << error << " of range" << std::endl;
+    std::cout << "failures:      " << failures << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,259 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "../Motion.h"
+#include "../EasingBatch.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr size_t default_samples = 100003;
+    constexpr uint32_t repeats = 20;
+    constexpr uint32_t frames = 600;
+
+    /** Largest error against a solve to full precision */
+    constexpr double max_error = 1e-12;
+
+    /** Largest error where x(t) has a stationary point, y then moves with the cube root of x ( ~6e-6 per epsilon ) */
+    constexpr double stationary_max_error = 1e-5;
+
+    const char* path_names[] = { "SCALAR", "SSE2", "AVX2", "AVX512" };
+
+    struct Curve
+    {
+        const char* name;
+        Motion::BezierPoints points;
+        double max_error;
+    };
+
+    /** Curves checked, the CSS keywords first */
+    const Curve curves[] =
+    {
+        { "ease",         { 0.25, 0.1, 0.25, 1.0 },     max_error },
+        { "ease-in",      { 0.42, 0.0, 1.0, 1.0 },      max_error },
+        { "ease-out",     { 0.0, 0.0, 0.58, 1.0 },      max_error },
+        { "ease-in-out",  { 0.42, 0.0, 0.58, 1.0 },     max_error },
+        { "linear",       { 0.0, 0.0, 1.0, 1.0 },       max_error },
+        { "overshoot",    { 0.68, -0.55, 0.27, 1.55 },  max_error },
+        { "steep",        { 0.0, 1.0, 1.0, 0.0 },       max_error },
+        { "flat",         { 1.0, 0.0, 0.0, 1.0 },       stationary_max_error },
+    };
+}
+
+/** Error in units of the last place of max(|reference|, 1) */
+double UlpError( double value, double reference )
+{
+    if( std::isnan( value ) && std::isnan( reference ) )
+    {
+        return 0;
+    }
+    const auto scale = std::max( std::fabs( reference ), 1.0 ) * std::numeric_limits<double>::epsilon();
+    return std::fabs( value - reference ) / scale;
+}
+
+/** Eased value by bisection to the last bit, in long double */
+double Reference( const Motion::BezierPoints& p, double progress )
+{
+    const auto coordinate = []( long double p1, long double p2, long double t )
+    {
+        const auto u = 1 - t;
+        return 3*u*u*t*p1 + 3*u*t*t*p2 + t*t*t;
+    };
+
+    long double lo = 0, hi = 1;
+    for( int i = 0; i < 80; ++i )
+    {
+        const auto mid = (lo + hi) / 2;
+        ( coordinate( p.x1, p.x2, mid ) < progress ? lo : hi ) = mid;
+    }
+    return static_cast<double>( coordinate( p.y1, p.y2, (lo + hi) / 2 ) );
+}
+
+/** Time a function over all samples, in ns per sample */
+template<typename Function>
+double TimeSamples( const std::vector<double>& progress, double& checksum, Function function )
+{
+    const auto begin = Clock::now();
+    for( uint32_t r = 0; r < repeats; ++r )
+    {
+        for( const auto x : progress )
+        {
+            checksum += function( x );
+        }
+    }
+    return std::chrono::duration<double, std::nano>( Clock::now() - begin ).count() / ( double(repeats) * progress.size() );
+}
+
+/** Time a batch kernel over all samples, in ns per sample */
+template<typename Function>
+double TimeBatch( const std::vector<double>& progress, std::vector<double>& out, double& checksum, Function function )
+{
+    const auto begin = Clock::now();
+    for( uint32_t r = 0; r < repeats; ++r )
+    {
+        function( progress.data(), out.data(), progress.size() );
+        checksum += out[r % out.size()];
+    }
+    return std::chrono::duration<double, std::nano>( Clock::now() - begin ).count() / ( double(repeats) * progress.size() );
+}
+
+/** Time a motion played through, in ns per frame */
+double TimeCore( Motion::MotionCore<double>& core, double& checksum )
+{
+    const auto begin = Clock::now();
+    for( uint32_t r = 0; r < repeats; ++r )
+    {
+        core.Reset();
+        while( !core.HasFinished() )
+        {
+            core.AdvanceToNext();
+            checksum += core.GetCurrentValue();
+        }
+    }
+    return std::chrono::duration<double, std::nano>( Clock::now() - begin ).count() / ( double(repeats) * frames );
+}
+
+/** Bezier motions must play the curve, bake the same values and keep their solver across rebuilds */
+size_t ValidateCore()
+{
+    size_t mismatches = 0;
+    const Motion::BezierPoints points { 0.68, -0.55, 0.27, 1.55 };
+    const Motion::CubicBezier curve( points );
+
+    Motion::MotionQueue<double> queue;
+    queue.push_back( { Motion::Type::BEZIER, Motion::Acceleration::IN, 1, 1, 0, 1, 0, 0, points } );
+
+    Motion::MotionCore<double> runtime, baked( false );
+    runtime.SetParameters( 100, 900, frames, queue );
+    baked.SetParameters( 100, 900, frames, queue );
+
+    for( uint32_t frame = 1; !runtime.HasFinished(); ++frame )
+    {
+        runtime.AdvanceToNext();
+        baked.AdvanceToNext();
+
+        // The segment completes within 10% of its end, on the end value
+        if( runtime.HasFinished() )
+        {
+            break;
+        }
+
+        const auto expected = Motion::MotionPlanSegment::Apply( curve.Value( static_cast<double>( frame ) / frames ), 100, 900 );
+        if( std::fabs( runtime.GetCurrentValue() - expected ) > 1e-9 || runtime.GetCurrentValue() != baked.GetCurrentValue() )
+        {
+            if( mismatches++ < 8 )
+            {
+                std::cout << "frame " << frame << ": " << runtime.GetCurrentValue() << " / " << baked.GetCurrentValue() << " / " << expected << std::endl;
+            }
+        }
+    }
+
+    Motion::MotionPlan plan;
+    plan.Rebuild( queue, frames );
+    const auto* solver = plan[0].bezier.get();
+    plan.Rebuild( queue, frames );
+    if( plan[0].bezier.get() != solver )
+    {
+        std::cout << "rebuild with the same points made a new solver" << std::endl;
+        mismatches++;
+    }
+
+    queue.front().bezier.y2 = 1.0;
+    plan.Rebuild( queue, frames );
+    if( plan[0].bezier->GetPoints().y2 != 1.0 )
+    {
+        std::cout << "rebuild with new points kept the old solver" << std::endl;
+        mismatches++;
+    }
+
+    return mismatches;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const size_t samples = ( argc > 1 ? std::stoul( argv[1] ) : default_samples );
+
+    std::vector<double> progress( samples ), inside( samples ), batch( samples ), first( samples ), second( samples );
+    for( size_t i = 0; i < samples; ++i )
+    {
+        progress[i] = -0.2 + 1.4 * static_cast<double>( i ) / ( samples - 1 );
+        inside[i] = static_cast<double>( i + 1 ) / ( samples + 1 );
+    }
+
+    size_t failures = ValidateCore();
+
+    std::cout << "selected path:   " << path_names[static_cast<int>( Motion::GetBatchPath() )]
+              << ( Motion::BatchSimdCompiled ? "" : " ( SIMD paths need GCC on x86 )" ) << std::endl;
+    std::cout << std::left << std::setw(14) << "curve" << std::right << std::setw(12) << "max error"
+              << std::setw(12) << "value ulp" << std::setw(12) << "rate ulp" << std::endl;
+
+    for( const auto& c : curves )
+    {
+        const Motion::CubicBezier curve( c.points );
+
+        // Scalar against the full precision solve ( only inside, the tangents outside are exact )
+        double error = 0;
+        for( const auto x : inside )
+        {
+            error = std::max( error, std::fabs( curve.Value( x ) - Reference( c.points, x ) ) );
+        }
+        failures += !( error <= c.max_error );
+
+        // Batch against scalar, on every path and over both accelerations
+        double value_ulp = 0;
+        double rate_ulp = 0;
+        for( auto path : { Motion::BatchPath::SCALAR, Motion::BatchPath::SSE2, Motion::BatchPath::AVX2, Motion::BatchPath::AVX512 } )
+        {
+            if( !Motion::IsBatchPathSupported( path ) || !Motion::Batch::GetBezierKernel( path ) )
+            {
+                continue;
+            }
+
+            for( auto accel : { Motion::Acceleration::IN, Motion::Acceleration::OUT } )
+            {
+                Motion::EvaluateBatch( path, curve, accel, progress.data(), batch.data(), samples );
+                Motion::EvaluateBatchDerivatives( path, curve, accel, progress.data(), first.data(), second.data(), samples );
+                for( size_t i = 0; i < samples; ++i )
+                {
+                    const auto d = Motion::EasingFunctions::GetFunctionDerivatives( progress[i], 0.0, 1.0, Motion::Type::BEZIER, accel, 0, 0, &curve );
+                    value_ulp = std::max( value_ulp, UlpError( batch[i], d.value ) );
+                    rate_ulp = std::max( { rate_ulp, UlpError( first[i], d.first ), UlpError( second[i], d.second ) } );
+                }
+            }
+        }
+        failures += !( value_ulp <= Motion::BatchMaxUlp ) + !( rate_ulp <= Motion::BatchDerivativeMaxUlp );
+
+        std::cout << std::left << std::setw(14) << c.name << std::right << std::scientific << std::setprecision(2) << std::setw(12) << error
+                  << std::fixed << std::setw(12) << value_ulp << std::setw(12) << rate_ulp << std::endl;
+    }
+
+    // Cost per sample against the sine easing
+    const Motion::CubicBezier ease( curves[0].points );
+    double checksum = 0;
+    const auto sine_ns = TimeSamples( inside, checksum, []( double x ) { return Motion::EasingFunctions::GetFunctionValue( x, 0, 1, Motion::Type::SINE, Motion::Acceleration::OUT ); } );
+    const auto bezier_ns = TimeSamples( inside, checksum, [&]( double x ) { return Motion::EasingFunctions::GetFunctionValue( x, 0, 1, Motion::Type::BEZIER, Motion::Acceleration::OUT, 0, 0, &ease ); } );
+    const auto sine_batch_ns = TimeBatch( inside, batch, checksum, []( const double* in, double* out, size_t n ) { Motion::EvaluateBatch( Motion::Type::SINE, Motion::Acceleration::OUT, in, out, n ); } );
+    const auto bezier_batch_ns = TimeBatch( inside, batch, checksum, [&]( const double* in, double* out, size_t n ) { Motion::EvaluateBatch( ease, Motion::Acceleration::OUT, in, out, n ); } );
+
+    Motion::MotionQueue<double> queue;
+    queue.push_back( { Motion::Type::BEZIER, Motion::Acceleration::IN, 1, 1, 0, 1, 0, 0, curves[0].points } );
+    Motion::MotionCore<double> sine_core, bezier_core;
+    sine_core.SetParameters( 0, 1000, frames, Motion::Type::SINE );
+    bezier_core.SetParameters( 0, 1000, frames, queue );
+    const auto sine_core_ns = TimeCore( sine_core, checksum );
+    const auto bezier_core_ns = TimeCore( bezier_core, checksum );
+
+    std::cout << std::setprecision(2);
+    std::cout << "sine ns:         " << sine_ns << " scalar, " << sine_batch_ns << " batch, " << sine_core_ns << " core" << std::endl;
+    std::cout << "bezier ns:       " << bezier_ns << " scalar, " << bezier_batch_ns << " batch, " << bezier_core_ns << " core" << std::endl;
+    std::cout << "bezier/sine:     " << bezier_ns / sine_ns << "x scalar, " << bezier_batch_ns / sine_batch_ns << "x batch, " << bezier_core_ns / sine_core_ns << "x core" << std::endl;
+    std::cout << "checksum:        " << checksum << std::endl;
+    std::cout << "failures:        " << failures << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
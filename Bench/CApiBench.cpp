@@ -0,0 +1,182 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+#include "../Tool/libmotion.h"
+#include "../Tool/MotionText.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_repeats = 2000;
+
+    /** Process spawns timed for the comparison */
+    constexpr uint32_t spawns = 20;
+
+    const char* examples[] =
+    {
+        "linear", "pow", "quad", "cubic", "back", "circular", "elastic", "bounce", "sbounce", "sine", "exp", "bezier"
+    };
+
+    const char* example_dirs[] = { "in", "out", "both" };
+}
+
+std::string ReadText( const std::string& path )
+{
+    std::ifstream file( path );
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+/** Bakes through the C interface must match a baked MotionCore bit for bit, and evaluation must match the samples */
+size_t ValidateExample( const std::string& text, const std::string& name )
+{
+    std::istringstream in( text );
+    const auto definition = MotionText::Parse( in );
+    Motion::MotionCore<double> motion( false );
+    motion.SetParameters( definition.start_value, definition.end_value, static_cast<Motion::TimeType>( definition.duration ), definition.queue );
+    const auto& expected = motion.GetInterpolatedValues();
+
+    auto curve = motion_parse( text.c_str() );
+    std::vector<double> samples( motion_get_sample_count( curve ) );
+    const auto count = motion_bake( curve, samples.data(), samples.size() );
+
+    size_t mismatches = ( count != expected.size() || samples.size() != expected.size() );
+    for( size_t i = 0; !mismatches && i < samples.size(); ++i )
+    {
+        mismatches += ( std::memcmp( &samples[i], &expected[i], sizeof(double) ) != 0 );
+        mismatches += ( motion_evaluate( curve, i + 1.0 ) != expected[i] );
+    }
+
+    // Between two frames the value lies between their samples
+    if( samples.size() > 2 )
+    {
+        const auto half = motion_evaluate( curve, 1.5 );
+        mismatches += !( half >= std::min( samples[0], samples[1] ) && half <= std::max( samples[0], samples[1] ) );
+    }
+
+    motion_destroy( curve );
+
+    if( mismatches > 0 )
+    {
+        std::cout << name << ": " << mismatches << " samples differ" << std::endl;
+    }
+    return mismatches;
+}
+
+/** Curves built element by element, and malformed input */
+size_t ValidateInterface()
+{
+    size_t failures = 0;
+
+    const auto text = "0, 100, 60\nSINE, OUT, 0.5, 0.5, 0, 1, 4, 2\nBEZIER, IN, 0.5, 0.5, 0, 1, 0.25, 0.1, 0.25, 1\n";
+    auto parsed = motion_parse( text );
+    auto built = motion_create( 0, 100, 60 );
+    failures += ( motion_add_segment( built, MOTION_SINE, MOTION_OUT, 0.5, 0.5, 0, 1, 4, 2 ) != MOTION_OK );
+    failures += ( motion_add_bezier( built, 0.5, 0.5, 0.25, 0.1, 0.25, 1 ) != MOTION_OK );
+
+    std::vector<double> a( 60 ), b( 60 );
+    motion_bake( parsed, a.data(), a.size() );
+    motion_bake( built, b.data(), b.size() );
+    failures += ( a != b );
+
+    // A last line without a line break is part of the queue too
+    const std::string unterminated( text, std::strlen( text ) - 1 );
+    auto last = motion_parse( unterminated.c_str() );
+    std::vector<double> c( 60 );
+    motion_bake( last, c.data(), c.size() );
+    failures += ( c != a );
+    motion_destroy( last );
+
+    // Lines are read whole, however long, instead of ending the queue
+    const std::string padding( 300, ' ' );
+    const auto long_line = "0, 100, 60\nSINE, OUT, 0.5, 0.5, 0, 1, 4," + padding + "2\nBEZIER, IN, 0.5, 0.5, 0, 1, 0.25, 0.1, 0.25, 1\n";
+    auto padded = motion_parse( long_line.c_str() );
+    std::vector<double> d( 60 );
+    failures += ( padded == nullptr || motion_get_sample_count( padded ) != 60 );
+    motion_bake( padded, d.data(), d.size() );
+    failures += ( d != a );
+    motion_destroy( padded );
+
+    // A short buffer gets what fits, and the full count back
+    failures += ( motion_bake( built, b.data(), 10 ) != 60 );
+
+    // Changing the range recompiles the plan
+    motion_set_range( built, 0, 200, 60 );
+    failures += ( motion_evaluate( built, 60 ) != 200 );
+    motion_clear( built );
+    failures += ( motion_add_segment( built, 42, MOTION_IN, 1, 1, 0, 1, 0, 0 ) != MOTION_ERROR_ARGUMENT );
+
+    failures += ( motion_parse( nullptr ) != nullptr );
+    failures += ( motion_parse( "0, 1, x\n" ) != nullptr );
+    failures += ( motion_set_range( nullptr, 0, 1, 1 ) != MOTION_ERROR_ARGUMENT );
+    failures += ( motion_api_version() != MOTION_API_VERSION );
+
+    motion_destroy( parsed );
+    motion_destroy( built );
+    motion_destroy( nullptr );
+
+    if( failures > 0 )
+    {
+        std::cout << "interface: " << failures << " checks failed" << std::endl;
+    }
+    return failures;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t repeats = ( argc > 1 ? std::stoul( argv[1] ) : default_repeats );
+
+    size_t failures = ValidateInterface();
+    std::vector<std::string> texts;
+    for( const auto example : examples )
+    {
+        for( const auto dir : example_dirs )
+        {
+            const auto name = std::string( example ) + "_" + dir;
+            texts.emplace_back( ReadText( "../Tool/examples/" + name + ".txt" ) );
+            failures += ValidateExample( texts.back(), name );
+        }
+    }
+
+    // A preview as MotionTool.py does it: parse the text and bake into its buffer
+    std::vector<double> samples;
+    double checksum = 0;
+    auto begin = Clock::now();
+    for( uint32_t r = 0; r < repeats; ++r )
+    {
+        const auto& text = texts[r % texts.size()];
+        auto curve = motion_parse( text.c_str() );
+        samples.resize( motion_get_sample_count( curve ) );
+        motion_bake( curve, samples.data(), samples.size() );
+        motion_destroy( curve );
+        checksum += samples.back();
+    }
+    const auto preview_us = std::chrono::duration<double, std::micro>( Clock::now() - begin ).count() / repeats;
+
+    // Lower bound of a preview through MotionTool: starting an empty process
+    begin = Clock::now();
+    for( uint32_t s = 0; s < spawns; ++s )
+    {
+        checksum += std::system( "true" );
+    }
+    const auto spawn_us = std::chrono::duration<double, std::micro>( Clock::now() - begin ).count() / spawns;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "examples:        " << texts.size() << std::endl;
+    std::cout << "preview us:      " << preview_us << " parse and bake in process" << std::endl;
+    std::cout << "spawn us:        " << spawn_us << " empty process" << std::endl;
+    std::cout << "speedup:         " << spawn_us / preview_us << "x ( at least )" << std::endl;
+    std::cout << "checksum:        " << checksum << std::endl;
+    std::cout << "failures:        " << failures << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+
+#include "../Motion.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_frames = 600;
+    constexpr double default_error = 0.05;
+    constexpr uint32_t repeats = 200;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+
+    const char* type_names[] =
+    {
+        "LINEAR", "POW", "QUAD", "CUBIC", "BACK", "CIRCULAR", "ELASTIC", "BOUNCE", "SINE", "EXPONENTIAL"
+    };
+}
+
+/** Time playing a motion through, in ns per frame */
+template<typename Core>
+double PlaybackNanoseconds( Core& core, double& checksum )
+{
+    const auto begin = Clock::now();
+    for( uint32_t r = 0; r < repeats; ++r )
+    {
+        core.Reset();
+        while( !core.HasFinished() )
+        {
+            core.AdvanceToNext();
+            checksum += core.GetCurrentValue();
+        }
+    }
+    return std::chrono::duration<double, std::nano>( Clock::now() - begin ).count() / ( double(repeats) * core.GetBakedCount() );
+}
+
+/** Compressed playback must stay within the error of the baked values, integral values exactly */
+size_t Validate( uint32_t frames, double max_error )
+{
+    size_t mismatches = 0;
+    for( uint8_t t = 0; t < type_count; ++t )
+    {
+        const auto type = static_cast<Motion::Type>( t );
+
+        Motion::MotionCore<double> baked( false ), compressed( false );
+        compressed.SetCompression( max_error );
+        baked.SetParameters( -100, 900, frames, type );
+        compressed.SetParameters( -100, 900, frames, type );
+
+        Motion::MotionCore<int> baked_int( false ), compressed_int( false );
+        compressed_int.SetCompression( 0.49 );
+        baked_int.SetParameters( -100, 900, frames, type );
+        compressed_int.SetParameters( -100, 900, frames, type );
+
+        if( !compressed.GetCompressedCurve() || !compressed.GetInterpolatedValues().empty() || compressed.GetBakedCount() != baked.GetBakedCount()
+            || compressed.GetCompressedCurve()->GetMaxError() > max_error )
+        {
+            std::cout << type_names[t] << ": compressed curve not in use or above the error bound" << std::endl;
+            mismatches++;
+        }
+
+        while( !baked.HasFinished() )
+        {
+            baked.AdvanceToNext();
+            compressed.AdvanceToNext();
+            baked_int.AdvanceToNext();
+            compressed_int.AdvanceToNext();
+
+            if( std::fabs( compressed.GetCurrentValue() - baked.GetCurrentValue() ) > max_error || compressed_int.GetCurrentValue() != baked_int.GetCurrentValue() )
+            {
+                if( mismatches++ < 8 )
+                {
+                    std::cout << type_names[t] << " frame " << baked.GetInterpolatedCursor() << ": " << compressed.GetCurrentValue() << " / " << baked.GetCurrentValue()
+                              << ", " << compressed_int.GetCurrentValue() << " / " << baked_int.GetCurrentValue() << std::endl;
+                }
+            }
+        }
+
+        if( !compressed.HasFinished() || !compressed_int.HasFinished() )
+        {
+            std::cout << type_names[t] << ": compressed playback length differs" << std::endl;
+            mismatches++;
+        }
+
+        // Random access goes through the bucket table
+        for( size_t i = baked.GetBakedCount(); i-- > 0; )
+        {
+            if( std::fabs( compressed.GetBakedValue( i ) - baked.GetBakedValue( i ) ) > max_error )
+            {
+                if( mismatches++ < 8 )
+                {
+                    std::cout << type_names[t] << " value " << i << ": " << compressed.GetBakedValue( i ) << " / " << baked.GetBakedValue( i ) << std::endl;
+                }
+            }
+        }
+    }
+    return mismatches;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t frames = ( argc > 1 ? std::stoul( argv[1] ) : default_frames );
+    const double max_error = ( argc > 2 ? std::stod( argv[2] ) : default_error );
+
+    const auto mismatches = Validate( frames, max_error );
+
+    std::cout << std::left << std::setw(12) << "type" << std::right << std::setw(10) << "segments" << std::setw(12) << "raw bytes"
+              << std::setw(12) << "bytes" << std::setw(9) << "ratio" << std::setw(12) << "max error"
+              << std::setw(10) << "raw ns" << std::setw(10) << "ns" << std::endl;
+
+    size_t raw_total = 0;
+    size_t compressed_total = 0;
+    double checksum = 0;
+    for( uint8_t t = 0; t < type_count; ++t )
+    {
+        const auto type = static_cast<Motion::Type>( t );
+
+        Motion::MotionCore<double> baked( false ), compressed( false );
+        compressed.SetCompression( max_error );
+        baked.SetParameters( 0, 1000, frames, type );
+        compressed.SetParameters( 0, 1000, frames, type );
+
+        const auto& curve = *compressed.GetCompressedCurve();
+        const auto raw_bytes = baked.GetInterpolatedValues().size() * sizeof(double);
+        raw_total += raw_bytes;
+        compressed_total += curve.GetByteSize();
+
+        const auto raw_ns = PlaybackNanoseconds( baked, checksum );
+        const auto ns = PlaybackNanoseconds( compressed, checksum );
+
+        std::cout << std::left << std::setw(12) << type_names[t] << std::right << std::setw(10) << curve.GetSegmentCount()
+                  << std::setw(12) << raw_bytes << std::setw(12) << curve.GetByteSize()
+                  << std::fixed << std::setprecision(1) << std::setw(8) << double(raw_bytes) / curve.GetByteSize() << "x"
+                  << std::setprecision(4) << std::setw(12) << curve.GetMaxError()
+                  << std::setprecision(2) << std::setw(10) << raw_ns << std::setw(10) << ns << std::endl;
+    }
+
+    std::cout << std::setprecision(1);
+    std::cout << "frames:        " << frames << std::endl;
+    std::cout << "max error:     " << max_error << std::endl;
+    std::cout << "total ratio:   " << double(raw_total) / compressed_total << "x" << std::endl;
+    std::cout << "checksum:      " << checksum << std::endl;
+    std::cout << "mismatches:    " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
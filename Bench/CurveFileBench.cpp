@@ -0,0 +1,238 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include "../Motion.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_frames = 200000;
+    constexpr int loads = 20;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+    constexpr auto text_path = "curve_bench.xls";
+    constexpr auto binary_path = "curve_bench.bin";
+
+    constexpr Motion::SampleFormat formats[] = { Motion::SampleFormat::F64, Motion::SampleFormat::F32, Motion::SampleFormat::I16 };
+    constexpr const char* format_names[] = { "f64", "f32", "i16" };
+}
+
+/** Largest error allowed by a sample format */
+double Tolerance( Motion::SampleFormat format, const Motion::CurveFileHeader& header, double value )
+{
+    switch( format )
+    {
+        case Motion::SampleFormat::F32: return std::fabs( value ) * std::numeric_limits<float>::epsilon();
+        case Motion::SampleFormat::I16: return header.quant_scale * 0.5 + 1e-9;
+        default:                        return 0;
+    }
+}
+
+/** Rewrite a curve file in the version 1 layout, whose segments end before the Bezier points */
+void WriteVersion1( const char* path )
+{
+    std::ifstream file( path, std::ios::binary | std::ios::ate );
+    std::vector<char> bytes( static_cast<size_t>( file.tellg() ) );
+    file.seekg( 0 ).read( bytes.data(), bytes.size() );
+
+    Motion::CurveFileHeader header;
+    std::memcpy( &header, bytes.data(), sizeof(header) );
+    const auto from_size = Motion::GetSegmentSize( header.version );
+    const auto to_size = Motion::GetSegmentSize( 1 );
+    for( uint32_t i = 0; i < header.segment_count; ++i )
+    {
+        std::memmove( bytes.data() + sizeof(header) + i * to_size, bytes.data() + sizeof(header) + i * from_size, to_size );
+    }
+    std::fill( bytes.begin() + sizeof(header) + header.segment_count * to_size, bytes.begin() + header.sample_offset, 0 );
+
+    header.version = 1;
+    std::memcpy( bytes.data(), &header, sizeof(header) );
+    std::ofstream( path, std::ios::binary | std::ios::trunc ).write( bytes.data(), bytes.size() );
+}
+
+/** Mapped playback must give the baked values back, exactly for f64 */
+size_t Validate( uint32_t frames )
+{
+    size_t mismatches = 0;
+    for( uint8_t t = 0; t < type_count; ++t )
+    {
+        Motion::MotionCore<double> baked( false );
+        baked.SetParameters( -20 + t, 500 + 30*t, frames / 100 + t, static_cast<Motion::Type>( t ) );
+
+        for( size_t f = 0; f < 3; ++f )
+        {
+            Motion::MotionCore<double> mapped;
+            if( !baked.SaveCurveFile( binary_path, formats[f] ) || !mapped.LoadCurveFile( binary_path ) )
+            {
+                std::cout << "could not write or map " << format_names[f] << std::endl;
+                mismatches++;
+                continue;
+            }
+
+            const auto& header = mapped.GetMappedCurve()->GetHeader();
+            mismatches += ( mapped.GetBakedCount() != baked.GetBakedCount() )
+                        + ( mapped.GetFrameDuration() != baked.GetFrameDuration() )
+                        + ( mapped.GetMotionQueue().size() != baked.GetMotionQueue().size() );
+
+            for( size_t i = 0; i < baked.GetBakedCount(); ++i )
+            {
+                baked.AdvanceToNext();
+                mapped.AdvanceToNext();
+                if( std::fabs( mapped.GetCurrentValue() - baked.GetCurrentValue() ) > Tolerance( formats[f], header, baked.GetCurrentValue() ) )
+                {
+                    mismatches++;
+                }
+            }
+            mismatches += ( mapped.HasFinished() != baked.HasFinished() );
+
+            // Seeking moves the cursor over the mapped samples
+            baked.Seek( baked.GetFrameDuration() / 3 );
+            mapped.Seek( mapped.GetFrameDuration() / 3 );
+            if( std::fabs( mapped.GetCurrentValue() - baked.GetCurrentValue() ) > Tolerance( formats[f], header, baked.GetCurrentValue() ) )
+            {
+                mismatches++;
+            }
+            baked.Reset();
+        }
+    }
+
+    // Integral motion played from a file it wrote
+    Motion::MotionCore<int> baked( false ), mapped;
+    baked.SetParameters( 10, 900, 300, Motion::Type::BOUNCE );
+    baked.SaveCurveFile( binary_path );
+    mapped.LoadCurveFile( binary_path );
+    for( uint32_t f = 0; f < 300; ++f )
+    {
+        baked.AdvanceToNext();
+        mapped.AdvanceToNext();
+        mismatches += ( baked.GetCurrentValue() != mapped.GetCurrentValue() );
+    }
+
+    // Files that are not curves, or cut short, are rejected
+    std::ofstream( text_path ) << "0.5\n1.0\n";
+    const auto size = std::ifstream( binary_path, std::ios::binary | std::ios::ate ).tellg();
+    std::vector<char> bytes( static_cast<size_t>( size ) );
+    std::ifstream( binary_path, std::ios::binary ).read( bytes.data(), size );
+    std::ofstream( binary_path, std::ios::binary | std::ios::trunc ).write( bytes.data(), bytes.size() - 1 );
+
+    mismatches += ( Motion::MappedCurve::Open( text_path ) != nullptr )
+                + ( Motion::MappedCurve::Open( binary_path ) != nullptr )
+                + ( Motion::MappedCurve::Open( "missing_curve_bench.bin" ) != nullptr )
+                + mapped.LoadCurveFile( text_path );
+
+    // Version 1 files, written before segments held Bezier points, still load with their queue
+    Motion::MotionCore<double> current( false ), legacy;
+    current.SetParameters( -40, 700, 240, {
+        { Motion::Type::BOUNCE, Motion::Acceleration::OUT, 0.6, 0.5, 0, 1, 5, 3 },
+        { Motion::Type::EXPONENTIAL, Motion::Acceleration::IN, 0.4, 0.5, 0.2, 1, 6 },
+    } );
+    current.SaveCurveFile( binary_path );
+    WriteVersion1( binary_path );
+    if( !legacy.LoadCurveFile( binary_path ) || legacy.GetMappedCurve()->GetHeader().version != 1 )
+    {
+        std::cout << "could not map a version 1 file" << std::endl;
+        return mismatches + 1;
+    }
+
+    const auto current_queue = current.GetMotionQueue();
+    const auto legacy_queue = legacy.GetMotionQueue();
+    mismatches += ( legacy_queue.size() != current_queue.size() );
+    for( size_t i = 0; i < std::min( legacy_queue.size(), current_queue.size() ); ++i )
+    {
+        const auto& a = legacy_queue[i];
+        const auto& b = current_queue[i];
+        mismatches += ( a.motion_type != b.motion_type || a.accel_type != b.accel_type || a.duration != b.duration || a.length != b.length
+                     || a.start_value != b.start_value || a.end_value != b.end_value || a.modifier != b.modifier || a.gravity != b.gravity );
+    }
+    while( !current.HasFinished() )
+    {
+        current.AdvanceToNext();
+        legacy.AdvanceToNext();
+        mismatches += ( legacy.GetCurrentValue() != current.GetCurrentValue() );
+    }
+
+    return mismatches;
+}
+
+/** Parse a text dump, as the plotting tools did */
+double LoadText( std::vector<double>& values )
+{
+    const auto begin = Clock::now();
+    for( int l = 0; l < loads; ++l )
+    {
+        values.clear();
+        std::ifstream file( text_path );
+        double value;
+        while( file >> value )
+        {
+            values.emplace_back( value );
+        }
+    }
+    return std::chrono::duration<double, std::micro>( Clock::now() - begin ).count() / loads;
+}
+
+/** Map a curve file into a motion, ready to play */
+double LoadMapped( Motion::MotionCore<double>& motion )
+{
+    const auto begin = Clock::now();
+    for( int l = 0; l < loads; ++l )
+    {
+        motion.LoadCurveFile( binary_path );
+    }
+    return std::chrono::duration<double, std::micro>( Clock::now() - begin ).count() / loads;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t frames = ( argc > 1 ? std::stoul( argv[1] ) : default_frames );
+
+    const auto mismatches = Validate( frames );
+
+    Motion::MotionCore<double> baked( false );
+    baked.SetParameters( 0, 1000, frames, Motion::Type::ELASTIC );
+
+    const auto dump_begin = Clock::now();
+    baked.DumpToFile( text_path );
+    const auto dump_ms = std::chrono::duration<double, std::milli>( Clock::now() - dump_begin ).count();
+
+    const auto save_begin = Clock::now();
+    baked.SaveCurveFile( binary_path );
+    const auto save_ms = std::chrono::duration<double, std::milli>( Clock::now() - save_begin ).count();
+
+    std::vector<double> parsed;
+    Motion::MotionCore<double> mapped;
+    const auto text_us = LoadText( parsed );
+    const auto mapped_us = LoadMapped( mapped );
+
+    // Play the whole mapped curve once so the pages are actually read
+    double checksum = 0;
+    const auto play_begin = Clock::now();
+    while( !mapped.HasFinished() )
+    {
+        mapped.AdvanceToNext();
+        checksum += mapped.GetCurrentValue();
+    }
+    const auto play_ms = std::chrono::duration<double, std::milli>( Clock::now() - play_begin ).count();
+
+    std::remove( text_path );
+    std::remove( binary_path );
+
+    std::cout << "frames:        " << frames << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "text dump:     " << dump_ms << " ms" << std::endl;
+    std::cout << "binary write:  " << save_ms << " ms" << std::endl;
+    std::cout << "text parse:    " << text_us << " us" << std::endl;
+    std::cout << "mmap load:     " << mapped_us << " us" << std::endl;
+    std::cout << "load speedup:  " << text_us / mapped_us << "x" << std::endl;
+    std::cout << "mapped play:   " << play_ms * 1e6 / frames << " ns/frame (checksum " << checksum << ")" << std::endl;
+    std::cout << "mismatches:    " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
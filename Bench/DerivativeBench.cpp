@@ -0,0 +1,336 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "../Motion.h"
+#include "../EasingBatch.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr size_t default_samples = 100003;
+    constexpr uint32_t repeats = 10;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+
+    const char* type_names[] =
+    {
+        "LINEAR", "POW", "QUAD", "CUBIC", "BACK", "CIRCULAR", "ELASTIC", "BOUNCE", "SINE", "EXPONENTIAL"
+    };
+
+    const char* path_names[] = { "SCALAR", "SSE2", "AVX2", "AVX512" };
+
+    /** Modifier/gravity pairs checked for every type */
+    const std::pair<double, double> modifiers[] = { {4, 2}, {2.5, 6}, {7, 0.5} };
+
+    /** Modifier/gravity pairs the batch kernels are checked over, from a fraction of a wobble to twenty */
+    const std::pair<double, double> modifier_range[] =
+    {
+        {0.5, 0.5}, {1, 6}, {2, 2}, {2.5, 6}, {4, 2}, {5, 1}, {7, 0.5}, {10, 4}, {14, 3}, {20, 6}
+    };
+
+    /** Easing windows checked against finite differences */
+    const std::pair<double, double> windows[] = { {0, 1}, {0.2, 0.7}, {0.35, 1} };
+
+    /** Finite difference steps and their relative tolerances */
+    constexpr double first_step = 1e-5;
+    constexpr double second_step = 1e-4;
+    constexpr double first_tolerance = 1e-6;
+    constexpr double second_tolerance = 1e-3;
+}
+
+/** Error in units of the last place of max(|peak|, 1), peak being the largest magnitude of the reference over the curve
+ *  ( an absolute error near the zero crossings, where the terms of a derivative cancel ) */
+double UlpError( double value, double reference, double peak )
+{
+    if( std::isnan( value ) && std::isnan( reference ) )
+    {
+        return 0;
+    }
+    const auto scale = std::max( peak, 1.0 ) * std::numeric_limits<double>::epsilon();
+    return std::fabs( value - reference ) / scale;
+}
+
+/** Largest magnitude of some values */
+double Peak( const std::vector<double>& values )
+{
+    double peak = 0;
+    for( const auto v : values )
+    {
+        peak = std::max( peak, std::fabs( v ) );
+    }
+    return peak;
+}
+
+/** Error relative to max(|reference|, 1) */
+double RelativeError( double value, double reference )
+{
+    return std::fabs( value - reference ) / std::max( std::fabs( reference ), 1.0 );
+}
+
+/** Analytic easing derivatives must match central differences of the easing values, windows included */
+size_t ValidateEasing()
+{
+    size_t mismatches = 0;
+    for( uint8_t t = 0; t < type_count; ++t )
+    {
+        const auto type = static_cast<Motion::Type>( t );
+        for( auto accel : { Motion::Acceleration::IN, Motion::Acceleration::OUT } )
+        {
+            for( const auto& w : windows )
+            {
+                for( const auto& m : modifiers )
+                {
+                    const auto value = [&]( double x )
+                    {
+                        return Motion::EasingFunctions::GetFunctionValue( x, w.first, w.second, type, accel, m.first, m.second );
+                    };
+
+                    const auto unfolded = [&]( double x )
+                    {
+                        const auto mapped = x*(w.second - w.first) + w.first;
+                        return Motion::EasingFunction::Elastic( accel == Motion::Acceleration::OUT ? 1 - mapped : mapped, m.first, m.second );
+                    };
+
+                    for( double x = 0.05; x < 0.95; x += 0.01 )
+                    {
+                        const auto d = Motion::EasingFunctions::GetFunctionDerivatives( x, w.first, w.second, type, accel, m.first, m.second );
+
+                        // Bounce folds at its zeros, where it has no derivative
+                        if( type == Motion::Type::BOUNCE && std::signbit( unfolded( x - second_step ) ) != std::signbit( unfolded( x + second_step ) ) )
+                        {
+                            continue;
+                        }
+
+                        const auto first = ( value( x + first_step ) - value( x - first_step ) ) / ( 2 * first_step );
+                        const auto second = ( value( x + second_step ) - 2 * value( x ) + value( x - second_step ) ) / ( second_step * second_step );
+
+                        if( d.value != value( x ) || RelativeError( d.first, first ) > first_tolerance || RelativeError( d.second, second ) > second_tolerance )
+                        {
+                            if( mismatches++ < 8 )
+                            {
+                                std::cout << type_names[t] << ( accel == Motion::Acceleration::IN ? " IN" : " OUT" ) << " window " << w.first << "-" << w.second
+                                          << " at " << x << ": " << d.first << " / " << first << ", " << d.second << " / " << second << std::endl;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return mismatches;
+}
+
+/** Queue with uneven lengths, and partial windows unless the values are integral */
+template<typename ValueType>
+Motion::MotionQueue<ValueType> MakeQueue( Motion::Type type, bool windowed = std::is_floating_point<ValueType>::value )
+{
+    return {
+        { type, Motion::Acceleration::OUT, 0.3, 0.25, ValueType( windowed ? 0.1 : 0 ), ValueType( windowed ? 0.8 : 1 ), 4, 2 },
+        { Motion::Type::SINE, Motion::Acceleration::IN, 0.5, 0.5, 0, 1, 4, 2 },
+        { type, Motion::Acceleration::IN, 0.2, 0.25, ValueType( windowed ? 0.3 : 0 ), 1, 3, 5 },
+    };
+}
+
+/** Core velocity and acceleration must match central differences of the played values, in every mode */
+size_t ValidateCore()
+{
+    size_t mismatches = 0;
+    const auto expect = [&]( const std::string& what, double value, double expected, double tolerance )
+    {
+        if( RelativeError( value, expected ) > tolerance )
+        {
+            if( mismatches++ < 8 )
+            {
+                std::cout << what << ": " << value << ", expected " << expected << std::endl;
+            }
+        }
+    };
+
+    for( uint8_t t = 0; t < type_count; ++t )
+    {
+        const auto type = static_cast<Motion::Type>( t );
+        const auto name = std::string( type_names[t] );
+
+        Motion::MotionCore<double> runtime, baked( false ), unwindowed;
+        Motion::MotionCore<int, Motion::DynamicEasing, Motion::FixedPointMath<>> fixed;
+        Motion::MotionVectorCore<double, 2> vector;
+        runtime.SetParameters( -50, 400, 180, MakeQueue<double>( type ) );
+        baked.SetParameters( -50, 400, 180, MakeQueue<double>( type ) );
+        unwindowed.SetParameters( -50, 400, 180, MakeQueue<double>( type, false ) );
+        fixed.SetParameters( -50, 400, 180, MakeQueue<int>( type ) );
+        vector.SetParameters( { -50, 400 }, { 400, -50 }, 180, MakeQueue<double>( type ) );
+
+        auto previous = runtime;
+        Motion::TimeType frame = 0;
+        while( !runtime.HasFinished() )
+        {
+            const auto velocity = runtime.GetCurrentVelocity();
+            const auto acceleration = runtime.GetCurrentAcceleration();
+            const auto at = runtime.DerivativesAt( frame );
+            const auto label = name + " frame " + std::to_string( frame );
+
+            expect( label + " seek velocity", at.first, velocity, 1e-12 );
+            expect( label + " baked velocity", baked.GetCurrentVelocity(), velocity, 1e-12 );
+            expect( label + " baked acceleration", baked.GetCurrentAcceleration(), acceleration, 1e-12 );
+            expect( label + " fixed point velocity", fixed.GetCurrentVelocity(), unwindowed.GetCurrentVelocity(), 1e-4 );
+            expect( label + " vector velocity", vector.GetCurrentVelocity()[0], velocity, 1e-12 );
+            expect( label + " vector mirrored velocity", -vector.GetCurrentVelocity()[1], velocity, 1e-12 );
+
+            // Central differences within the segment, frames next to a boundary are skipped
+            if( frame > 0 )
+            {
+                auto ahead = runtime, behind = previous;
+                ahead.AdvanceBy( second_step );
+                behind.AdvanceBy( 1 - second_step );
+                const auto segment = runtime.GetSegmentIndex();
+                if( ahead.GetSegmentIndex() == segment && behind.GetSegmentIndex() == segment && previous.GetSegmentIndex() == segment )
+                {
+                    const auto value = at.value;
+                    const auto next = ahead.GetCurrentValue();
+                    const auto last = behind.GetCurrentValue();
+                    const auto scale = std::max( std::fabs( next - last ) / second_step, 1.0 );
+                    expect( label + " velocity", velocity, ( next - last ) / ( 2 * second_step ), first_tolerance * scale );
+                    expect( label + " acceleration", acceleration, ( next - 2 * value + last ) / ( second_step * second_step ), second_tolerance * scale );
+                }
+            }
+
+            previous = runtime;
+            runtime.AdvanceToNext();
+            baked.AdvanceToNext();
+            unwindowed.AdvanceToNext();
+            fixed.AdvanceToNext();
+            vector.AdvanceToNext();
+            frame++;
+        }
+
+        expect( name + " finished velocity", runtime.GetCurrentVelocity(), 0, 0 );
+        expect( name + " finished acceleration", runtime.GetCurrentAcceleration(), 0, 0 );
+    }
+    return mismatches;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const size_t samples = ( argc > 1 ? std::stoul( argv[1] ) : default_samples );
+
+    const auto easing_mismatches = ValidateEasing();
+    const auto core_mismatches = ValidateCore();
+
+    std::vector<double> progress( samples ), first( samples ), second( samples ), batch_first( samples ), batch_second( samples );
+    for( size_t i = 0; i < samples; ++i )
+    {
+        progress[i] = static_cast<double>( i + 1 ) / ( samples + 1 );
+    }
+
+    std::cout << "selected path: " << path_names[static_cast<int>( Motion::GetBatchPath() )]
+              << ( Motion::BatchSimdCompiled ? "" : " ( SIMD paths need GCC on x86 )" ) << std::endl;
+    std::cout << "ULP bound:     " << Motion::BatchDerivativeMaxUlp << std::endl;
+    std::cout << std::left << std::setw(12) << "type" << std::setw(5) << "acc" << std::setw(8) << "path"
+              << std::right << std::setw(12) << "max ulp" << std::setw(14) << "scalar ns" << std::setw(12) << "batch ns"
+              << std::setw(10) << "speedup" << std::endl;
+
+    bool failed = false;
+    for( uint8_t t = 0; t < type_count; ++t )
+    {
+        for( auto accel : { Motion::Acceleration::IN, Motion::Acceleration::OUT } )
+        {
+            const auto type = static_cast<Motion::Type>( t );
+
+            // Reference timing over the scalar derivatives
+            double scalar_ns = 0;
+            for( const auto& m : modifiers )
+            {
+                const auto begin = Clock::now();
+                for( uint32_t r = 0; r < repeats; ++r )
+                {
+                    for( size_t i = 0; i < samples; ++i )
+                    {
+                        const auto d = Motion::EasingFunctions::GetFunctionDerivatives( progress[i], 0.0, 1.0, type, accel, m.first, m.second );
+                        first[i] = d.first;
+                        second[i] = d.second;
+                    }
+                }
+                scalar_ns += std::chrono::duration<double, std::nano>( Clock::now() - begin ).count();
+            }
+            scalar_ns /= double(samples) * repeats * std::size( modifiers );
+
+            // Timing over the usual modifiers
+            double batch_ns[std::size( path_names )] {};
+            double max_ulp[std::size( path_names )] {};
+            for( int p = 0; p <= static_cast<int>( Motion::BatchPath::AVX512 ); ++p )
+            {
+                const auto path = static_cast<Motion::BatchPath>( p );
+                if( !Motion::IsBatchPathSupported( path ) )
+                {
+                    continue;
+                }
+
+                for( const auto& m : modifiers )
+                {
+                    const auto begin = Clock::now();
+                    for( uint32_t r = 0; r < repeats; ++r )
+                    {
+                        Motion::EvaluateBatchDerivatives( path, type, accel, progress.data(), batch_first.data(), batch_second.data(), samples, m.first, m.second );
+                    }
+                    batch_ns[p] += std::chrono::duration<double, std::nano>( Clock::now() - begin ).count();
+                }
+                batch_ns[p] /= double(samples) * repeats * std::size( modifiers );
+            }
+
+            // Accuracy over the whole modifier range
+            for( const auto& m : modifier_range )
+            {
+                for( size_t i = 0; i < samples; ++i )
+                {
+                    const auto d = Motion::EasingFunctions::GetFunctionDerivatives( progress[i], 0.0, 1.0, type, accel, m.first, m.second );
+                    first[i] = d.first;
+                    second[i] = d.second;
+                }
+                const auto first_peak = Peak( first );
+                const auto second_peak = Peak( second );
+
+                for( int p = 0; p <= static_cast<int>( Motion::BatchPath::AVX512 ); ++p )
+                {
+                    const auto path = static_cast<Motion::BatchPath>( p );
+                    if( !Motion::IsBatchPathSupported( path ) )
+                    {
+                        continue;
+                    }
+
+                    Motion::EvaluateBatchDerivatives( path, type, accel, progress.data(), batch_first.data(), batch_second.data(), samples, m.first, m.second );
+                    for( size_t i = 0; i < samples; ++i )
+                    {
+                        max_ulp[p] = std::max( { max_ulp[p], UlpError( batch_first[i], first[i], first_peak ), UlpError( batch_second[i], second[i], second_peak ) } );
+                    }
+                }
+            }
+
+            for( int p = 0; p <= static_cast<int>( Motion::BatchPath::AVX512 ); ++p )
+            {
+                if( !Motion::IsBatchPathSupported( static_cast<Motion::BatchPath>( p ) ) )
+                {
+                    continue;
+                }
+
+                failed |= !( max_ulp[p] <= Motion::BatchDerivativeMaxUlp );
+
+                std::cout << std::left << std::setw(12) << type_names[t] << std::setw(5) << ( accel == Motion::Acceleration::IN ? "IN" : "OUT" )
+                          << std::setw(8) << path_names[p] << std::right << std::fixed
+                          << std::setw(12) << std::setprecision(2) << max_ulp[p]
+                          << std::setw(14) << std::setprecision(3) << scalar_ns
+                          << std::setw(12) << batch_ns[p]
+                          << std::setw(9) << std::setprecision(1) << scalar_ns / batch_ns[p] << "x" << std::endl;
+            }
+        }
+    }
+
+    std::cout << "easing mismatches: " << easing_mismatches << std::endl;
+    std::cout << "core mismatches:   " << core_mismatches << std::endl;
+    std::cout << ( failed ? "FAILED: error above ULP bound" : "all paths within ULP bound" ) << std::endl;
+
+    return ( failed || easing_mismatches || core_mismatches ) ? 1 : 0;
+}
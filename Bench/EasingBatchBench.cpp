@@ -0,0 +1,124 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "../EasingBatch.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr size_t default_samples = 100003;
+    constexpr uint32_t repeats = 20;
+
+    const char* type_names[] =
+    {
+        "LINEAR", "POW", "QUAD", "CUBIC", "BACK", "CIRCULAR", "ELASTIC", "BOUNCE", "SINE", "EXPONENTIAL"
+    };
+
+    const char* path_names[] = { "SCALAR", "SSE2", "AVX2", "AVX512" };
+
+    /** Modifier/gravity pairs checked for every type */
+    const std::pair<double, double> modifiers[] = { {4, 2}, {2.5, 6}, {7, 0.5} };
+}
+
+/** Error in units of the last place of max(|reference|, 1) */
+double UlpError( double value, double reference )
+{
+    if( std::isnan( value ) && std::isnan( reference ) )
+    {
+        return 0;
+    }
+    const auto scale = std::max( std::fabs( reference ), 1.0 ) * std::numeric_limits<double>::epsilon();
+    return std::fabs( value - reference ) / scale;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const size_t samples = ( argc > 1 ? std::stoul( argv[1] ) : default_samples );
+
+    std::vector<double> progress( samples ), reference( samples ), batch( samples );
+    for( size_t i = 0; i < samples; ++i )
+    {
+        progress[i] = static_cast<double>( i + 1 ) / ( samples + 1 );
+    }
+
+    std::cout << "selected path: " << path_names[static_cast<int>( Motion::GetBatchPath() )]
+              << ( Motion::BatchSimdCompiled ? "" : " ( SIMD paths need GCC on x86 )" ) << std::endl;
+    std::cout << "ULP bound:     " << Motion::BatchMaxUlp << std::endl;
+    std::cout << std::left << std::setw(12) << "type" << std::setw(5) << "acc" << std::setw(8) << "path"
+              << std::right << std::setw(12) << "max ulp" << std::setw(14) << "scalar ns" << std::setw(12) << "batch ns"
+              << std::setw(10) << "speedup" << std::endl;
+
+    bool failed = false;
+    for( int t = 0; t <= static_cast<int>( Motion::Type::EXPONENTIAL ); ++t )
+    {
+        for( auto accel : { Motion::Acceleration::IN, Motion::Acceleration::OUT } )
+        {
+            const auto type = static_cast<Motion::Type>( t );
+
+            // Reference timing over the scalar easing path
+            double scalar_ns = 0;
+            for( const auto& m : modifiers )
+            {
+                const auto begin = Clock::now();
+                for( uint32_t r = 0; r < repeats; ++r )
+                {
+                    for( size_t i = 0; i < samples; ++i )
+                    {
+                        reference[i] = Motion::EasingFunctions::GetFunctionValue( progress[i], 0.0, 1.0, type, accel, m.first, m.second );
+                    }
+                }
+                scalar_ns += std::chrono::duration<double, std::nano>( Clock::now() - begin ).count();
+            }
+            scalar_ns /= double(samples) * repeats * std::size( modifiers );
+
+            for( int p = 0; p <= static_cast<int>( Motion::BatchPath::AVX512 ); ++p )
+            {
+                const auto path = static_cast<Motion::BatchPath>( p );
+                if( !Motion::IsBatchPathSupported( path ) )
+                {
+                    continue;
+                }
+
+                double max_ulp = 0;
+                double batch_ns = 0;
+                for( const auto& m : modifiers )
+                {
+                    for( size_t i = 0; i < samples; ++i )
+                    {
+                        reference[i] = Motion::EasingFunctions::GetFunctionValue( progress[i], 0.0, 1.0, type, accel, m.first, m.second );
+                    }
+
+                    const auto begin = Clock::now();
+                    for( uint32_t r = 0; r < repeats; ++r )
+                    {
+                        Motion::EvaluateBatch( path, type, accel, progress.data(), batch.data(), samples, m.first, m.second );
+                    }
+                    batch_ns += std::chrono::duration<double, std::nano>( Clock::now() - begin ).count();
+
+                    for( size_t i = 0; i < samples; ++i )
+                    {
+                        max_ulp = std::max( max_ulp, UlpError( batch[i], reference[i] ) );
+                    }
+                }
+                batch_ns /= double(samples) * repeats * std::size( modifiers );
+
+                failed |= !( max_ulp <= Motion::BatchMaxUlp );
+
+                std::cout << std::left << std::setw(12) << type_names[t] << std::setw(5) << ( accel == Motion::Acceleration::IN ? "IN" : "OUT" )
+                          << std::setw(8) << path_names[p] << std::right << std::fixed
+                          << std::setw(12) << std::setprecision(2) << max_ulp
+                          << std::setw(14) << std::setprecision(3) << scalar_ns
+                          << std::setw(12) << batch_ns
+                          << std::setw(9) << std::setprecision(1) << scalar_ns / batch_ns << "x" << std::endl;
+            }
+        }
+    }
+
+    std::cout << ( failed ? "FAILED: error above ULP bound" : "all paths within ULP bound" ) << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <utility>
+
+#include "../MotionCore.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr size_t samples = 1000000;
+    constexpr uint32_t default_cores = 10000;
+    constexpr uint32_t frames = 600;
+
+    /** Type-erased call, as every sample used to go through */
+    const Motion::Easing type_erased_sine = Motion::EasingFunction::Sine;
+
+    volatile double sink;
+
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::BEZIER) + 1;
+}
+
+template<typename Function>
+double TimeSamples( const std::vector<double>& progress, Function function )
+{
+    double sum = 0;
+    const auto begin = Clock::now();
+    for( const auto x : progress )
+    {
+        sum += function( x );
+    }
+    const auto end = Clock::now();
+    sink = sum;
+    return std::chrono::duration<double, std::nano>( end - begin ).count() / progress.size();
+}
+
+template<typename Core>
+double TimeCores( uint32_t count, double& checksum )
+{
+    std::vector<Core> cores( count );
+    for( uint32_t i = 0; i < count; ++i )
+    {
+        cores[i].SetParameters( 0.0, 100.0 + i % 500, frames/2 + i % (frames/2), Motion::Type::SINE );
+    }
+
+    const auto begin = Clock::now();
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        for( auto& core : cores )
+        {
+            core.AdvanceToNext();
+        }
+    }
+    const auto end = Clock::now();
+
+    checksum = 0;
+    for( auto& core : cores )
+    {
+        checksum += core.GetCurrentValue();
+    }
+
+    return std::chrono::duration<double, std::nano>( end - begin ).count() / (double(count) * frames);
+}
+
+/** Count the frames where StaticEasing<type> plays differently from DynamicEasing, at runtime and baked */
+template<Motion::Type type>
+size_t ValidateType()
+{
+    Motion::MotionQueue<double> queue;
+    queue.push_back( { type, Motion::Acceleration::OUT, 0.6, 0.5, 0, 1, 3, 1.5, { 0.68, -0.55, 0.27, 1.55 } } );
+    queue.push_back( { type, Motion::Acceleration::IN, 0.4, 0.5, 0.2, 0.9, 5, 2.5, { 0.25, 0.1, 0.25, 1 } } );
+
+    size_t mismatches = 0;
+    for( const bool runtime : { true, false } )
+    {
+        Motion::MotionCore<double> dynamic( runtime );
+        Motion::MotionCore<double, Motion::StaticEasing<type>> fixed( runtime );
+        dynamic.SetParameters( -50, 250, frames/2, queue );
+        fixed.SetParameters( -50, 250, frames/2, queue );
+
+        for( uint32_t f = 0; f <= frames/2; ++f )
+        {
+            if( dynamic.GetCurrentValue() != fixed.GetCurrentValue() || dynamic.HasFinished() != fixed.HasFinished() )
+            {
+                mismatches++;
+            }
+            dynamic.AdvanceToNext();
+            fixed.AdvanceToNext();
+        }
+    }
+    return mismatches;
+}
+
+/** Count per-frame differences for every easing type */
+template<size_t... types>
+size_t ValidateTypes( std::index_sequence<types...> )
+{
+    return ( ValidateType<static_cast<Motion::Type>( types )>() + ... );
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t cores = ( argc > 1 ? std::stoul( argv[1] ) : default_cores );
+
+    std::vector<double> progress( samples );
+    for( size_t i = 0; i < samples; ++i )
+    {
+        progress[i] = static_cast<double>( i + 1 ) / ( samples + 1 );
+    }
+
+    using Motion::Type;
+    using Motion::Acceleration;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "SINE OUT per sample:" << std::endl;
+    std::cout << "  std::function:            " << TimeSamples( progress, []( double x ) { return 1-type_erased_sine( 1-x, 4, 2 ); } ) << " ns" << std::endl;
+    std::cout << "  GetFunctionValue(enum):   " << TimeSamples( progress, []( double x ) { return Motion::EasingFunctions::GetFunctionValue( x, 0, 1, Type::SINE, Acceleration::OUT, 4, 2 ); } ) << " ns" << std::endl;
+    std::cout << "  Ease<SINE, OUT>:          " << TimeSamples( progress, []( double x ) { return Motion::Ease<Type::SINE, Acceleration::OUT>( x, 4, 2 ); } ) << " ns" << std::endl;
+    std::cout << "QUAD IN per sample:" << std::endl;
+    std::cout << "  GetFunctionValue(enum):   " << TimeSamples( progress, []( double x ) { return Motion::EasingFunctions::GetFunctionValue( x, 0, 1, Type::QUAD, Acceleration::IN, 4, 2 ); } ) << " ns" << std::endl;
+    std::cout << "  Ease<QUAD, IN>:           " << TimeSamples( progress, []( double x ) { return Motion::Ease<Type::QUAD, Acceleration::IN>( x, 4, 2 ); } ) << " ns" << std::endl;
+
+    double dynamic_sum, static_sum;
+    const auto dynamic_ns = TimeCores<Motion::MotionCore<double>>( cores, dynamic_sum );
+    const auto static_ns = TimeCores<Motion::MotionCore<double, Motion::StaticEasing<Type::SINE>>>( cores, static_sum );
+
+    std::cout << "MotionCore SINE step ( " << cores << " cores x " << frames << " frames ):" << std::endl;
+    std::cout << "  DynamicEasing:            " << dynamic_ns << " ns" << std::endl;
+    std::cout << "  StaticEasing<SINE>:       " << static_ns << " ns" << std::endl;
+    std::cout << "  speedup:                  " << dynamic_ns / static_ns << "x" << std::endl;
+
+    // Every easing type must play the same frames through either policy, not only SINE at the end
+    const auto mismatches = ValidateTypes( std::make_index_sequence<type_count>() ) + ( dynamic_sum != static_sum );
+    std::cout << "mismatches:                 " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
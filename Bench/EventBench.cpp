@@ -0,0 +1,350 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <thread>
+
+#include "../Timeline.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_channels = 50000;
+    constexpr uint32_t default_frames = 600;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+
+    /** Channels of the correctness checks */
+    constexpr uint32_t checked = 2000;
+
+    /** Values pushed through the queue by the stress check */
+    constexpr uint32_t stress_values = 1000000;
+
+    /** Queue capacity of the threaded checks, small enough to wrap around many times */
+    constexpr size_t queue_capacity = 1024;
+}
+
+/** Fill a system with channels of one to three segments and varied durations */
+std::vector<Motion::ChannelHandle> Populate( Motion::MotionSystem<double>& system, uint32_t channels, uint32_t frames )
+{
+    std::vector<Motion::ChannelHandle> handles;
+    handles.reserve( channels );
+    system.Reserve( channels, 3 );
+    for( uint32_t i = 0; i < channels; ++i )
+    {
+        const auto type = static_cast<Motion::Type>( i % type_count );
+        Motion::MotionQueue<double> queue;
+        for( uint32_t s = 0; s <= i % 3; ++s )
+        {
+            queue.push_back( {type, Motion::Acceleration::IN, 1.0 / (i % 3 + 1), 1.0 / (i % 3 + 1), 0, 1, 4, 2} );
+        }
+        handles.emplace_back( system.Add( i % 100, 500.0 + i % 700, frames / 4 + i % (frames / 2), queue ) );
+    }
+    return handles;
+}
+
+/** Every channel must report each segment start and its completion exactly once, on the frame polling sees it */
+size_t ValidateEvents( uint32_t frames )
+{
+    size_t mismatches = 0;
+
+    Motion::MotionSystem<double> system;
+    Motion::MotionSystem<double> parallel;
+    Motion::ThreadPool pool( 4 );
+    const auto handles = Populate( system, checked, frames );
+    Populate( parallel, checked, frames );
+
+    std::vector<uint32_t> next_segment( checked, 1 );
+    std::vector<uint8_t> was_finished( checked, 0 );
+    for( uint32_t frame = 0; frame < frames; ++frame )
+    {
+        system.Update();
+        parallel.Update( pool, 64 );
+
+        // The parallel update records the same events in the same order
+        const auto& events = system.GetEvents();
+        const auto& parallel_events = parallel.GetEvents();
+        bool same = events.size() == parallel_events.size();
+        for( size_t e = 0; same && e < events.size(); ++e )
+        {
+            same = events[e].handle.index == parallel_events[e].handle.index
+                && events[e].handle.generation == parallel_events[e].handle.generation
+                && events[e].segment == parallel_events[e].segment
+                && events[e].type == parallel_events[e].type;
+        }
+        if( !same )
+        {
+            std::cout << "frame " << frame << ": parallel events differ" << std::endl;
+            mismatches++;
+        }
+
+        std::vector<uint8_t> reported( checked, 0 );
+        for( const auto& event : events )
+        {
+            const auto i = event.handle.index;
+            if( event.type == Motion::MotionEventType::SEGMENT )
+            {
+                mismatches += ( event.segment != next_segment[i]++ );
+            }
+            else
+            {
+                mismatches += ( event.segment != next_segment[i] || reported[i]++ );
+            }
+        }
+
+        for( uint32_t i = 0; i < checked; ++i )
+        {
+            const uint8_t finished = system.HasFinished( handles[i] );
+            if( ( finished && !was_finished[i] ) != static_cast<bool>( reported[i] ) )
+            {
+                if( mismatches++ < 8 )
+                {
+                    std::cout << "channel " << i << " frame " << frame << ": finished " << +finished << ", reported " << +reported[i] << std::endl;
+                }
+            }
+            was_finished[i] = finished;
+        }
+    }
+
+    for( uint32_t i = 0; i < checked; ++i )
+    {
+        if( !was_finished[i] || next_segment[i] != i % 3 + 1 )
+        {
+            if( mismatches++ < 8 )
+            {
+                std::cout << "channel " << i << ": " << next_segment[i] - 1 << " segment events of " << i % 3 << std::endl;
+            }
+        }
+    }
+
+    return mismatches;
+}
+
+/** Values pushed from one thread must come out of another complete and in order */
+size_t ValidateQueue()
+{
+    Motion::SpscQueue<uint32_t> queue( queue_capacity );
+
+    std::thread producer( [&queue]()
+    {
+        uint32_t batch[37];
+        for( uint32_t next = 0; next < stress_values; )
+        {
+            uint32_t count = 0;
+            for( ; count < 37 && next + count < stress_values; ++count )
+            {
+                batch[count] = next + count;
+            }
+
+            uint32_t pushed = 0;
+            while( pushed < count )
+            {
+                const auto n = queue.Push( batch + pushed, count - pushed );
+                if( n == 0 )
+                {
+                    std::this_thread::yield();
+                }
+                pushed += n;
+            }
+            next += count;
+        }
+    } );
+
+    size_t mismatches = 0;
+    uint32_t expected = 0;
+    uint32_t batch[53];
+    while( expected < stress_values )
+    {
+        const auto count = queue.Pop( batch, 53 );
+        if( count == 0 )
+        {
+            std::this_thread::yield();
+        }
+        for( size_t i = 0; i < count; ++i )
+        {
+            mismatches += ( batch[i] != expected++ );
+        }
+    }
+    producer.join();
+
+    if( mismatches > 0 || queue.GetSize() != 0 )
+    {
+        std::cout << "queue: " << mismatches << " values out of order" << std::endl;
+        mismatches++;
+    }
+    return mismatches;
+}
+
+/** Events handed to a consumer thread must arrive in update order, only the ones reported as dropped may be missing */
+size_t ValidateConsumer( uint32_t frames )
+{
+    Motion::MotionSystem<double> system;
+    Motion::MotionEventQueue queue( queue_capacity );
+    Populate( system, checked * 4, frames );
+    system.SetEventQueue( &queue );
+
+    std::vector<Motion::MotionEvent> emitted;
+    std::vector<Motion::MotionEvent> received;
+    std::atomic<bool> done { false };
+
+    std::thread consumer( [&]()
+    {
+        Motion::MotionEvent batch[64];
+        for( ;; )
+        {
+            const auto finished = done.load( std::memory_order_acquire );
+            const auto count = queue.Pop( batch, 64 );
+            received.insert( received.end(), batch, batch + count );
+            if( count == 0 && finished )
+            {
+                break;
+            }
+            if( count == 0 )
+            {
+                std::this_thread::yield();
+            }
+        }
+    } );
+
+    for( uint32_t frame = 0; frame < frames; ++frame )
+    {
+        system.Update();
+        emitted.insert( emitted.end(), system.GetEvents().begin(), system.GetEvents().end() );
+    }
+    done.store( true, std::memory_order_release );
+    consumer.join();
+
+    // Received events are the emitted ones with some batch tails missing
+    size_t e = 0;
+    bool ordered = true;
+    for( const auto& event : received )
+    {
+        while( e < emitted.size() && !( emitted[e].handle.index == event.handle.index && emitted[e].type == event.type && emitted[e].segment == event.segment ) )
+        {
+            ++e;
+        }
+        if( e == emitted.size() )
+        {
+            ordered = false;
+            break;
+        }
+        ++e;
+    }
+
+    if( !ordered || received.size() + system.GetDroppedEventCount() != emitted.size() )
+    {
+        std::cout << "consumer: " << received.size() << " received, " << system.GetDroppedEventCount() << " dropped, " << emitted.size() << " emitted" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/** Timeline runs must start and finish once per run, on events alone */
+size_t ValidateTimeline()
+{
+    size_t mismatches = 0;
+
+    auto plan = std::make_shared<Motion::MotionPlan>();
+    plan->Rebuild( Motion::MotionQueue<double>
+        {
+            {Motion::Type::SINE, Motion::Acceleration::OUT, 0.5, 0.5, 0, 1, 4, 2},
+            {Motion::Type::SINE, Motion::Acceleration::IN,  0.5, 0.5, 0, 1, 4, 2},
+        }, 40 );
+
+    Motion::Timeline<double> timeline;
+    std::vector<Motion::TimelineHandle> handles;
+    timeline.Stagger( checked, 1, 0.0, 100.0, plan, { 5, 2, 3 }, handles );
+
+    std::vector<uint32_t> started( checked, 0 );
+    std::vector<uint32_t> segments( checked, 0 );
+    std::vector<uint32_t> finished( checked, 0 );
+    for( uint32_t frame = 0; frame < checked + 200; ++frame )
+    {
+        timeline.Update();
+        for( const auto& event : timeline.GetEvents() )
+        {
+            auto& count = ( event.type == Motion::MotionEventType::STARTED ? started
+                          : event.type == Motion::MotionEventType::SEGMENT ? segments : finished )[event.handle.index];
+            count++;
+        }
+    }
+
+    for( uint32_t i = 0; i < checked; ++i )
+    {
+        if( started[i] != 3 || segments[i] != 3 || finished[i] != 3 || !timeline.HasFinished( handles[i] ) )
+        {
+            if( mismatches++ < 8 )
+            {
+                std::cout << "timeline motion " << i << ": " << started[i] << " started, " << segments[i] << " segments, " << finished[i] << " finished" << std::endl;
+            }
+        }
+    }
+
+    return mismatches;
+}
+
+/** Play channels to the end, timing how long finding the finished ones takes with events and with polling, in ns per frame */
+void BenchFinding( uint32_t channels, uint32_t frames, double& events_ns, double& polling_ns, size_t& events_found, size_t& polling_found )
+{
+    Motion::MotionSystem<double> system;
+    const auto handles = Populate( system, channels, frames );
+    std::vector<uint8_t> was_finished( channels, 0 );
+
+    Clock::duration events_time {};
+    Clock::duration polling_time {};
+    for( uint32_t frame = 0; frame < frames; ++frame )
+    {
+        system.Update();
+
+        auto begin = Clock::now();
+        for( const auto& event : system.GetEvents() )
+        {
+            events_found += ( event.type == Motion::MotionEventType::FINISHED );
+        }
+        events_time += Clock::now() - begin;
+
+        begin = Clock::now();
+        for( uint32_t i = 0; i < channels; ++i )
+        {
+            const uint8_t finished = system.HasFinished( handles[i] );
+            polling_found += ( finished && !was_finished[i] );
+            was_finished[i] = finished;
+        }
+        polling_time += Clock::now() - begin;
+    }
+
+    events_ns = std::chrono::duration<double, std::nano>( events_time ).count() / frames;
+    polling_ns = std::chrono::duration<double, std::nano>( polling_time ).count() / frames;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t channels = ( argc > 1 ? std::stoul( argv[1] ) : default_channels );
+    const uint32_t frames = ( argc > 2 ? std::stoul( argv[2] ) : default_frames );
+
+    size_t mismatches = ValidateEvents( frames );
+    mismatches += ValidateQueue();
+    mismatches += ValidateConsumer( frames );
+    mismatches += ValidateTimeline();
+
+    double events_ns = 0;
+    double polling_ns = 0;
+    size_t events_found = 0;
+    size_t polling_found = 0;
+    BenchFinding( channels, frames, events_ns, polling_ns, events_found, polling_found );
+    if( events_found != channels || polling_found != channels )
+    {
+        std::cout << "finished: " << events_found << " from events, " << polling_found << " from polling" << std::endl;
+        mismatches++;
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "channels:        " << channels << " ( " << frames << " frames )" << std::endl;
+    std::cout << "events ns:       " << events_ns << " per frame" << std::endl;
+    std::cout << "polling ns:      " << polling_ns << " per frame" << std::endl;
+    std::cout << "speedup:         " << polling_ns / events_ns << "x" << std::endl;
+    std::cout << "mismatches:      " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
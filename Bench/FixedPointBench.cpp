@@ -0,0 +1,187 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "../MotionCore.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using FloatingCore = Motion::MotionCore<int, Motion::DynamicEasing, Motion::FloatingPointMath<>>;
+    using FixedCore = Motion::MotionCore<int, Motion::DynamicEasing, Motion::FixedPointMath<>>;
+
+    constexpr uint32_t default_motions = 5000;
+    constexpr uint32_t default_frames = 600;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+
+    /** Largest error allowed against the floating point path, past one unit of truncation, as a fraction of the motion range */
+    constexpr double max_relative = 0.01;
+
+    constexpr const char* type_names[type_count] =
+    {
+        "linear", "pow", "quad", "cubic", "back", "circular", "elastic", "bounce", "sine", "exponential"
+    };
+}
+
+static_assert( std::is_same<Motion::DefaultMath<int>, Motion::FloatingPointMath<>>::value, "Integral values step like MotionSystem unless fixed point is asked for" );
+static_assert( std::is_same<Motion::DefaultMath<double>, Motion::FloatingPointMath<>>::value, "Floating point values keep floating point" );
+
+template<typename ValueType>
+Motion::MotionQueue<ValueType> MakeQueue( Motion::Type type, Motion::Acceleration accel, double split )
+{
+    return {
+        {type, accel, split, 1 - split, 0, 1, 3, 2},
+        {type, Motion::Acceleration::IN, 1 - split, split, 0, 1, 3, 2},
+    };
+}
+
+/** Largest errors of one easing type */
+struct Report
+{
+    /** In units of value */
+    double units {};
+
+    /** Past one unit of truncation, as a fraction of the motion range */
+    double relative {};
+};
+
+/** Compare fixed point stepping with floating point stepping of the same values */
+Report Compare( Motion::Type type )
+{
+    Report report;
+    for( const auto accel : { Motion::Acceleration::IN, Motion::Acceleration::OUT } )
+    {
+        for( const double split : { 0.5, 0.8 } )
+        {
+            for( const int range : { 10, 320, 1920, 100000 } )
+            {
+                for( const Motion::TimeType frames : { 7u, 60u, 333u, 7200u } )
+                {
+                    FixedCore fixed;
+                    FloatingCore floating;
+                    fixed.SetParameters( -range / 3, range - range / 3, frames, MakeQueue<int>( type, accel, split ) );
+                    floating.SetParameters( -range / 3, range - range / 3, frames, MakeQueue<int>( type, accel, split ) );
+
+                    // Segments that never complete run off past the end of the easing, the tables stop at twice its duration
+                    if( fixed.GetMotionPlan()->GetPlayedDuration() == Motion::MotionPlanSegment::Never )
+                    {
+                        continue;
+                    }
+
+                    for( Motion::TimeType f = 0; f <= frames + 2; ++f )
+                    {
+                        fixed.AdvanceToNext();
+                        floating.AdvanceToNext();
+
+                        const auto error = std::abs( fixed.GetCurrentValue() - floating.GetCurrentValue() );
+                        report.units = std::fmax( report.units, error );
+                        report.relative = std::fmax( report.relative, double(error - 1) / range );
+                    }
+                }
+            }
+        }
+    }
+    return report;
+}
+
+/** Seeking and fractional advance must agree with stepping on the fixed point path too */
+size_t Validate()
+{
+    size_t mismatches = 0;
+    for( uint8_t t = 0; t < type_count; ++t )
+    {
+        // Steps that are not finite ( Elastic and Bounce at the end of a segment ) still get a defined table entry
+        const auto plan = Motion::MotionPlan::Compile( MakeQueue<int>( static_cast<Motion::Type>( t ), Motion::Acceleration::OUT, 0.5 ), 240 );
+        for( const auto& segment : plan->GetSegments() )
+        {
+            const auto table = Motion::FixedStepTableCache<Motion::DynamicEasing, 16>::Instance().Acquire( segment );
+            mismatches += std::count( table->begin(), table->end(), std::numeric_limits<int32_t>::min() );
+        }
+
+        FixedCore stepped, seeking;
+        stepped.SetParameters( 5, 1250, 240, static_cast<Motion::Type>( t ) );
+        seeking.SetParameters( 5, 1250, 240, static_cast<Motion::Type>( t ) );
+
+        for( Motion::TimeType f = 1; f <= 250; ++f )
+        {
+            stepped.AdvanceToNext();
+            mismatches += ( stepped.GetCurrentValue() != seeking.EvaluateAt( f ) );
+        }
+
+        // Whole frame advances land on the stepped values
+        stepped.Reset();
+        seeking.Reset();
+        for( Motion::TimeType f = 0; f < 80; ++f )
+        {
+            stepped.AdvanceToNext();
+            stepped.AdvanceToNext();
+            stepped.AdvanceToNext();
+            seeking.AdvanceBy( 3.0 );
+            mismatches += ( stepped.GetCurrentValue() != seeking.GetCurrentValue() );
+        }
+    }
+    return mismatches;
+}
+
+template<typename Core>
+double Bench( uint32_t motions, uint32_t frames, long long& checksum )
+{
+    std::vector<Core> cores( motions );
+    for( uint32_t i = 0; i < motions; ++i )
+    {
+        cores[i].SetParameters( i % 100, 500 + i % 700, frames/2 + i % (frames/2), static_cast<Motion::Type>( i % type_count ) );
+    }
+
+    const auto begin = Clock::now();
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        for( auto& core : cores )
+        {
+            core.AdvanceToNext();
+            checksum += core.GetCurrentValue();
+        }
+    }
+    const auto end = Clock::now();
+
+    return std::chrono::duration<double, std::milli>( end - begin ).count();
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t motions = ( argc > 1 ? std::stoul( argv[1] ) : default_motions );
+    const uint32_t frames = ( argc > 2 ? std::stoul( argv[2] ) : default_frames );
+
+    size_t failures = Validate();
+
+    std::cout << "max error against floating point ( units, fraction of range past one unit ):" << std::endl;
+    for( uint8_t t = 0; t < type_count; ++t )
+    {
+        const auto report = Compare( static_cast<Motion::Type>( t ) );
+        const bool failed = ( report.relative > max_relative );
+        failures += failed;
+
+        std::cout << "  " << std::left << std::setw(13) << type_names[t] << std::right
+                  << std::setw(6) << report.units << "  " << std::scientific << std::setprecision(2) << report.relative
+                  << std::defaultfloat << ( failed ? "  OVER BOUND" : "" ) << std::endl;
+    }
+
+    long long floating_sum = 0, fixed_sum = 0;
+    const auto floating_ms = Bench<FloatingCore>( motions, frames, floating_sum );
+    const auto fixed_ms = Bench<FixedCore>( motions, frames, fixed_sum );
+
+    std::cout << "motions:       " << motions << std::endl;
+    std::cout << "frames:        " << frames << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "floating:      " << floating_ms * 1e6 / (double(motions) * frames) << " ns/motion-frame" << std::endl;
+    std::cout << "fixed Q16.16:  " << fixed_ms * 1e6 / (double(motions) * frames) << " ns/motion-frame" << std::endl;
+    std::cout << "speedup:       " << floating_ms / fixed_ms << "x" << std::endl;
+    std::cout << "checksums:     " << floating_sum << " / " << fixed_sum << std::endl;
+    std::cout << "failures:      " << failures << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+
+#include "../MotionCore.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_cores = 5000;
+    constexpr uint32_t default_frames = 600;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+
+    /** Bytes allocated by the reference deques */
+    size_t deque_bytes = 0;
+}
+
+/** Allocator counting the bytes a container takes */
+template<typename T>
+struct CountingAllocator
+{
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template<typename U>
+    CountingAllocator( const CountingAllocator<U>& )
+    {}
+
+    T* allocate( size_t n )
+    {
+        deque_bytes += n * sizeof(T);
+        return std::allocator<T>().allocate( n );
+    }
+
+    void deallocate( T* pointer, size_t n )
+    {
+        deque_bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate( pointer, n );
+    }
+
+    template<typename U>
+    bool operator==( const CountingAllocator<U>& ) const { return true; }
+
+    template<typename U>
+    bool operator!=( const CountingAllocator<U>& ) const { return false; }
+};
+
+using CountedDeque = std::deque<double, CountingAllocator<double>>;
+
+void Setup( Motion::MotionCore<double>& core, uint32_t i, uint32_t frames )
+{
+    core.SetParameters( i % 100, 500 + i % 700, frames/2 + i % (frames/2), static_cast<Motion::Type>( i % type_count ) );
+}
+
+/** Precomputed playback, replayed after Reset(), must match runtime calculation */
+size_t Validate( uint32_t cores, uint32_t frames )
+{
+    size_t mismatches = 0;
+    for( uint32_t i = 0; i < cores; i += 53 )
+    {
+        Motion::MotionCore<double> runtime( true ), baked( false );
+        Setup( runtime, i, frames );
+        Setup( baked, i, frames );
+
+        for( int pass = 0; pass < 2; ++pass )
+        {
+            runtime.Reset();
+            baked.Reset();
+            for( uint32_t f = 0; f < frames; ++f )
+            {
+                runtime.AdvanceToNext();
+                baked.AdvanceToNext();
+                if( runtime.GetCurrentValue() != baked.GetCurrentValue() )
+                {
+                    mismatches++;
+                }
+            }
+
+            if( !baked.HasFinished() )
+            {
+                mismatches++;
+            }
+        }
+    }
+    return mismatches;
+}
+
+/** Step precomputed motions through the contiguous buffer */
+double BenchBuffer( std::vector<Motion::MotionCore<double>>& cores, uint32_t frames, double& checksum )
+{
+    const auto begin = Clock::now();
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        for( auto& core : cores )
+        {
+            core.AdvanceToNext();
+            checksum += core.GetCurrentValue();
+        }
+    }
+    const auto end = Clock::now();
+    return std::chrono::duration<double, std::milli>( end - begin ).count();
+}
+
+/** Step the same values through consumed deques, as precomputed motions used to */
+double BenchDeque( std::vector<CountedDeque>& queues, uint32_t frames, double& checksum )
+{
+    std::vector<double> values( queues.size() );
+
+    const auto begin = Clock::now();
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        for( size_t i = 0; i < queues.size(); ++i )
+        {
+            if( !queues[i].empty() )
+            {
+                values[i] = queues[i].front();
+                queues[i].pop_front();
+            }
+            checksum += values[i];
+        }
+    }
+    const auto end = Clock::now();
+    return std::chrono::duration<double, std::milli>( end - begin ).count();
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t cores = ( argc > 1 ? std::stoul( argv[1] ) : default_cores );
+    const uint32_t frames = ( argc > 2 ? std::stoul( argv[2] ) : default_frames );
+
+    const auto mismatches = Validate( cores, frames );
+
+    // Heap usage of the samples, contiguous buffers against deques holding the same values
+    std::vector<Motion::MotionCore<double>> baked;
+    std::vector<CountedDeque> queues;
+    baked.reserve( cores );
+    queues.reserve( cores );
+    size_t buffer_bytes = 0;
+    for( uint32_t i = 0; i < cores; ++i )
+    {
+        baked.emplace_back( false );
+        Setup( baked.back(), i, frames );
+
+        const auto& values = baked.back().GetInterpolatedValues();
+        buffer_bytes += values.capacity() * sizeof(double);
+        queues.emplace_back( values.begin(), values.end() );
+    }
+    const auto queue_bytes = deque_bytes;
+
+    double buffer_sum = 0, deque_sum = 0;
+    const auto buffer_ms = BenchBuffer( baked, frames, buffer_sum );
+    const auto deque_ms = BenchDeque( queues, frames, deque_sum );
+
+    // Replay costs a cursor rewind
+    const auto replay_begin = Clock::now();
+    for( auto& core : baked )
+    {
+        core.Reset();
+    }
+    const auto replay_ms = std::chrono::duration<double, std::milli>( Clock::now() - replay_begin ).count();
+
+    std::cout << "cores:         " << cores << std::endl;
+    std::cout << "frames:        " << frames << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "buffer memory: " << double(buffer_bytes) / cores << " bytes/motion" << std::endl;
+    std::cout << "deque memory:  " << double(queue_bytes) / cores << " bytes/motion" << std::endl;
+    std::cout << "buffer step:   " << buffer_ms * 1e6 / (double(cores) * frames) << " ns/motion-frame" << std::endl;
+    std::cout << "deque step:    " << deque_ms * 1e6 / (double(cores) * frames) << " ns/motion-frame" << std::endl;
+    std::cout << "speedup:       " << deque_ms / buffer_ms << "x" << std::endl;
+    std::cout << "replay:        " << replay_ms * 1e6 / cores << " ns/motion" << std::endl;
+    std::cout << "mismatches:    " << mismatches + ( buffer_sum != deque_sum ) << std::endl;
+
+    return ( mismatches == 0 && buffer_sum == deque_sum ) ? 0 : 1;
+}
@@ -0,0 +1,403 @@
+/** --------------------------------------------------------
+ *
+ *                  MOTION BENCH
+ *
+ * Microbenchmarks of the easing and motion hot paths.
+ *
+ * Prints one CSV row per case: name, ns/sample, samples/s
+ *   and heap allocations per frame. With --compare, rows are
+ *    checked against a previous run and the exit code is 1
+ *     if any case got slower than the allowed tolerance.
+ *
+ *   MotionBench [--quick] [--out file] [--compare file [--tolerance 0.25]]
+ *
+-------------------------------------------------------- **/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdlib>
+#include <cstring>
+
+#include "../Motion.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+
+    constexpr const char* type_names[type_count] =
+    {
+        "linear", "pow", "quad", "cubic", "back", "circular", "elastic", "bounce", "sine", "exponential"
+    };
+
+    /** Heap allocations made so far */
+    size_t allocations = 0;
+
+    /** Keeps results alive */
+    volatile double sink = 0;
+
+    /** Single benchmark result */
+    struct Result
+    {
+        std::string name;
+        double ns_per_sample;
+        double samples_per_sec;
+        double allocs_per_frame;
+    };
+
+    /** Benchmark size */
+    struct Scale
+    {
+        uint32_t samples = 1 << 18;
+        uint32_t motions = 2000;
+        uint32_t frames = 600;
+        int repeats = 3;
+    };
+}
+
+// The replacement operators pair malloc() with free(), GCC can't tell once they are inlined into each other
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new( size_t size )
+{
+    allocations++;
+    if( auto* p = std::malloc( size ? size : 1 ) ) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[]( size_t size )
+{
+    return operator new( size );
+}
+
+void* operator new( size_t size, std::align_val_t alignment )
+{
+    allocations++;
+    const auto align = static_cast<size_t>( alignment );
+    if( auto* p = std::aligned_alloc( align, ( size + align - 1 ) / align * align ) ) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete( void* p ) noexcept { std::free( p ); }
+void operator delete[]( void* p ) noexcept { std::free( p ); }
+void operator delete( void* p, size_t ) noexcept { std::free( p ); }
+void operator delete[]( void* p, size_t ) noexcept { std::free( p ); }
+void operator delete( void* p, std::align_val_t ) noexcept { std::free( p ); }
+void operator delete( void* p, size_t, std::align_val_t ) noexcept { std::free( p ); }
+
+#pragma GCC diagnostic pop
+
+/** Time a case, keeping the best of several runs. run() returns the number of samples and frames it did */
+template<typename Setup, typename Run>
+Result Measure( const std::string& name, int repeats, Setup&& setup, Run&& run )
+{
+    Result result { name, 1e300, 0, 0 };
+    for( int r = 0; r < repeats; ++r )
+    {
+        auto state = setup();
+
+        const auto allocations_before = allocations;
+        const auto begin = Clock::now();
+        const auto counts = run( state );
+        const auto end = Clock::now();
+        const auto allocated = allocations - allocations_before;
+
+        const auto ns = std::chrono::duration<double, std::nano>( end - begin ).count() / counts.first;
+        if( ns < result.ns_per_sample )
+        {
+            result.ns_per_sample = ns;
+            result.samples_per_sec = 1e9 / ns;
+        }
+        result.allocs_per_frame = double(allocated) / counts.second;
+    }
+    return result;
+}
+
+/** Easing function evaluation, normalized and windowed */
+void BenchEasing( const Scale& scale, std::vector<Result>& results )
+{
+    for( uint8_t t = 0; t < type_count; ++t )
+    {
+        for( const auto accel : { Motion::Acceleration::IN, Motion::Acceleration::OUT } )
+        {
+            const auto type = static_cast<Motion::Type>( t );
+            const std::string base = std::string("easing/") + type_names[t] + ( accel == Motion::Acceleration::IN ? "/in" : "/out" );
+
+            for( const bool window : { false, true } )
+            {
+                const double from = ( window ? 0.2 : 0.0 );
+                const double to = ( window ? 0.9 : 1.0 );
+
+                results.emplace_back( Measure( base + ( window ? "/window" : "/normalized" ), scale.repeats,
+                    []() { return 0; },
+                    [&]( int )
+                    {
+                        double sum = 0;
+                        const double step = 1.0 / scale.samples;
+                        for( uint32_t i = 0; i < scale.samples; ++i )
+                        {
+                            sum += Motion::EasingFunctions::GetFunctionValue( i * step, from, to, type, accel, 3, 2 );
+                        }
+                        sink = sink + sum;
+                        return std::make_pair( double(scale.samples), double(scale.samples) );
+                    }
+                ) );
+            }
+        }
+    }
+}
+
+Motion::MotionQueue<double> LongQueue( uint32_t segments )
+{
+    Motion::MotionQueue<double> queue;
+    for( uint32_t i = 0; i < segments; ++i )
+    {
+        queue.push_back( { static_cast<Motion::Type>( i % type_count ), ( i % 2 ? Motion::Acceleration::OUT : Motion::Acceleration::IN ),
+                           1.0 / segments, 1.0 / segments, 0, 1, 3, 2 } );
+    }
+    return queue;
+}
+
+/** Runtime stepping of many cores */
+template<typename Cores>
+std::pair<double, double> StepAll( Cores& cores, uint32_t frames )
+{
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        for( auto& core : cores )
+        {
+            core.AdvanceToNext();
+        }
+    }
+    sink = sink + cores.front().GetCurrentValue();
+    return std::make_pair( double(cores.size()) * frames, double(frames) );
+}
+
+/** MotionCore, Motion3D and MotionND */
+void BenchMotion( const Scale& scale, std::vector<Result>& results )
+{
+    const auto motions = scale.motions;
+    const auto frames = scale.frames;
+
+    results.emplace_back( Measure( "core/calculate_next", scale.repeats,
+        [&]()
+        {
+            std::vector<Motion::MotionCore<double>> cores( motions );
+            for( uint32_t i = 0; i < motions; ++i )
+            {
+                cores[i].SetParameters( i % 100, 500 + i % 700, frames, static_cast<Motion::Type>( i % type_count ) );
+            }
+            return cores;
+        },
+        [&]( std::vector<Motion::MotionCore<double>>& cores ) { return StepAll( cores, frames ); }
+    ) );
+
+    results.emplace_back( Measure( "core/fill_interpolation", scale.repeats,
+        [&]() { return std::vector<Motion::MotionCore<double>>( motions / 10, Motion::MotionCore<double>( false ) ); },
+        [&]( std::vector<Motion::MotionCore<double>>& cores )
+        {
+            for( uint32_t i = 0; i < cores.size(); ++i )
+            {
+                cores[i].SetParameters( i % 100, 500 + i % 700, frames, static_cast<Motion::Type>( i % type_count ) );
+            }
+            return std::make_pair( double(cores.size()) * frames, double(cores.size()) * frames );
+        }
+    ) );
+
+    results.emplace_back( Measure( "core/precomputed_step", scale.repeats,
+        [&]()
+        {
+            std::vector<Motion::MotionCore<double>> cores( motions, Motion::MotionCore<double>( false ) );
+            for( uint32_t i = 0; i < motions; ++i )
+            {
+                cores[i].SetParameters( i % 100, 500 + i % 700, frames, static_cast<Motion::Type>( i % type_count ) );
+            }
+            return cores;
+        },
+        [&]( std::vector<Motion::MotionCore<double>>& cores ) { return StepAll( cores, frames ); }
+    ) );
+
+    results.emplace_back( Measure( "core/long_queue_64", scale.repeats,
+        [&]()
+        {
+            std::vector<Motion::MotionCore<double>> cores( motions );
+            for( uint32_t i = 0; i < motions; ++i )
+            {
+                cores[i].SetParameters( i % 100, 500 + i % 700, frames, LongQueue( 64 ) );
+            }
+            return cores;
+        },
+        [&]( std::vector<Motion::MotionCore<double>>& cores ) { return StepAll( cores, frames ); }
+    ) );
+
+    results.emplace_back( Measure( "motion3d/step", scale.repeats,
+        [&]()
+        {
+            std::vector<Motion::Motion3D<double>> points( motions );
+            for( uint32_t i = 0; i < motions; ++i )
+            {
+                points[i].SetParameters( {0, 10, 20}, {500.0 + i % 700, 300, -200}, frames, static_cast<Motion::Type>( i % type_count ) );
+            }
+            return points;
+        },
+        [&]( std::vector<Motion::Motion3D<double>>& points )
+        {
+            for( uint32_t f = 0; f < frames; ++f )
+            {
+                for( auto& point : points )
+                {
+                    point.AdvanceToNext();
+                }
+            }
+            sink = sink + points.front().GetCurrentValue().x;
+            return std::make_pair( double(points.size()) * frames, double(frames) );
+        }
+    ) );
+
+    results.emplace_back( Measure( "motion3d/step_per_axis", scale.repeats,
+        [&]()
+        {
+            std::vector<Motion::Motion3D<double>> points( motions );
+            for( uint32_t i = 0; i < motions; ++i )
+            {
+                const auto queue = LongQueue( 2 );
+                points[i].SetParameters( {0, 10, 20}, {500.0 + i % 700, 300, -200}, frames, queue, queue, queue );
+            }
+            return points;
+        },
+        [&]( std::vector<Motion::Motion3D<double>>& points )
+        {
+            for( uint32_t f = 0; f < frames; ++f )
+            {
+                for( auto& point : points )
+                {
+                    point.AdvanceToNext();
+                }
+            }
+            sink = sink + points.front().GetCurrentValue().x;
+            return std::make_pair( double(points.size()) * frames, double(frames) );
+        }
+    ) );
+
+    results.emplace_back( Measure( "motionnd8/step", scale.repeats,
+        [&]()
+        {
+            std::vector<Motion::MotionND<double, 8>> points( motions );
+            for( uint32_t i = 0; i < motions; ++i )
+            {
+                Motion::PointND<double, 8> start, end;
+                for( size_t c = 0; c < 8; ++c )
+                {
+                    start.at(c) = c;
+                    end.at(c) = 100.0 * c + i % 700;
+                }
+                points[i].SetParameters( start, end, frames, static_cast<Motion::Type>( i % type_count ) );
+            }
+            return points;
+        },
+        [&]( std::vector<Motion::MotionND<double, 8>>& points )
+        {
+            for( uint32_t f = 0; f < frames; ++f )
+            {
+                for( auto& point : points )
+                {
+                    point.AdvanceToNext();
+                }
+            }
+            sink = sink + points.front().GetCurrentValue().at(0);
+            return std::make_pair( double(points.size()) * frames, double(frames) );
+        }
+    ) );
+}
+
+/** Read results of a previous run */
+std::map<std::string, double> ReadBaseline( const std::string& path )
+{
+    std::map<std::string, double> baseline;
+    std::ifstream file( path );
+    std::string line;
+    std::getline( file, line );
+    while( std::getline( file, line ) )
+    {
+        std::istringstream row( line );
+        std::string name, ns;
+        if( std::getline( row, name, ',' ) && std::getline( row, ns, ',' ) )
+        {
+            baseline[name] = std::stod( ns );
+        }
+    }
+    return baseline;
+}
+
+int main( int argc, const char* argv[] )
+{
+    Scale scale;
+    std::string out, compare;
+    double tolerance = 0.25;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        if( !std::strcmp( argv[i], "--quick" ) )
+        {
+            scale.samples = 1 << 14;
+            scale.motions = 200;
+            scale.frames = 120;
+            scale.repeats = 1;
+        }
+        else if( !std::strcmp( argv[i], "--out" ) && i+1 < argc )           out = argv[++i];
+        else if( !std::strcmp( argv[i], "--compare" ) && i+1 < argc )       compare = argv[++i];
+        else if( !std::strcmp( argv[i], "--tolerance" ) && i+1 < argc )     tolerance = std::stod( argv[++i] );
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--out file] [--compare file [--tolerance 0.25]]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<Result> results;
+    BenchEasing( scale, results );
+    BenchMotion( scale, results );
+
+    std::ostringstream csv;
+    csv << "name,ns_per_sample,samples_per_sec,allocs_per_frame" << std::endl;
+    csv << std::fixed;
+    for( const auto& r : results )
+    {
+        csv << r.name << "," << std::setprecision(3) << r.ns_per_sample << "," << std::setprecision(0) << r.samples_per_sec
+            << "," << std::setprecision(3) << r.allocs_per_frame << std::endl;
+    }
+
+    std::cout << csv.str();
+    if( !out.empty() )
+    {
+        std::ofstream( out ) << csv.str();
+    }
+
+    if( compare.empty() )
+    {
+        return 0;
+    }
+
+    // Regression gate
+    int regressions = 0;
+    const auto baseline = ReadBaseline( compare );
+    for( const auto& r : results )
+    {
+        const auto it = baseline.find( r.name );
+        if( it != baseline.end() && r.ns_per_sample > it->second * (1 + tolerance) )
+        {
+            std::cerr << "REGRESSION " << r.name << ": " << it->second << " -> " << r.ns_per_sample << " ns/sample" << std::endl;
+            regressions++;
+        }
+    }
+
+    return regressions == 0 ? 0 : 1;
+}
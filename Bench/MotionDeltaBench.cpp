@@ -0,0 +1,126 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cmath>
+
+#include "../MotionCore.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_cores = 2000;
+    constexpr uint32_t default_frames = 600;
+    constexpr uint32_t stall_frames = 12;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+}
+
+void Setup( Motion::MotionCore<double>& core, uint32_t i, uint32_t frames )
+{
+    core.SetParameters( i % 100, 500 + i % 700, frames/2 + i % (frames/2), static_cast<Motion::Type>( i % type_count ) );
+}
+
+/** Whole frame steps must match AdvanceToNext(), whatever the step size, and AdvanceToNext() drops a played fraction */
+size_t Validate( uint32_t cores, uint32_t frames, bool runtime )
+{
+    size_t mismatches = 0;
+    for( uint32_t i = 0; i < cores; i += 97 )
+    {
+        Motion::MotionCore<double> stepped( runtime ), whole( runtime ), half( runtime ), jumped( runtime ), mixed( runtime );
+        Setup( stepped, i, frames );
+        Setup( whole, i, frames );
+        Setup( half, i, frames );
+        Setup( jumped, i, frames );
+        Setup( mixed, i, frames );
+
+        for( uint32_t f = 1; f <= frames; ++f )
+        {
+            stepped.AdvanceToNext();
+            whole.AdvanceBy( 1.0 );
+
+            half.AdvanceBy( 0.5 );
+            const auto between = half.GetCurrentValue();
+            half.AdvanceBy( 0.5 );
+
+            mixed.AdvanceBy( 0.5 );
+            mixed.AdvanceToNext();
+
+            if( whole.GetCurrentValue() != stepped.GetCurrentValue()
+                || half.GetCurrentValue() != stepped.GetCurrentValue()
+                || mixed.GetCurrentValue() != stepped.GetCurrentValue()
+                || whole.HasFinished() != stepped.HasFinished() )
+            {
+                mismatches++;
+            }
+
+            // Values between frames may overshoot with Back/Elastic, but stay near the value range
+            if( !std::isfinite( between ) || between < -1000 || between > 2000 )
+            {
+                mismatches++;
+            }
+
+            // Stall catch-up lands on the same frame as stepping
+            if( f % stall_frames == 0 )
+            {
+                jumped.AdvanceBy( std::chrono::milliseconds( 200 ) );
+                if( jumped.GetCurrentValue() != stepped.GetCurrentValue() )
+                {
+                    mismatches++;
+                }
+            }
+        }
+    }
+    return mismatches;
+}
+
+double BenchStep( std::vector<Motion::MotionCore<double>>& cores, uint32_t steps, double frames_per_step, double& checksum )
+{
+    const auto begin = Clock::now();
+    for( uint32_t s = 0; s < steps; ++s )
+    {
+        for( auto& core : cores )
+        {
+            core.AdvanceBy( frames_per_step );
+        }
+    }
+    const auto end = Clock::now();
+
+    for( auto& core : cores )
+    {
+        checksum += core.GetCurrentValue();
+    }
+    return std::chrono::duration<double, std::milli>( end - begin ).count();
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t cores = ( argc > 1 ? std::stoul( argv[1] ) : default_cores );
+    const uint32_t frames = ( argc > 2 ? std::stoul( argv[2] ) : default_frames );
+
+    const auto mismatches = Validate( cores, frames, true ) + Validate( cores, frames, false );
+
+    std::vector<Motion::MotionCore<double>> single( cores ), stalled( cores );
+    for( uint32_t i = 0; i < cores; ++i )
+    {
+        Setup( single[i], i, frames );
+        Setup( stalled[i], i, frames * stall_frames );
+    }
+
+    // Same number of calls, one frame per call against a 200 ms stall per call
+    double checksum = 0;
+    const auto steps = frames / 2;
+    const auto single_ms = BenchStep( single, steps, 1.0, checksum );
+    const auto stalled_ms = BenchStep( stalled, steps, stall_frames, checksum );
+
+    std::cout << "cores:         " << cores << std::endl;
+    std::cout << "frames:        " << frames << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "1 frame:       " << single_ms * 1e6 / (double(cores) * steps) << " ns/call" << std::endl;
+    std::cout << "200 ms stall:  " << stalled_ms * 1e6 / (double(cores) * steps) << " ns/call" << std::endl;
+    std::cout << "checksum:      " << checksum << std::endl;
+    std::cout << "mismatches:    " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <random>
+
+#include "../MotionCore.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_segments = 16;
+    constexpr uint32_t default_frames = 20000;
+    constexpr uint32_t seek_count = 200;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+}
+
+Motion::MotionQueue<double> MakeQueue( uint32_t segments )
+{
+    Motion::MotionQueue<double> queue;
+    for( uint32_t i = 0; i < segments; ++i )
+    {
+        Motion::MotionParameters<double> params;
+        params.motion_type = static_cast<Motion::Type>( i % type_count );
+        params.accel_type = ( i % 2 ? Motion::Acceleration::OUT : Motion::Acceleration::IN );
+        params.duration = 1.0 / segments;
+        params.length = 1.0 / segments;
+        params.start_value = ( i % 3 == 0 ? 0.2 : 0.0 );
+        params.end_value = ( i % 3 == 0 ? 0.9 : 1.0 );
+        params.modifier = 2 + i % 5;
+        params.gravity = 3;
+        queue.emplace_back( params );
+    }
+    return queue;
+}
+
+/** Compare stepping against EvaluateAt() and Seek() at every frame */
+size_t Validate( const Motion::MotionQueue<double>& queue, uint32_t frames, bool runtime )
+{
+    Motion::MotionCore<double> stepped( runtime ), seeked( runtime );
+    stepped.SetParameters( -250, 1250, frames, queue );
+    seeked.SetParameters( -250, 1250, frames, queue );
+
+    size_t mismatches = 0;
+    for( uint32_t f = 1; f <= frames + 10; ++f )
+    {
+        stepped.AdvanceToNext();
+
+        // Precomputed playback holds the last value once its frames run out
+        const auto expected = stepped.EvaluateAt( runtime ? f : std::min( f, frames ) );
+        const auto expected_next = stepped.EvaluateAt( runtime ? f + 1 : std::min( f + 1, frames ) );
+
+        seeked.Seek( f );
+        if( expected != stepped.GetCurrentValue()
+            || seeked.GetCurrentValue() != stepped.GetCurrentValue()
+            || seeked.HasFinished() != stepped.HasFinished() )
+        {
+            mismatches++;
+        }
+
+        // Playback continues normally after seeking
+        seeked.AdvanceToNext();
+        if( seeked.GetCurrentValue() != expected_next )
+        {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+double BenchReplay( Motion::MotionCore<double>& core, const std::vector<uint32_t>& targets, double& checksum )
+{
+    const auto begin = Clock::now();
+    for( const auto target : targets )
+    {
+        core.Reset();
+        for( uint32_t f = 0; f < target; ++f )
+        {
+            core.AdvanceToNext();
+        }
+        checksum += core.GetCurrentValue();
+    }
+    const auto end = Clock::now();
+    return std::chrono::duration<double, std::milli>( end - begin ).count();
+}
+
+double BenchSeek( Motion::MotionCore<double>& core, const std::vector<uint32_t>& targets, double& checksum )
+{
+    const auto begin = Clock::now();
+    for( const auto target : targets )
+    {
+        core.Seek( target );
+        checksum += core.GetCurrentValue();
+    }
+    const auto end = Clock::now();
+    return std::chrono::duration<double, std::milli>( end - begin ).count();
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t segments = ( argc > 1 ? std::stoul( argv[1] ) : default_segments );
+    const uint32_t frames = ( argc > 2 ? std::stoul( argv[2] ) : default_frames );
+
+    const auto queue = MakeQueue( segments );
+
+    const auto mismatches = Validate( queue, frames, true ) + Validate( queue, std::min<uint32_t>( frames, 2000 ), false );
+
+    std::mt19937 rng( 7 );
+    std::vector<uint32_t> targets( seek_count );
+    for( auto& target : targets )
+    {
+        target = rng() % frames;
+    }
+
+    Motion::MotionCore<double> core;
+    core.SetParameters( -250, 1250, frames, queue );
+
+    double replay_sum = 0, seek_sum = 0;
+    const auto replay_ms = BenchReplay( core, targets, replay_sum );
+    const auto seek_ms = BenchSeek( core, targets, seek_sum );
+
+    std::cout << "segments:      " << segments << std::endl;
+    std::cout << "frames:        " << frames << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "replay:        " << replay_ms * 1e3 / seek_count << " us/seek" << std::endl;
+    std::cout << "Seek:          " << seek_ms * 1e3 / seek_count << " us/seek" << std::endl;
+    std::cout << "speedup:       " << replay_ms / seek_ms << "x" << std::endl;
+    std::cout << "mismatches:    " << mismatches + ( replay_sum != seek_sum ) << std::endl;
+
+    return ( mismatches == 0 && replay_sum == seek_sum ) ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+
+#include "../MotionSystem.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_channels = 10000;
+    constexpr uint32_t default_frames = 600;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+
+    struct ChannelSetup
+    {
+        double start_value;
+        double end_value;
+        Motion::TimeType frame_duration;
+        Motion::Type type;
+    };
+}
+
+std::vector<ChannelSetup> MakeSetups( uint32_t channels, uint32_t frames )
+{
+    std::vector<ChannelSetup> setups;
+    setups.reserve( channels );
+    for( uint32_t i = 0; i < channels; ++i )
+    {
+        setups.push_back( {
+            static_cast<double>( i % 100 ),
+            static_cast<double>( 500 + i % 700 ),
+            static_cast<Motion::TimeType>( frames/2 + i % (frames/2) ),
+            static_cast<Motion::Type>( i % type_count )
+        } );
+    }
+    return setups;
+}
+
+double BenchCores( const std::vector<ChannelSetup>& setups, uint32_t frames, std::vector<double>& result )
+{
+    std::vector<Motion::MotionCore<double>> cores( setups.size() );
+    for( size_t i = 0; i < setups.size(); ++i )
+    {
+        cores[i].SetParameters( setups[i].start_value, setups[i].end_value, setups[i].frame_duration, setups[i].type );
+    }
+
+    const auto begin = Clock::now();
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        for( auto& core : cores )
+        {
+            if( !core.HasFinished() )
+            {
+                core.AdvanceToNext();
+            }
+        }
+    }
+    const auto end = Clock::now();
+
+    result.clear();
+    for( auto& core : cores )
+    {
+        result.emplace_back( core.GetCurrentValue() );
+    }
+
+    return std::chrono::duration<double, std::milli>( end - begin ).count();
+}
+
+double BenchSystem( const std::vector<ChannelSetup>& setups, uint32_t frames, std::vector<double>& result )
+{
+    Motion::MotionSystem<double> system;
+    std::vector<Motion::ChannelHandle> handles;
+    system.Reserve( setups.size() );
+    for( const auto& s : setups )
+    {
+        handles.emplace_back( system.Add( s.start_value, s.end_value, s.frame_duration, s.type ) );
+    }
+
+    const auto begin = Clock::now();
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        system.Update();
+    }
+    const auto end = Clock::now();
+
+    result.clear();
+    for( const auto& h : handles )
+    {
+        result.emplace_back( system.GetCurrentValue( h ) );
+    }
+
+    return std::chrono::duration<double, std::milli>( end - begin ).count();
+}
+
+/** Integral channels follow the same rules as integral cores, frame by frame */
+size_t ValidateIntegral( uint32_t frames )
+{
+    size_t mismatches = 0;
+    Motion::MotionSystem<int> system;
+    std::vector<Motion::MotionCore<int>> cores( type_count );
+    std::vector<Motion::ChannelHandle> handles;
+    for( uint8_t t = 0; t < type_count; ++t )
+    {
+        cores[t].SetParameters( -30 + t, 700 + 50*t, frames - 20*t, static_cast<Motion::Type>( t ) );
+        handles.emplace_back( system.Add( -30 + t, 700 + 50*t, frames - 20*t, static_cast<Motion::Type>( t ) ) );
+    }
+
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        system.Update();
+        for( uint8_t t = 0; t < type_count; ++t )
+        {
+            if( !cores[t].HasFinished() )
+            {
+                cores[t].AdvanceToNext();
+            }
+            mismatches += ( system.GetCurrentValue( handles[t] ) != cores[t].GetCurrentValue() );
+        }
+    }
+    return mismatches;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t channels = ( argc > 1 ? std::stoul( argv[1] ) : default_channels );
+    const uint32_t frames = ( argc > 2 ? std::stoul( argv[2] ) : default_frames );
+
+    const auto setups = MakeSetups( channels, frames );
+    std::vector<double> core_values, system_values;
+
+    const auto core_ms = BenchCores( setups, frames, core_values );
+    const auto system_ms = BenchSystem( setups, frames, system_values );
+
+    size_t mismatches = ValidateIntegral( 400 );
+    for( size_t i = 0; i < channels; ++i )
+    {
+        if( core_values[i] != system_values[i] )
+        {
+            mismatches++;
+        }
+    }
+
+    std::cout << "channels:      " << channels << std::endl;
+    std::cout << "frames:        " << frames << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "MotionCore:    " << core_ms << " ms (" << core_ms * 1e6 / (double(channels) * frames) << " ns/channel-frame)" << std::endl;
+    std::cout << "MotionSystem:  " << system_ms << " ms (" << system_ms * 1e6 / (double(channels) * frames) << " ns/channel-frame)" << std::endl;
+    std::cout << "speedup:       " << core_ms / system_ms << "x" << std::endl;
+    std::cout << "mismatches:    " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
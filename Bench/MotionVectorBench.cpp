@@ -0,0 +1,163 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cmath>
+
+#include "../Motion.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_motions = 5000;
+    constexpr uint32_t default_frames = 600;
+    constexpr size_t wide = 8;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+
+    template<typename ValueType>
+    Motion::MotionQueue<ValueType> MakeQueue( uint32_t i )
+    {
+        const auto type = static_cast<Motion::Type>( i % type_count );
+        return {
+            {type, Motion::Acceleration::OUT, 0.3, 0.4, 0, 1, 3, 2},
+            {type, Motion::Acceleration::IN,  0.7, 0.6, 0, 1, 3, 2},
+        };
+    }
+
+    template<size_t Dimension>
+    Motion::PointND<double, Dimension> MakePoint( uint32_t i, double offset )
+    {
+        Motion::PointND<double, Dimension> p;
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            // Every third component stays put
+            p.at(c) = ( c % 3 == 2 ? 7.0 : offset + (i * 31 + c * 17) % 500 );
+        }
+        return p;
+    }
+}
+
+/** Shared easing evaluation must give exactly the per-axis values */
+template<size_t Dimension>
+size_t Validate( uint32_t motions, uint32_t frames, bool runtime )
+{
+    size_t mismatches = 0;
+    for( uint32_t i = 0; i < motions; i += 41 )
+    {
+        Motion::MotionND<double, Dimension> shared( runtime ), separate( runtime );
+        const auto queue = MakeQueue<double>( i );
+        std::array<Motion::MotionQueue<double>, Dimension> queues;
+        queues.fill( queue );
+
+        shared.SetParameters( MakePoint<Dimension>( i, 0 ), MakePoint<Dimension>( i, 300 ), frames/2 + i % (frames/2), queue );
+        separate.SetParameters( MakePoint<Dimension>( i, 0 ), MakePoint<Dimension>( i, 300 ), frames/2 + i % (frames/2), queues );
+
+        for( uint32_t f = 0; f < frames; ++f )
+        {
+            shared.AdvanceToNext();
+            separate.AdvanceToNext();
+            if( shared.GetCurrentValue().values != separate.GetCurrentValue().values || shared.HasFinished() != separate.HasFinished() )
+            {
+                mismatches++;
+            }
+
+            // Axis views read the same in both modes
+            for( size_t c = 0; c < Dimension; ++c )
+            {
+                mismatches += ( shared.at(c).GetCurrentValue() != separate.at(c).GetCurrentValue()
+                             || std::fabs( shared.at(c).GetCurrentVelocity() - separate.at(c).GetCurrentVelocity() ) > 1e-9 );
+            }
+        }
+
+        // And in spring mode
+        shared.SetTarget( MakePoint<Dimension>( i, 100 ) );
+        shared.AdvanceToNext();
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            mismatches += ( shared.at(c).GetCurrentValue() != shared.GetCurrentValue().at(c) || shared.at(c).HasFinished() != shared.HasFinished() );
+        }
+    }
+
+    // Integral points
+    Motion::Motion2D<int> shared( runtime ), separate( runtime );
+    shared.SetParameters( {10, -40}, {610, 900}, frames, MakeQueue<int>( 3 ) );
+    separate.SetParameters( {10, -40}, {610, 900}, frames, MakeQueue<int>( 3 ), MakeQueue<int>( 3 ) );
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        shared.AdvanceToNext();
+        separate.AdvanceToNext();
+        const auto a = shared.GetCurrentValue(), b = separate.GetCurrentValue();
+        if( a.x != b.x || a.y != b.y )
+        {
+            mismatches++;
+        }
+    }
+
+    return mismatches;
+}
+
+template<size_t Dimension>
+double Bench( uint32_t motions, uint32_t frames, bool per_axis, double& checksum )
+{
+    std::vector<Motion::MotionND<double, Dimension>> points( motions );
+    for( uint32_t i = 0; i < motions; ++i )
+    {
+        const auto queue = MakeQueue<double>( i );
+        if( per_axis )
+        {
+            std::array<Motion::MotionQueue<double>, Dimension> queues;
+            queues.fill( queue );
+            points[i].SetParameters( MakePoint<Dimension>( i, 0 ), MakePoint<Dimension>( i, 300 ), frames/2 + i % (frames/2), queues );
+        }
+        else
+        {
+            points[i].SetParameters( MakePoint<Dimension>( i, 0 ), MakePoint<Dimension>( i, 300 ), frames/2 + i % (frames/2), queue );
+        }
+    }
+
+    const auto begin = Clock::now();
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        for( auto& point : points )
+        {
+            point.AdvanceToNext();
+        }
+    }
+    const auto end = Clock::now();
+
+    for( const auto& point : points )
+    {
+        checksum += point.GetCurrentValue().at(0);
+    }
+    return std::chrono::duration<double, std::milli>( end - begin ).count();
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t motions = ( argc > 1 ? std::stoul( argv[1] ) : default_motions );
+    const uint32_t frames = ( argc > 2 ? std::stoul( argv[2] ) : default_frames );
+
+    const auto mismatches = Validate<3>( motions, frames, true ) + Validate<3>( motions, frames, false )
+                          + Validate<wide>( motions, frames, true ) + Validate<wide>( motions, frames, false );
+
+    double separate_sum = 0, shared_sum = 0;
+    const auto separate3_ms = Bench<3>( motions, frames, true, separate_sum );
+    const auto shared3_ms = Bench<3>( motions, frames, false, shared_sum );
+    const auto separate8_ms = Bench<wide>( motions, frames, true, separate_sum );
+    const auto shared8_ms = Bench<wide>( motions, frames, false, shared_sum );
+
+    std::cout << "motions:       " << motions << std::endl;
+    std::cout << "frames:        " << frames << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "3D per axis:   " << separate3_ms * 1e6 / (double(motions) * frames) << " ns/motion-frame" << std::endl;
+    std::cout << "3D shared:     " << shared3_ms * 1e6 / (double(motions) * frames) << " ns/motion-frame" << std::endl;
+    std::cout << "3D speedup:    " << separate3_ms / shared3_ms << "x" << std::endl;
+    std::cout << "8D per axis:   " << separate8_ms * 1e6 / (double(motions) * frames) << " ns/motion-frame" << std::endl;
+    std::cout << "8D shared:     " << shared8_ms * 1e6 / (double(motions) * frames) << " ns/motion-frame" << std::endl;
+    std::cout << "8D speedup:    " << separate8_ms / shared8_ms << "x" << std::endl;
+    std::cout << "mismatches:    " << mismatches + ( separate_sum != shared_sum ) << std::endl;
+
+    return ( mismatches == 0 && separate_sum == shared_sum ) ? 0 : 1;
+}
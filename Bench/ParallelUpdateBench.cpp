@@ -0,0 +1,123 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <thread>
+
+#include "../MotionSystem.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_channels = 200000;
+    constexpr uint32_t default_frames = 300;
+    constexpr uint32_t core_stride = 16;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+}
+
+void Fill( Motion::MotionSystem<double>& system, std::vector<Motion::ChannelHandle>& handles, uint32_t channels, uint32_t frames )
+{
+    system.Reserve( channels );
+    for( uint32_t i = 0; i < channels; ++i )
+    {
+        handles.emplace_back( system.Add( i % 100, 500 + i % 700, frames/4 + i % frames, static_cast<Motion::Type>( i % type_count ) ) );
+    }
+}
+
+/** Run the pool update, returns milliseconds, counts differences from the serial run */
+double Run( Motion::ThreadPool* pool, uint32_t channels, uint32_t frames, std::vector<double>& values, std::vector<double>& packed )
+{
+    Motion::MotionSystem<double> system;
+    std::vector<Motion::ChannelHandle> handles;
+    Fill( system, handles, channels, frames );
+
+    const auto begin = Clock::now();
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        if( pool )
+        {
+            system.Update( *pool );
+        }
+        else
+        {
+            system.Update();
+        }
+    }
+    const auto end = Clock::now();
+
+    values.clear();
+    for( const auto& handle : handles )
+    {
+        values.emplace_back( system.GetCurrentValue( handle ) );
+    }
+    packed = system.GetCurrentValues();
+
+    return std::chrono::duration<double, std::milli>( end - begin ).count();
+}
+
+/** Advance a vector of MotionCore objects with ForEach() */
+size_t ValidateCores( Motion::ThreadPool& pool, uint32_t channels, uint32_t frames )
+{
+    std::vector<Motion::MotionCore<double>> serial( channels / core_stride ), parallel( channels / core_stride );
+    for( size_t i = 0; i < serial.size(); ++i )
+    {
+        serial[i].SetParameters( i % 100, 500 + i % 700, frames/4 + i % frames, static_cast<Motion::Type>( i % type_count ) );
+        parallel[i].SetParameters( i % 100, 500 + i % 700, frames/4 + i % frames, static_cast<Motion::Type>( i % type_count ) );
+    }
+
+    size_t mismatches = 0;
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        for( auto& core : serial )
+        {
+            core.AdvanceToNext();
+        }
+        pool.ForEach( parallel, []( Motion::MotionCore<double>& core ) { core.AdvanceToNext(); } );
+    }
+
+    for( size_t i = 0; i < serial.size(); ++i )
+    {
+        if( serial[i].GetCurrentValue() != parallel[i].GetCurrentValue() )
+        {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t channels = ( argc > 1 ? std::stoul( argv[1] ) : default_channels );
+    const uint32_t frames = ( argc > 2 ? std::stoul( argv[2] ) : default_frames );
+    const uint32_t max_threads = ( argc > 3 ? std::stoul( argv[3] ) : std::max( 4u, std::thread::hardware_concurrency() ) );
+
+    std::vector<double> serial_values, serial_packed;
+    const auto serial_ms = Run( nullptr, channels, frames, serial_values, serial_packed );
+
+    std::cout << "channels:      " << channels << std::endl;
+    std::cout << "frames:        " << frames << std::endl;
+    std::cout << "hardware:      " << std::thread::hardware_concurrency() << " threads" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "serial:        " << serial_ms << " ms" << std::endl;
+
+    size_t mismatches = 0;
+    for( uint32_t threads = 1; threads <= max_threads; threads *= 2 )
+    {
+        Motion::ThreadPool pool( threads );
+        std::vector<double> values, packed;
+        const auto ms = Run( &pool, channels, frames, values, packed );
+
+        // Values through handles and the packed order must both match
+        const auto differences = ( values != serial_values ) + ( packed != serial_packed ) + ValidateCores( pool, channels, frames );
+        mismatches += differences;
+
+        std::cout << std::setw(2) << threads << " threads:    " << ms << " ms, " << serial_ms / ms << "x"
+                  << ( differences ? "  MISMATCH" : "" ) << std::endl;
+    }
+
+    std::cout << "mismatches:    " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+
+#include "../MotionSystem.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_channels = 20000;
+    constexpr uint32_t default_frames = 2000;
+
+    /** Reader threads of the stress check */
+    constexpr uint32_t readers = 2;
+}
+
+/** Result of one reader thread */
+struct ReaderResult
+{
+    uint64_t frames_read {};
+    uint64_t torn_frames {};
+    uint64_t out_of_order {};
+    uint64_t last_update {};
+};
+
+/** Fill a system with channels playing the same motion */
+std::vector<Motion::ChannelHandle> Populate( Motion::MotionSystem<double>& system, uint32_t channels, uint32_t frames )
+{
+    std::vector<Motion::ChannelHandle> handles;
+    system.Reserve( channels, 1 );
+    for( uint32_t i = 0; i < channels; ++i )
+    {
+        handles.emplace_back( system.Add( 0.0, 1000.0, frames, { {Motion::Type::SINE, Motion::Acceleration::IN, 1, 1, 0, 1, 0, 0} } ) );
+    }
+    return handles;
+}
+
+/** Values every channel holds after each update */
+std::vector<double> ExpectedValues( uint32_t frames )
+{
+    Motion::MotionSystem<double> system;
+    const auto handle = Populate( system, 1, frames ).front();
+
+    std::vector<double> expected { system.GetCurrentValue( handle ) };
+    for( uint32_t frame = 0; frame < frames; ++frame )
+    {
+        system.Update();
+        expected.emplace_back( system.GetCurrentValue( handle ) );
+    }
+    return expected;
+}
+
+/** Readers must only ever see whole frames, in publish order, while the writer keeps updating */
+size_t StressSnapshot( uint32_t channels, uint32_t frames, const std::vector<double>& expected, double& writer_ns )
+{
+    Motion::MotionSystem<double> system;
+    Motion::MotionSnapshot<double> snapshot;
+    const auto handles = Populate( system, channels, frames );
+    system.SetSnapshot( &snapshot );
+
+    // Every reader gets a snapshot of its own, published from the same update
+    std::vector<Motion::MotionSnapshot<double>> extra( readers - 1 );
+    std::vector<ReaderResult> results( readers );
+    std::atomic<bool> done { false };
+
+    auto read = [&]( Motion::MotionSnapshot<double>& source, ReaderResult& result )
+    {
+        for( ;; )
+        {
+            const auto finished = done.load( std::memory_order_acquire );
+            if( !source.HasNewFrame() )
+            {
+                if( finished )
+                {
+                    break;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+
+            const auto& frame = source.Acquire();
+            const auto value = expected[frame.update];
+            for( const auto handle : handles )
+            {
+                if( !frame.IsValid( handle ) || frame.GetValue( handle ) != value )
+                {
+                    result.torn_frames++;
+                    break;
+                }
+            }
+
+            result.out_of_order += ( frame.update <= result.last_update );
+            result.last_update = frame.update;
+            result.frames_read++;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.emplace_back( read, std::ref( snapshot ), std::ref( results[0] ) );
+    for( uint32_t r = 1; r < readers; ++r )
+    {
+        threads.emplace_back( read, std::ref( extra[r - 1] ), std::ref( results[r] ) );
+    }
+
+    const auto begin = Clock::now();
+    for( uint32_t frame = 0; frame < frames; ++frame )
+    {
+        system.Update();
+        for( auto& target : extra )
+        {
+            system.Publish( target );
+        }
+    }
+    writer_ns = std::chrono::duration<double, std::nano>( Clock::now() - begin ).count() / frames;
+
+    done.store( true, std::memory_order_release );
+    for( auto& thread : threads )
+    {
+        thread.join();
+    }
+
+    size_t failures = 0;
+    for( uint32_t r = 0; r < readers; ++r )
+    {
+        const auto& result = results[r];
+        std::cout << "reader " << r << ":        " << result.frames_read << " frames read, " << result.torn_frames << " torn, " << result.out_of_order << " out of order" << std::endl;
+        if( result.torn_frames > 0 || result.out_of_order > 0 || result.last_update != frames )
+        {
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/** Same readers and writer sharing the live values under a lock, returns writer ns per frame */
+double BenchLocked( uint32_t channels, uint32_t frames, const std::vector<double>& expected, size_t& torn )
+{
+    Motion::MotionSystem<double> system;
+    const auto handles = Populate( system, channels, frames );
+
+    std::mutex lock;
+    std::atomic<bool> done { false };
+    std::vector<std::thread> threads;
+    std::atomic<size_t> torn_frames {};
+    for( uint32_t r = 0; r < readers; ++r )
+    {
+        threads.emplace_back( [&]()
+        {
+            while( !done.load( std::memory_order_acquire ) )
+            {
+                {
+                    std::lock_guard<std::mutex> guard( lock );
+                    const auto value = system.GetCurrentValue( handles.front() );
+                    for( const auto handle : handles )
+                    {
+                        if( system.GetCurrentValue( handle ) != value )
+                        {
+                            torn_frames++;
+                            break;
+                        }
+                    }
+                }
+                std::this_thread::yield();
+            }
+        } );
+    }
+
+    const auto begin = Clock::now();
+    for( uint32_t frame = 0; frame < frames; ++frame )
+    {
+        std::lock_guard<std::mutex> guard( lock );
+        system.Update();
+    }
+    const auto writer_ns = std::chrono::duration<double, std::nano>( Clock::now() - begin ).count() / frames;
+
+    done.store( true, std::memory_order_release );
+    for( auto& thread : threads )
+    {
+        thread.join();
+    }
+
+    torn = torn_frames + ( system.GetCurrentValue( handles.back() ) != expected.back() );
+    return writer_ns;
+}
+
+/** Cost of publishing a frame with no reader running, in ns per frame */
+double BenchPublish( uint32_t channels, uint32_t frames )
+{
+    Motion::MotionSystem<double> system;
+    Motion::MotionSnapshot<double> snapshot;
+    Populate( system, channels, frames );
+
+    const auto begin = Clock::now();
+    for( uint32_t frame = 0; frame < frames; ++frame )
+    {
+        system.Publish( snapshot );
+    }
+    return std::chrono::duration<double, std::nano>( Clock::now() - begin ).count() / frames;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t channels = ( argc > 1 ? std::stoul( argv[1] ) : default_channels );
+    const uint32_t frames = ( argc > 2 ? std::stoul( argv[2] ) : default_frames );
+
+    const auto expected = ExpectedValues( frames );
+
+    double snapshot_ns = 0;
+    auto failures = StressSnapshot( channels, frames, expected, snapshot_ns );
+
+    size_t torn = 0;
+    const auto locked_ns = BenchLocked( channels, frames, expected, torn );
+    failures += torn;
+
+    const auto publish_ns = BenchPublish( channels, frames );
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "channels:        " << channels << " ( " << frames << " frames, " << readers << " readers )" << std::endl;
+    std::cout << "writer ns:       " << snapshot_ns << " per frame with snapshots, " << locked_ns << " locked" << std::endl;
+    std::cout << "publish ns:      " << publish_ns << " per frame, " << publish_ns / channels << " per channel" << std::endl;
+    std::cout << "failures:        " << failures << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,326 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "../Motion.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_frames = 600;
+    constexpr uint32_t repeats = 2000;
+
+    /** Runge-Kutta substeps per frame of the reference integration */
+    constexpr uint32_t substeps = 64;
+
+    /** Frame the target moves on, mid-flight for every spring checked */
+    constexpr uint32_t retarget_frame = 20;
+
+    /** Largest error against the reference integration, relative to the travelled distance */
+    constexpr double max_error = 1e-9;
+
+    const char* regime_names[] = { "UNDERDAMPED", "CRITICAL", "OVERDAMPED" };
+
+    /** Springs checked, one per regime ( damping 26 is critical for stiffness 169 ) */
+    const Motion::SpringParameters springs[] =
+    {
+        { 170.0, 12.0, 1.0, 60.0, 0.01 },
+        { 169.0, 26.0, 1.0, 60.0, 0.01 },
+        { 120.0, 60.0, 2.0, 60.0, 0.01 },
+    };
+}
+
+/** Spring state integrated with classic Runge-Kutta, in value and value per frame */
+struct Reference
+{
+    double position;
+    double velocity;
+    double target;
+    double omega;
+    double zeta;
+
+    Reference( const Motion::SpringParameters& spring, double start, double start_velocity, double spring_target )
+        : position( start ),
+          velocity( start_velocity ),
+          target( spring_target ),
+          omega( std::sqrt( spring.stiffness / spring.mass ) / spring.frame_rate ),
+          zeta( spring.damping / ( 2 * std::sqrt( spring.stiffness * spring.mass ) ) )
+    {}
+
+    double Acceleration( double x, double v ) const
+    {
+        return -omega * omega * ( x - target ) - 2 * zeta * omega * v;
+    }
+
+    void AdvanceToNext()
+    {
+        const auto h = 1.0 / substeps;
+        for( uint32_t i = 0; i < substeps; ++i )
+        {
+            const auto k1x = velocity;
+            const auto k1v = Acceleration( position, velocity );
+            const auto k2x = velocity + 0.5*h*k1v;
+            const auto k2v = Acceleration( position + 0.5*h*k1x, k2x );
+            const auto k3x = velocity + 0.5*h*k2v;
+            const auto k3v = Acceleration( position + 0.5*h*k2x, k3x );
+            const auto k4x = velocity + h*k3v;
+            const auto k4v = Acceleration( position + h*k3x, k4x );
+            position += h * ( k1x + 2*k2x + 2*k3x + k4x ) / 6;
+            velocity += h * ( k1v + 2*k2v + 2*k3v + k4v ) / 6;
+        }
+    }
+};
+
+/** Closed form springs must follow the integrated ones, across a retarget, and come to rest on the target */
+size_t ValidateSpring( const Motion::SpringParameters& spring, uint32_t frames, double& worst )
+{
+    size_t mismatches = 0;
+    const char* name = nullptr;
+
+    Motion::SpringCore<double> core;
+    core.SetParameters( {100}, {900}, spring );
+    name = regime_names[static_cast<int>( core.GetRegime() )];
+
+    // Start with a kick against the motion, then retarget halfway back
+    core.Start( {100}, {-20}, {900} );
+    Reference reference( spring, 100, -20, 900 );
+
+    for( uint32_t frame = 1; frame <= frames && !core.HasFinished(); ++frame )
+    {
+        if( frame == retarget_frame )
+        {
+            const auto value = core.GetCurrentValue()[0];
+            const auto velocity = core.GetCurrentVelocity()[0];
+            core.SetTarget( {400} );
+            reference.target = 400;
+
+            if( core.GetCurrentValue()[0] != value || std::fabs( core.GetCurrentVelocity()[0] - velocity ) > 1e-12 * std::fabs( velocity ) )
+            {
+                std::cout << name << ": retarget moved the spring " << value << " -> " << core.GetCurrentValue()[0]
+                          << ", " << velocity << " -> " << core.GetCurrentVelocity()[0] << std::endl;
+                mismatches++;
+            }
+        }
+
+        core.AdvanceToNext();
+        reference.AdvanceToNext();
+        if( core.HasFinished() )
+        {
+            break;
+        }
+
+        const auto error = std::fabs( core.GetCurrentValue()[0] - reference.position ) / 800;
+        const auto velocity_error = std::fabs( core.GetCurrentVelocity()[0] - reference.velocity ) / 800;
+        worst = std::max( { worst, error, velocity_error } );
+        if( !( error <= max_error && velocity_error <= max_error ) )
+        {
+            if( mismatches++ < 8 )
+            {
+                std::cout << name << " frame " << frame << ": " << core.GetCurrentValue()[0] << " / " << reference.position
+                          << ", " << core.GetCurrentVelocity()[0] << " / " << reference.velocity << std::endl;
+            }
+        }
+    }
+
+    if( !core.HasFinished() || core.GetCurrentValue()[0] != 400 || core.GetCurrentVelocity()[0] != 0 )
+    {
+        std::cout << name << ": not at rest on the target after " << frames << " frames" << std::endl;
+        mismatches++;
+    }
+
+    // Seeking and evaluating are the same closed form
+    core.Reset();
+    core.Seek( 37.5 );
+    if( core.GetCurrentValue()[0] != core.EvaluateAt( 37.5 )[0] )
+    {
+        std::cout << name << ": seek differs from evaluation" << std::endl;
+        mismatches++;
+    }
+
+    return mismatches;
+}
+
+/** Wrappers hand an eased motion over to the spring without a jump, and spring every axis */
+size_t ValidateWrappers( uint32_t frames )
+{
+    size_t mismatches = 0;
+
+    Motion::Motion<double> motion;
+    motion.SetParameters( 0, 1000, frames, Motion::Type::SINE );
+    for( uint32_t frame = 0; frame < frames / 3; ++frame )
+    {
+        motion.AdvanceToNext();
+    }
+
+    const auto value = motion.GetCurrentValue();
+    const auto velocity = motion.GetCurrentVelocity();
+    motion.SetTarget( 200 );
+    if( !std::holds_alternative<Motion::Motion<double>::Spring>( motion.mode ) || motion.GetCurrentValue() != value || std::fabs( motion.GetCurrentVelocity() - velocity ) > 1e-9 )
+    {
+        std::cout << "Motion: handover jumped " << value << " -> " << motion.GetCurrentValue() << ", " << velocity << " -> " << motion.GetCurrentVelocity() << std::endl;
+        mismatches++;
+    }
+    while( !motion.HasFinished() )
+    {
+        motion.AdvanceToNext();
+    }
+    mismatches += ( motion.GetCurrentValue() != 200 );
+
+    Motion::Motion2D<double> motion2d;
+    motion2d.SetSpring( {0, 0}, {300, -300} );
+    motion2d.AdvanceToNext();
+    motion2d.SetTarget( {-50, 50} );
+    while( !motion2d.HasFinished() )
+    {
+        motion2d.AdvanceToNext();
+    }
+    mismatches += ( motion2d.GetCurrentValue().x != -50 || motion2d.GetCurrentValue().y != 50 );
+
+    Motion::PointND<double, 4> end, target;
+    end.values = { 10, 20, 30, 40 };
+    target.values = { 1, 2, 3, 4 };
+
+    Motion::MotionND<double, 4> motion4d;
+    motion4d.SetParameters( {}, end, frames );
+    motion4d.AdvanceToNext();
+    motion4d.SetTarget( target );
+    while( !motion4d.HasFinished() )
+    {
+        motion4d.AdvanceToNext();
+    }
+    for( size_t i = 0; i < 4; ++i )
+    {
+        mismatches += ( motion4d.GetCurrentValue().at(i) != static_cast<double>( i + 1 ) );
+    }
+
+    if( mismatches > 0 )
+    {
+        std::cout << "wrappers: springs did not settle on their targets" << std::endl;
+    }
+    return mismatches;
+}
+
+/** Constants without a settling solution are rejected, and the spring keeps playing with its own */
+size_t ValidateParameters()
+{
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    const auto inf = std::numeric_limits<double>::infinity();
+    const Motion::SpringParameters invalid[] =
+    {
+        { 170, 26, 0 },
+        { -170, 26, 1 },
+        { 170, -26, 1 },
+        { 170, 26, 1, 0 },
+        { nan, 26, 1 },
+        { 170, 26, inf },
+        { 170, 26, 1, 60, -0.01 },
+    };
+
+    size_t mismatches = 0;
+    for( const auto& params : invalid )
+    {
+        Motion::SpringCore<double> spring;
+        spring.SetParameters( {0}, {100} );
+        spring.AdvanceToNext();
+        const auto value = spring.GetCurrentValue()[0];
+
+        bool thrown = false;
+        try
+        {
+            spring.SetSpringParameters( params );
+        }
+        catch( const std::invalid_argument& )
+        {
+            thrown = true;
+        }
+
+        if( !thrown || spring.GetSpringParameters().mass != 1 || spring.GetCurrentValue()[0] != value )
+        {
+            std::cout << "parameters: stiffness " << params.stiffness << ", damping " << params.damping << ", mass " << params.mass
+                      << ", frame rate " << params.frame_rate << ", rest " << params.rest_threshold << " accepted" << std::endl;
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t frames = ( argc > 1 ? std::stoul( argv[1] ) : default_frames );
+
+    size_t failures = 0;
+    double worst = 0;
+    for( const auto& spring : springs )
+    {
+        failures += ValidateSpring( spring, frames, worst );
+    }
+    failures += ValidateWrappers( frames );
+    failures += ValidateParameters();
+
+    // Retargeting a spring against rebuilding and rebaking an eased motion
+    double checksum = 0;
+    Motion::SpringCore<double, 2> spring;
+    spring.SetParameters( {0, 0}, {1000, 1000} );
+    auto begin = Clock::now();
+    for( uint32_t r = 0; r < repeats; ++r )
+    {
+        spring.AdvanceToNext();
+        spring.SetTarget( {r % 2 ? 0.0 : 1000.0, 500.0} );
+        checksum += spring.GetCurrentValue()[0];
+    }
+    const auto retarget_ns = std::chrono::duration<double, std::nano>( Clock::now() - begin ).count() / repeats;
+
+    Motion::MotionCore<double> baked( false );
+    begin = Clock::now();
+    for( uint32_t r = 0; r < repeats; ++r )
+    {
+        baked.SetParameters( 0, r % 2 ? 0.0 : 1000.0, frames, Motion::Type::ELASTIC );
+        baked.AdvanceToNext();
+        checksum += baked.GetCurrentValue();
+    }
+    const auto rebake_ns = std::chrono::duration<double, std::nano>( Clock::now() - begin ).count() / repeats;
+
+    // Cost per frame against a runtime eased motion
+    Motion::SpringCore<double> frame_spring;
+    Motion::MotionCore<double> eased;
+    eased.SetParameters( 0, 1000, frames, Motion::Type::ELASTIC );
+    begin = Clock::now();
+    for( uint32_t r = 0; r < repeats / 10; ++r )
+    {
+        frame_spring.SetParameters( {0}, {1000}, springs[0] );
+        for( uint32_t frame = 0; frame < frames; ++frame )
+        {
+            frame_spring.AdvanceToNext();
+            checksum += frame_spring.GetCurrentValue()[0];
+        }
+    }
+    const auto spring_frame_ns = std::chrono::duration<double, std::nano>( Clock::now() - begin ).count() / ( double(repeats / 10) * frames );
+
+    begin = Clock::now();
+    for( uint32_t r = 0; r < repeats / 10; ++r )
+    {
+        eased.Reset();
+        for( uint32_t frame = 0; frame < frames; ++frame )
+        {
+            eased.AdvanceToNext();
+            checksum += eased.GetCurrentValue();
+        }
+    }
+    const auto eased_frame_ns = std::chrono::duration<double, std::nano>( Clock::now() - begin ).count() / ( double(repeats / 10) * frames );
+
+    std::cout << std::setprecision(2) << std::fixed;
+    std::cout << "frames:          " << frames << std::endl;
+    std::cout << "max error:       " << std::scientific << worst << std::fixed << std::endl;
+    std::cout << "retarget ns:     " << retarget_ns << " spring, " << rebake_ns << " rebaked ELASTIC" << std::endl;
+    std::cout << "frame ns:        " << spring_frame_ns << " spring, " << eased_frame_ns << " runtime ELASTIC" << std::endl;
+    std::cout << "checksum:        " << checksum << std::endl;
+    std::cout << "failures:        " << failures << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+
+#include "../Motion.h"
+
+static_assert( Motion::StatsEnabled, "StatsBench is built with -DMOTION_STATS=1" );
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_motions = 2000;
+    constexpr uint32_t default_frames = 600;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+}
+
+/** Counters must match what was actually played */
+size_t Validate()
+{
+    size_t mismatches = 0;
+    const auto expect = [&]( const char* what, uint64_t value, uint64_t expected )
+    {
+        if( value != expected )
+        {
+            std::cout << what << ": " << value << ", expected " << expected << std::endl;
+            mismatches++;
+        }
+    };
+
+    // Runtime playback, one evaluation per frame except the frames completing a segment
+    Motion::Stats::Reset();
+    Motion::MotionCore<double> core;
+    core.SetParameters( 0, 100, 120, Motion::Type::ELASTIC );
+    uint64_t frames = 0;
+    while( !core.HasFinished() )
+    {
+        core.AdvanceToNext();
+        frames++;
+    }
+    core.AdvanceToNext();
+
+    auto stats = Motion::Stats::Snapshot();
+    const auto segments = core.GetMotionPlan()->GetSegmentCount();
+    expect( "calculations", stats.Get( Motion::StatsCounter::CALCULATIONS ), frames );
+    expect( "transitions", stats.Get( Motion::StatsCounter::SEGMENT_TRANSITIONS ), segments );
+    expect( "elastic evaluations", stats.evaluations[static_cast<size_t>( Motion::Type::ELASTIC )], frames - segments );
+    expect( "evaluations", stats.GetEvaluations(), frames - segments );
+    expect( "bakes", stats.Get( Motion::StatsCounter::BAKES ), 0 );
+
+    // Baking counts one bake of the whole curve, calculating until the plan is played through
+    const auto before = Motion::Stats::Snapshot();
+    Motion::MotionCore<double> baked( false );
+    baked.SetParameters( 0, 100, 240, Motion::Type::BOUNCE );
+    stats = Motion::Stats::Snapshot() - before;
+    expect( "bakes", stats.Get( Motion::StatsCounter::BAKES ), 1 );
+    expect( "bake bytes", stats.Get( Motion::StatsCounter::BAKE_BYTES ), 240 * sizeof(double) );
+    expect( "bake calculations", stats.Get( Motion::StatsCounter::CALCULATIONS ), baked.GetMotionPlan()->GetPlayedDuration() );
+
+    // Shared curves are baked once
+    Motion::Stats::Reset();
+    std::vector<Motion::MotionCore<double>> shared( 3, Motion::MotionCore<double>( false ) );
+    for( auto& motion : shared )
+    {
+        motion.SetSharedBaking( true );
+        motion.SetParameters( 0, 100, 77, Motion::Type::CUBIC );
+    }
+    stats = Motion::Stats::Snapshot();
+    expect( "curve cache misses", stats.Get( Motion::StatsCounter::CURVE_CACHE_MISSES ), 1 );
+    expect( "curve cache hits", stats.Get( Motion::StatsCounter::CURVE_CACHE_HITS ), 2 );
+
+    // Fixed point step tables are built once per easing
+    Motion::Stats::Reset();
+    std::vector<Motion::MotionCore<int, Motion::DynamicEasing, Motion::FixedPointMath<>>> fixed( 3 );
+    for( auto& motion : fixed )
+    {
+        motion.SetParameters( 0, 1000, 60, Motion::Type::CIRCULAR );
+    }
+    stats = Motion::Stats::Snapshot();
+    expect( "step table misses", stats.Get( Motion::StatsCounter::STEP_TABLE_MISSES ), 2 );
+    expect( "step table hits", stats.Get( Motion::StatsCounter::STEP_TABLE_HITS ), 4 );
+
+    return mismatches;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t motions = ( argc > 1 ? std::stoul( argv[1] ) : default_motions );
+    const uint32_t frames = ( argc > 2 ? std::stoul( argv[2] ) : default_frames );
+
+    const auto mismatches = Validate();
+
+    std::vector<Motion::MotionCore<double>> cores( motions );
+    for( uint32_t i = 0; i < motions; ++i )
+    {
+        cores[i].SetParameters( i % 100, 500 + i % 700, frames/2 + i % (frames/2), static_cast<Motion::Type>( i % type_count ) );
+    }
+
+    Motion::Stats::Reset();
+    double checksum = 0;
+    const auto begin = Clock::now();
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        for( auto& core : cores )
+        {
+            core.AdvanceToNext();
+            checksum += core.GetCurrentValue();
+        }
+    }
+    const auto ms = std::chrono::duration<double, std::milli>( Clock::now() - begin ).count();
+    const auto stats = Motion::Stats::Snapshot();
+
+    std::cout << "motions:       " << motions << std::endl;
+    std::cout << "frames:        " << frames << std::endl;
+    std::cout << "calculations:  " << stats.Get( Motion::StatsCounter::CALCULATIONS ) << std::endl;
+    std::cout << "evaluations:   " << stats.GetEvaluations() << std::endl;
+    std::cout << "transitions:   " << stats.Get( Motion::StatsCounter::SEGMENT_TRANSITIONS ) << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "instrumented:  " << ms * 1e6 / (double(motions) * frames) << " ns/motion-frame (compare with MotionBench, built without stats)" << std::endl;
+    std::cout << "measured:      " << stats.GetCalculationNanoseconds() << " ns/calculation" << std::endl;
+    std::cout << "checksum:      " << checksum << std::endl;
+    std::cout << "mismatches:    " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
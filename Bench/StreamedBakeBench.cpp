@@ -0,0 +1,149 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+
+#include "../MotionCore.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_motions = 200;
+    constexpr uint32_t default_frames = 10 * 60 * 120;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+    constexpr size_t chunks[] = { 1, 7, 64, Motion::DefaultStreamChunk };
+}
+
+template<typename ValueType>
+void Setup( Motion::MotionCore<ValueType>& core, uint32_t i, uint32_t frames, bool streamed, size_t chunk = Motion::DefaultStreamChunk )
+{
+    core.SetStreamedBaking( streamed, chunk );
+    core.SetParameters( i % 100, 500 + i % 700, frames/2 + i % (frames/2), static_cast<Motion::Type>( i % type_count ) );
+}
+
+/** Streamed playback must give exactly the eagerly baked values, whatever the chunk size and the way it is played */
+template<typename ValueType>
+size_t Validate( uint32_t frames )
+{
+    size_t mismatches = 0;
+    for( uint32_t i = 0; i < 3 * type_count; ++i )
+    {
+        for( const auto chunk : chunks )
+        {
+            Motion::MotionCore<ValueType> eager( false ), streamed( false );
+            Setup( eager, i, frames, false );
+            Setup( streamed, i, frames, true, chunk );
+
+            mismatches += ( eager.GetBakedCount() != streamed.GetBakedCount() ) + !streamed.IsStreamed();
+
+            const auto check = [&]()
+            {
+                mismatches += ( eager.GetCurrentValue() != streamed.GetCurrentValue() ) + ( eager.HasFinished() != streamed.HasFinished() );
+            };
+
+            // Straight through, then again after Reset()
+            for( int pass = 0; pass < 2; ++pass )
+            {
+                eager.Reset();
+                streamed.Reset();
+                for( uint32_t f = 0; f < frames + 2; ++f )
+                {
+                    eager.AdvanceToNext();
+                    streamed.AdvanceToNext();
+                    check();
+                }
+            }
+
+            // Seeking back and forth
+            for( Motion::TimeType frame : { frames / 3, frames / 7, frames - 1, 0u, frames / 2 } )
+            {
+                eager.Seek( frame );
+                streamed.Seek( frame );
+                check();
+                for( uint32_t f = 0; f < 20; ++f )
+                {
+                    eager.AdvanceToNext();
+                    streamed.AdvanceToNext();
+                    check();
+                }
+            }
+
+            // Fractional advance interpolates across chunk boundaries
+            eager.Reset();
+            streamed.Reset();
+            for( uint32_t f = 0; f < frames; f += 3 )
+            {
+                eager.AdvanceBy( 2.75 );
+                streamed.AdvanceBy( 2.75 );
+                check();
+            }
+        }
+    }
+    return mismatches;
+}
+
+/** Set up and play many long motions, returns setup and play times in milliseconds */
+double Bench( uint32_t motions, uint32_t frames, bool streamed, double& play_ms, size_t& resident_bytes, double& checksum )
+{
+    std::vector<Motion::MotionCore<double>> cores( motions, Motion::MotionCore<double>( false ) );
+
+    const auto setup_begin = Clock::now();
+    for( uint32_t i = 0; i < motions; ++i )
+    {
+        cores[i].SetStreamedBaking( streamed );
+        cores[i].SetParameters( i % 100, 500 + i % 700, frames, static_cast<Motion::Type>( i % type_count ) );
+    }
+    const auto setup_end = Clock::now();
+
+    resident_bytes = 0;
+    for( auto& core : cores )
+    {
+        resident_bytes += core.GetInterpolatedValues().capacity() * sizeof(double);
+    }
+
+    const auto play_begin = Clock::now();
+    for( uint32_t f = 0; f < frames; ++f )
+    {
+        for( auto& core : cores )
+        {
+            core.AdvanceToNext();
+        }
+    }
+    const auto play_end = Clock::now();
+
+    for( const auto& core : cores )
+    {
+        checksum += core.GetCurrentValue();
+    }
+
+    play_ms = std::chrono::duration<double, std::milli>( play_end - play_begin ).count();
+    return std::chrono::duration<double, std::milli>( setup_end - setup_begin ).count();
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t motions = ( argc > 1 ? std::stoul( argv[1] ) : default_motions );
+    const uint32_t frames = ( argc > 2 ? std::stoul( argv[2] ) : default_frames );
+
+    const auto mismatches = Validate<double>( 3000 ) + Validate<int>( 3000 );
+
+    double eager_play_ms, streamed_play_ms, eager_sum = 0, streamed_sum = 0;
+    size_t eager_bytes, streamed_bytes;
+    const auto eager_setup_ms = Bench( motions, frames, false, eager_play_ms, eager_bytes, eager_sum );
+    const auto streamed_setup_ms = Bench( motions, frames, true, streamed_play_ms, streamed_bytes, streamed_sum );
+
+    std::cout << "motions:       " << motions << std::endl;
+    std::cout << "frames:        " << frames << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "eager setup:   " << eager_setup_ms / motions << " ms/motion, " << eager_bytes / motions << " bytes/motion" << std::endl;
+    std::cout << "stream setup:  " << streamed_setup_ms / motions << " ms/motion, " << streamed_bytes / motions << " bytes/motion" << std::endl;
+    std::cout << "eager play:    " << eager_play_ms * 1e6 / (double(motions) * frames) << " ns/motion-frame" << std::endl;
+    std::cout << "stream play:   " << streamed_play_ms * 1e6 / (double(motions) * frames) << " ns/motion-frame (baking included)" << std::endl;
+    std::cout << "eager total:   " << eager_setup_ms + eager_play_ms << " ms" << std::endl;
+    std::cout << "stream total:  " << streamed_setup_ms + streamed_play_ms << " ms" << std::endl;
+    std::cout << "mismatches:    " << mismatches + ( eager_sum != streamed_sum ) << std::endl;
+
+    return ( mismatches == 0 && eager_sum == streamed_sum ) ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+
+#include "../Timeline.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t default_items = 50000;
+    constexpr uint32_t default_duration = 300;
+    constexpr Motion::TimeType stagger = 1;
+    constexpr uint8_t type_count = static_cast<uint8_t>(Motion::Type::EXPONENTIAL) + 1;
+
+    /** Motions checked against MotionCore */
+    constexpr uint32_t checked = 64;
+}
+
+/** Timeline motions must play like a MotionCore started after their delay, repeat and stop when removed */
+size_t Validate()
+{
+    size_t mismatches = 0;
+
+    Motion::Timeline<double> timeline;
+    std::vector<Motion::TimelineHandle> handles;
+    std::vector<Motion::MotionCore<double>> cores( checked );
+    std::vector<Motion::TimeType> delays;
+    for( uint32_t i = 0; i < checked; ++i )
+    {
+        const auto type = static_cast<Motion::Type>( i % type_count );
+        const auto duration = static_cast<Motion::TimeType>( 20 + i % 37 );
+        const Motion::MotionQueue<double> queue =
+        {
+            {type, Motion::Acceleration::OUT, 0.5, 0.5, 0, 1, 4, 2},
+            {type, Motion::Acceleration::IN,  0.5, 0.5, 0, 1, 4, 2},
+        };
+
+        cores[i].SetParameters( -100.0 + i, 900.0 - i, duration, queue );
+        delays.emplace_back( ( i * 7 ) % 50 );
+        handles.emplace_back( timeline.Schedule( -100.0 + i, 900.0 - i, duration, queue, { delays.back() } ) );
+    }
+
+    for( uint32_t frame = 1; frame < 200; ++frame )
+    {
+        timeline.Update();
+        for( uint32_t i = 0; i < checked; ++i )
+        {
+            if( frame > delays[i] )
+            {
+                cores[i].AdvanceToNext();
+            }
+
+            const auto expected_state = ( frame <= delays[i] ? Motion::TimelineState::SCHEDULED
+                                        : cores[i].HasFinished() ? Motion::TimelineState::FINISHED : Motion::TimelineState::ACTIVE );
+            if( timeline.GetCurrentValue( handles[i] ) != cores[i].GetCurrentValue() || timeline.GetState( handles[i] ) != expected_state )
+            {
+                if( mismatches++ < 8 )
+                {
+                    std::cout << "motion " << i << " frame " << frame << ": " << timeline.GetCurrentValue( handles[i] ) << " / " << cores[i].GetCurrentValue()
+                              << ", state " << +static_cast<int>( timeline.GetState( handles[i] ) ) << " / " << +static_cast<int>( expected_state ) << std::endl;
+                }
+            }
+        }
+    }
+
+    // Three runs 5 frames apart after a delay of 3, holding the ending value in between
+    const Motion::MotionQueue<double> linear = { {Motion::Type::LINEAR, Motion::Acceleration::IN, 1, 1, 0, 1, 0, 0} };
+    Motion::MotionCore<double> single;
+    single.SetParameters( 0.0, 10.0, 10, linear );
+    uint32_t run = 0;
+    for( ; !single.HasFinished(); ++run )
+    {
+        single.AdvanceToNext();
+    }
+    const auto expected_frame = 3 + 3*run + 2*5;
+
+    timeline.Clear();
+    const auto repeated = timeline.Schedule( 0.0, 10.0, 10, linear, { 3, 2, 5 } );
+    const auto removed = timeline.Schedule( 0.0, 10.0, 10, linear, { 20 } );
+    timeline.Remove( removed );
+
+    // Starts of removed motions are not pending, however many are dropped before they are due
+    for( int i = 0; i < 1000; ++i )
+    {
+        timeline.Remove( timeline.Schedule( 0.0, 10.0, 10, linear, { 1000 } ) );
+    }
+    if( timeline.GetPendingCount() != 1 )
+    {
+        std::cout << "pending: " << timeline.GetPendingCount() << " starts, expected 1" << std::endl;
+        mismatches++;
+    }
+
+    uint32_t finished_frame = 0;
+    for( uint32_t frame = 1; frame < 100 && finished_frame == 0; ++frame )
+    {
+        timeline.Update();
+        if( frame == 3 + run + 2 && ( timeline.GetState( repeated ) != Motion::TimelineState::SCHEDULED || timeline.GetCurrentValue( repeated ) != 10.0 ) )
+        {
+            std::cout << "repeat: not waiting on the ending value between runs" << std::endl;
+            mismatches++;
+        }
+        if( timeline.GetLiveCount() > 1 )
+        {
+            std::cout << "removed motion started" << std::endl;
+            mismatches++;
+        }
+        finished_frame = ( timeline.HasFinished( repeated ) ? frame : 0 );
+    }
+
+    if( finished_frame != expected_frame || timeline.IsValid( removed ) )
+    {
+        std::cout << "repeat: finished on frame " << finished_frame << ", expected " << expected_frame << std::endl;
+        mismatches++;
+    }
+
+    return mismatches;
+}
+
+/** Play staggered items to the end with a timeline, returns ns per frame and the largest live count */
+double BenchTimeline( uint32_t items, const Motion::MotionPlanPtr& plan, double& checksum, size_t& max_live )
+{
+    Motion::Timeline<double> timeline;
+    std::vector<Motion::TimelineHandle> handles;
+    timeline.Reserve( items, plan->GetFrameDuration() + 1 );
+    timeline.Stagger( items, stagger, 0.0, 100.0, plan, {}, handles );
+
+    const auto frames = items * stagger + plan->GetFrameDuration() + 1;
+    const auto begin = Clock::now();
+    for( uint32_t frame = 0; frame < frames; ++frame )
+    {
+        timeline.Update();
+        max_live = std::max( max_live, timeline.GetLiveCount() );
+    }
+    const auto end = Clock::now();
+
+    for( const auto handle : handles )
+    {
+        checksum += timeline.GetCurrentValue( handle );
+    }
+    return std::chrono::duration<double, std::nano>( end - begin ).count() / frames;
+}
+
+/** Play staggered items to the end by polling every one of them each frame, returns ns per frame */
+double BenchPolling( uint32_t items, const Motion::MotionPlanPtr& plan, double& checksum )
+{
+    std::vector<Motion::MotionCore<double>> cores( items );
+    std::vector<Motion::TimeType> delays( items );
+    for( uint32_t i = 0; i < items; ++i )
+    {
+        cores[i].SetStartingValue( 0.0 );
+        cores[i].SetEndingValue( 100.0 );
+        cores[i].SetMotionPlan( plan );
+        delays[i] = i * stagger;
+    }
+
+    const auto frames = items * stagger + plan->GetFrameDuration() + 1;
+    const auto begin = Clock::now();
+    for( uint32_t frame = 0; frame < frames; ++frame )
+    {
+        for( uint32_t i = 0; i < items; ++i )
+        {
+            if( delays[i] > 0 )
+            {
+                delays[i]--;
+            }
+            else if( !cores[i].HasFinished() )
+            {
+                cores[i].AdvanceToNext();
+            }
+        }
+    }
+    const auto end = Clock::now();
+
+    for( auto& core : cores )
+    {
+        checksum += core.GetCurrentValue();
+    }
+    return std::chrono::duration<double, std::nano>( end - begin ).count() / frames;
+}
+
+int main( int argc, const char* argv[] )
+{
+    const uint32_t items = ( argc > 1 ? std::stoul( argv[1] ) : default_items );
+    const uint32_t duration = ( argc > 2 ? std::stoul( argv[2] ) : default_duration );
+
+    const auto mismatches = Validate();
+
+    auto plan = std::make_shared<Motion::MotionPlan>();
+    plan->Rebuild( Motion::MotionQueue<double>
+        {
+            {Motion::Type::SINE, Motion::Acceleration::OUT, 0.5, 0.5, 0, 1, 4, 2},
+            {Motion::Type::SINE, Motion::Acceleration::IN,  0.5, 0.5, 0, 1, 4, 2},
+        }, duration );
+
+    double checksum = 0;
+    size_t max_live = 0;
+    size_t max_live_small = 0;
+    const auto timeline_ns = BenchTimeline( items, plan, checksum, max_live );
+    const auto timeline_small_ns = BenchTimeline( items / 10, plan, checksum, max_live_small );
+    const auto polling_ns = BenchPolling( items, plan, checksum );
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "items:           " << items << " ( stagger " << stagger << ", " << duration << " frames each )" << std::endl;
+    std::cout << "max live:        " << max_live << std::endl;
+    std::cout << "timeline ns:     " << timeline_ns << " per frame, " << timeline_ns / max_live << " per live motion" << std::endl;
+    std::cout << "timeline/10 ns:  " << timeline_small_ns << " per frame, " << items / 10 << " items" << std::endl;
+    std::cout << "polling ns:      " << polling_ns << " per frame" << std::endl;
+    std::cout << "speedup:         " << polling_ns / timeline_ns << "x" << std::endl;
+    std::cout << "checksum:        " << checksum << std::endl;
+    std::cout << "mismatches:      " << mismatches << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
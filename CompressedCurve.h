@@ -0,0 +1,236 @@
+/** --------------------------------------------------------
+ *
+ *                 COMPRESSED CURVE
+ *
+ * Piecewise cubic Hermite approximation of baked motion
+ *   values, fitted within a given maximum error. Smooth
+ *    curves need only a few segments instead of one value
+ *     per frame.
+ *
+ * Knots are placed greedily, each segment as long as it
+ *   keeps every sample it covers within the error, with
+ *    slopes taken from the samples around the knot. Every
+ *     accepted segment is checked sample by sample, so the
+ *      bound always holds ( a one frame segment is exact ).
+ *
+ * Decoding is O(1): a bucket table gives the first segment
+ *   of each run of CompressedBucketFrames frames, and the
+ *    segment of a frame is at most that many steps further.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_COMPRESSED_CURVE_H
+#define MOTION_COMPRESSED_CURVE_H
+
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+namespace Motion
+{
+
+/** Frames per lookup bucket of a compressed curve */
+constexpr size_t CompressedBucketFrames = 32;
+
+/** Piecewise cubic Hermite curve fitted to baked values */
+class CompressedCurve
+{
+private:
+
+    /** Frame of each knot ( the first is 0, the last is the last frame ) */
+    std::vector<uint32_t> knot_frames;
+
+    /** Value at each knot */
+    std::vector<double> knot_values;
+
+    /** Slope at each knot, in value per frame */
+    std::vector<double> knot_slopes;
+
+    /** Segment holding the first frame of each bucket */
+    std::vector<uint32_t> buckets;
+
+    /** Number of samples the curve stands for */
+    size_t sample_count {};
+
+    /** Largest error of the decoded samples */
+    double max_error {};
+
+public:
+
+    /** Fit a curve to samples, keeping every decoded sample within max_error of the original */
+    template<typename Iterator>
+    static CompressedCurve Fit( Iterator begin, Iterator end, double max_error )
+    {
+        const std::vector<double> values( begin, end );
+        const auto n = values.size();
+
+        CompressedCurve curve;
+        curve.sample_count = n;
+        if( n == 0 )
+        {
+            return curve;
+        }
+
+        // Slopes from the neighbouring samples, one-sided at the ends
+        std::vector<double> slopes( n );
+        for( size_t i = 0; i < n; ++i )
+        {
+            const auto prev = values[i > 0 ? i-1 : i];
+            const auto next = values[i+1 < n ? i+1 : i];
+            const auto span = static_cast<double>( (i+1 < n ? i+1 : i) - (i > 0 ? i-1 : i) );
+            slopes[i] = ( span > 0 ? (next - prev) / span : 0.0 );
+        }
+
+        const auto fits = [&]( size_t a, size_t b )
+        {
+            const auto h = static_cast<double>( b - a );
+            for( size_t i = a + 1; i < b; ++i )
+            {
+                const auto value = Hermite( values[a], slopes[a] * h, values[b], slopes[b] * h, (i - a) / h );
+                if( !( std::fabs( value - values[i] ) <= max_error ) )
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        curve.AddKnot( 0, values[0], slopes[0] );
+        for( size_t a = 0; a + 1 < n; )
+        {
+            // Gallop to the first length that does not fit, then bisect back ( only checked segments are kept )
+            size_t good = 1;
+            size_t bad = 0;
+            for( size_t length = 2; a + good < n - 1; length *= 2 )
+            {
+                const auto b = std::min( a + length, n - 1 );
+                if( !fits( a, b ) )
+                {
+                    bad = b - a;
+                    break;
+                }
+                good = b - a;
+            }
+            while( bad > good + 1 )
+            {
+                const auto mid = good + (bad - good) / 2;
+                if( fits( a, a + mid ) )
+                {
+                    good = mid;
+                }
+                else
+                {
+                    bad = mid;
+                }
+            }
+
+            a += good;
+            curve.AddKnot( a, values[a], slopes[a] );
+        }
+
+        // Bucket table
+        curve.buckets.resize( (n + CompressedBucketFrames - 1) / CompressedBucketFrames );
+        uint32_t segment = 0;
+        for( size_t b = 0; b < curve.buckets.size(); ++b )
+        {
+            while( segment + 1 < curve.knot_frames.size() && curve.knot_frames[segment + 1] <= b * CompressedBucketFrames )
+            {
+                ++segment;
+            }
+            curve.buckets[b] = segment;
+        }
+
+        for( size_t i = 0; i < n; ++i )
+        {
+            curve.max_error = std::fmax( curve.max_error, std::fabs( curve.GetSample( i ) - values[i] ) );
+        }
+
+        return curve;
+    }
+
+    /** Get decoded sample ( O(1) ) */
+    inline double GetSample( size_t i ) const
+    {
+        auto s = buckets[i / CompressedBucketFrames];
+        while( s + 1 < knot_frames.size() && knot_frames[s + 1] <= i )
+        {
+            ++s;
+        }
+
+        if( s + 1 == knot_frames.size() )
+        {
+            return knot_values[s];
+        }
+
+        const auto h = static_cast<double>( knot_frames[s + 1] - knot_frames[s] );
+        return Hermite( knot_values[s], knot_slopes[s] * h, knot_values[s + 1], knot_slopes[s + 1] * h, (i - knot_frames[s]) / h );
+    }
+
+    /** Get decoded sample as a motion value, rounding to the nearest integer for integral types */
+    template<typename ValueType>
+    inline ValueType Get( size_t i ) const
+    {
+        if constexpr( std::is_integral<ValueType>::value )
+        {
+            return static_cast<ValueType>( std::floor( GetSample( i ) + 0.5 ) );
+        }
+        else
+        {
+            return static_cast<ValueType>( GetSample( i ) );
+        }
+    }
+
+    /** Get number of samples the curve stands for */
+    inline size_t GetSampleCount() const
+    {
+        return sample_count;
+    }
+
+    /** Get number of Hermite segments */
+    inline size_t GetSegmentCount() const
+    {
+        return knot_frames.empty() ? 0 : knot_frames.size() - 1;
+    }
+
+    /** Get largest error of the decoded samples */
+    inline double GetMaxError() const
+    {
+        return max_error;
+    }
+
+    /** Get bytes held by the knots and the bucket table */
+    inline size_t GetByteSize() const
+    {
+        return knot_frames.size() * ( sizeof(uint32_t) + 2 * sizeof(double) ) + buckets.size() * sizeof(uint32_t);
+    }
+
+private:
+
+    /** Cubic Hermite interpolation between two values with scaled slopes, t in [0, 1] */
+    static inline double Hermite( double p0, double m0, double p1, double m1, double t )
+    {
+        const auto t2 = t*t;
+        const auto t3 = t2*t;
+        return (2*t3 - 3*t2 + 1) * p0 + (t3 - 2*t2 + t) * m0 + (3*t2 - 2*t3) * p1 + (t3 - t2) * m1;
+    }
+
+    /** Append knot */
+    inline void AddKnot( size_t frame, double value, double slope )
+    {
+        knot_frames.push_back( static_cast<uint32_t>( frame ) );
+        knot_values.push_back( value );
+        knot_slopes.push_back( slope );
+    }
+
+}; // class CompressedCurve
+
+/** Shared compressed curve */
+using CompressedCurvePtr = std::shared_ptr<const CompressedCurve>;
+
+} // namespace Motion
+
+#endif /** MOTION_COMPRESSED_CURVE_H */
@@ -0,0 +1,395 @@
+/** --------------------------------------------------------
+ *
+ *                   CURVE FILE
+ *
+ * Compact binary format for baked motion curves, meant to
+ *   ship artist-authored curves and play them back with no
+ *    parsing: the file is memory mapped and the samples are
+ *     read in place.
+ *
+ * Layout ( native byte order ):
+ *   CurveFileHeader
+ *   CurveFileSegment x segment_count ( source queue, with no
+ *     Bezier points in version 1 files )
+ *   padding up to a cache line boundary
+ *   samples x sample_count ( f32, f64 or quantized i16 )
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_CURVE_FILE_H
+#define MOTION_CURVE_FILE_H
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "MotionPlan.h"
+#include "AlignedAllocator.h"
+
+namespace Motion
+{
+
+/** Sample encoding of a curve file */
+enum class SampleFormat : uint8_t
+{
+    F32,
+    F64,
+    I16,    // value = quant_offset + quant_scale * sample
+};
+
+/** Curve file header */
+struct CurveFileHeader
+{
+    /** Format version written by this header */
+    static constexpr uint16_t CurrentVersion = 2;
+
+    /** Oldest format version still read */
+    static constexpr uint16_t OldestVersion = 1;
+
+    /** File signature */
+    char magic[4] { 'M', 'C', 'R', 'V' };
+
+    /** Format version */
+    uint16_t version { CurrentVersion };
+
+    /** Sample encoding */
+    SampleFormat format { SampleFormat::F64 };
+
+    /** Unused, keeps the layout explicit */
+    uint8_t reserved {};
+
+    /** Number of source queue entries */
+    uint32_t segment_count {};
+
+    /** Byte offset of the first sample, cache line aligned */
+    uint32_t sample_offset {};
+
+    /** Number of samples */
+    uint64_t sample_count {};
+
+    /** Total duration in frames */
+    uint64_t frame_duration {};
+
+    /** Starting value of the motion */
+    double start_value {};
+
+    /** Ending value of the motion */
+    double end_value {};
+
+    /** Quantization offset ( I16 only ) */
+    double quant_offset {};
+
+    /** Quantization step ( I16 only ) */
+    double quant_scale {};
+};
+
+/** Source queue entry, as stored in a curve file */
+struct CurveFileSegment
+{
+    /** Type of easing */
+    uint8_t motion_type {};
+
+    /** Type of acceleration */
+    uint8_t accel_type {};
+
+    /** Unused, keeps the layout explicit */
+    uint8_t reserved[6] {};
+
+    /** Duration of the animation (fraction of the total) */
+    double duration {};
+
+    /** Length of the animation (fraction of the total) */
+    double length {};
+
+    /** Starting value of the function */
+    double start_value {};
+
+    /** Ending value of the function */
+    double end_value {};
+
+    /** Extra modifier for Bounce/Elastic/Pow/Exponential */
+    double modifier {};
+
+    /** Gravity modifier for Bounce/Elastic */
+    double gravity {};
+
+    /** Control points for Bezier */
+    BezierPoints bezier {};
+};
+
+/** Get size in bytes of one source queue entry in a format version ( version 1 has no Bezier points ) */
+inline size_t GetSegmentSize( uint16_t version )
+{
+    return ( version < 2 ? offsetof( CurveFileSegment, bezier ) : sizeof(CurveFileSegment) );
+}
+
+/** Get size in bytes of one sample */
+inline size_t GetSampleSize( SampleFormat format )
+{
+    switch( format )
+    {
+        case SampleFormat::F32: return sizeof(float);
+        case SampleFormat::I16: return sizeof(int16_t);
+        default:                return sizeof(double);
+    }
+}
+
+/** Write baked values and their source parameters to a curve file, returns false on I/O failure */
+template<typename Iterator, typename ValueType>
+bool WriteCurveFile(
+    const std::string& path,
+    Iterator begin,
+    Iterator end,
+    double start_value,
+    double end_value,
+    TimeType frame_duration,
+    const MotionQueue<ValueType>& queue,
+    SampleFormat format = SampleFormat::F64 )
+{
+    CurveFileHeader header;
+    header.format = format;
+    header.segment_count = static_cast<uint32_t>( queue.size() );
+    header.sample_count = static_cast<uint64_t>( std::distance( begin, end ) );
+    header.frame_duration = frame_duration;
+    header.start_value = start_value;
+    header.end_value = end_value;
+
+    const size_t table_end = sizeof(CurveFileHeader) + queue.size() * sizeof(CurveFileSegment);
+    header.sample_offset = static_cast<uint32_t>( ( table_end + CacheLineSize - 1 ) / CacheLineSize * CacheLineSize );
+
+    // Quantization range covers every sample
+    if( format == SampleFormat::I16 && begin != end )
+    {
+        const auto range = std::minmax_element( begin, end );
+        const double low = static_cast<double>( *range.first );
+        const double high = static_cast<double>( *range.second );
+        header.quant_offset = ( low + high ) / 2;
+        header.quant_scale = ( high - low ) / ( 2.0 * INT16_MAX );
+    }
+
+    std::ofstream file( path, std::ios::binary | std::ios::trunc );
+    if( !file )
+    {
+        return false;
+    }
+
+    file.write( reinterpret_cast<const char*>( &header ), sizeof(header) );
+
+    for( const auto& param : queue )
+    {
+        CurveFileSegment segment;
+        segment.motion_type = static_cast<uint8_t>( param.motion_type );
+        segment.accel_type = static_cast<uint8_t>( param.accel_type );
+        segment.duration = param.duration;
+        segment.length = param.length;
+        segment.start_value = static_cast<double>( param.start_value );
+        segment.end_value = static_cast<double>( param.end_value );
+        segment.modifier = param.modifier;
+        segment.gravity = param.gravity;
+        segment.bezier = param.bezier;
+        file.write( reinterpret_cast<const char*>( &segment ), sizeof(segment) );
+    }
+
+    const std::vector<char> padding( header.sample_offset - table_end, 0 );
+    file.write( padding.data(), padding.size() );
+
+    // Samples are encoded in blocks to keep the write calls few
+    std::vector<char> block;
+    block.reserve( 4096 * GetSampleSize( format ) );
+    for( auto it = begin; it != end; ++it )
+    {
+        const double value = static_cast<double>( *it );
+        switch( format )
+        {
+            case SampleFormat::F32:
+            {
+                const float sample = static_cast<float>( value );
+                block.insert( block.end(), reinterpret_cast<const char*>( &sample ), reinterpret_cast<const char*>( &sample + 1 ) );
+            }
+            break;
+            case SampleFormat::I16:
+            {
+                const int16_t sample = ( header.quant_scale > 0 ? static_cast<int16_t>( std::lround( (value - header.quant_offset) / header.quant_scale ) ) : 0 );
+                block.insert( block.end(), reinterpret_cast<const char*>( &sample ), reinterpret_cast<const char*>( &sample + 1 ) );
+            }
+            break;
+            default:
+            {
+                block.insert( block.end(), reinterpret_cast<const char*>( &value ), reinterpret_cast<const char*>( &value + 1 ) );
+            }
+            break;
+        }
+
+        if( block.size() == block.capacity() )
+        {
+            file.write( block.data(), block.size() );
+            block.clear();
+        }
+    }
+    file.write( block.data(), block.size() );
+
+    return static_cast<bool>( file.flush() );
+}
+
+/** Read-only memory mapping of a curve file, samples are decoded in place */
+class MappedCurve
+{
+private:
+
+    /** Mapped file contents */
+    const uint8_t* data {};
+
+    /** Mapped size in bytes */
+    size_t size {};
+
+    /** Header at the start of the mapping */
+    const CurveFileHeader* header {};
+
+    /** First sample */
+    const uint8_t* samples {};
+
+    /** Constructor, see Open() */
+    MappedCurve( const uint8_t* data, size_t size )
+        : data( data )
+        , size( size )
+        , header( reinterpret_cast<const CurveFileHeader*>( data ) )
+        , samples( data + header->sample_offset )
+    {}
+
+public:
+
+    /** Destructor */
+    ~MappedCurve()
+    {
+        munmap( const_cast<uint8_t*>( data ), size );
+    }
+
+    MappedCurve( const MappedCurve& ) = delete;
+    MappedCurve& operator=( const MappedCurve& ) = delete;
+
+    /** Map a curve file, returns null if it can't be read or is not a valid curve file */
+    static std::shared_ptr<const MappedCurve> Open( const std::string& path )
+    {
+        const int fd = open( path.c_str(), O_RDONLY );
+        if( fd < 0 )
+        {
+            return nullptr;
+        }
+
+        struct stat info;
+        void* mapping = MAP_FAILED;
+        if( fstat( fd, &info ) == 0 && static_cast<size_t>( info.st_size ) >= sizeof(CurveFileHeader) )
+        {
+            mapping = mmap( nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        }
+        close( fd );
+
+        if( mapping == MAP_FAILED )
+        {
+            return nullptr;
+        }
+
+        const size_t size = static_cast<size_t>( info.st_size );
+        if( !IsValid( static_cast<const uint8_t*>( mapping ), size ) )
+        {
+            munmap( mapping, size );
+            return nullptr;
+        }
+
+        return std::shared_ptr<const MappedCurve>( new MappedCurve( static_cast<const uint8_t*>( mapping ), size ) );
+    }
+
+    /** Get file header */
+    inline const CurveFileHeader& GetHeader() const
+    {
+        return *header;
+    }
+
+    /** Get number of samples */
+    inline size_t GetSampleCount() const
+    {
+        return static_cast<size_t>( header->sample_count );
+    }
+
+    /** Get decoded sample */
+    inline double GetSample( size_t i ) const
+    {
+        switch( header->format )
+        {
+            case SampleFormat::F32: return reinterpret_cast<const float*>( samples )[i];
+            case SampleFormat::I16: return header->quant_offset + header->quant_scale * reinterpret_cast<const int16_t*>( samples )[i];
+            default:                return reinterpret_cast<const double*>( samples )[i];
+        }
+    }
+
+    /** Get raw samples, encoded as GetHeader().format */
+    inline const void* GetSamples() const
+    {
+        return samples;
+    }
+
+    /** Get source queue entry, Bezier points are left at their default in version 1 files */
+    inline CurveFileSegment GetSegment( uint32_t i ) const
+    {
+        const size_t segment_size = GetSegmentSize( header->version );
+        CurveFileSegment segment;
+        std::memcpy( &segment, data + sizeof(CurveFileHeader) + i * segment_size, segment_size );
+        return segment;
+    }
+
+    /** Rebuild the source queue */
+    template<typename ValueType>
+    MotionQueue<ValueType> GetQueue() const
+    {
+        MotionQueue<ValueType> queue;
+        for( uint32_t i = 0; i < header->segment_count; ++i )
+        {
+            const auto segment = GetSegment( i );
+            queue.push_back( { static_cast<Type>( segment.motion_type ), static_cast<Acceleration>( segment.accel_type ),
+                               segment.duration, segment.length,
+                               static_cast<ValueType>( segment.start_value ), static_cast<ValueType>( segment.end_value ),
+                               segment.modifier, segment.gravity, segment.bezier } );
+        }
+        return queue;
+    }
+
+private:
+
+    /** Check signature, version and that every table fits in the file */
+    static bool IsValid( const uint8_t* data, size_t size )
+    {
+        const auto* header = reinterpret_cast<const CurveFileHeader*>( data );
+        if( std::memcmp( header->magic, CurveFileHeader().magic, sizeof(header->magic) ) != 0
+         || header->version < CurveFileHeader::OldestVersion
+         || header->version > CurveFileHeader::CurrentVersion
+         || header->format > SampleFormat::I16
+         || header->sample_offset % CacheLineSize != 0 )
+        {
+            return false;
+        }
+
+        const uint64_t table_end = sizeof(CurveFileHeader) + uint64_t(header->segment_count) * GetSegmentSize( header->version );
+        return table_end <= header->sample_offset
+            && header->sample_offset <= size
+            && header->sample_count <= ( size - header->sample_offset ) / GetSampleSize( header->format );
+    }
+
+}; // class MappedCurve
+
+/** Shared mapped curve */
+using MappedCurvePtr = std::shared_ptr<const MappedCurve>;
+
+} // namespace Motion
+
+#endif /** MOTION_CURVE_FILE_H */
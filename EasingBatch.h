@@ -0,0 +1,568 @@
+/** --------------------------------------------------------
+ *
+ *                  EASING BATCH
+ *
+ * Vectorized evaluation of the normalized easing functions
+ *   over whole arrays of progress values, with SSE2, AVX2
+ *    and AVX-512 paths selected at runtime.
+ *
+ * The SIMD paths are only compiled by GCC on x86: they rely on
+ *   GCC target regions, which Clang doesn't extend to the
+ *    lambdas of the kernels. Other compilers, Clang included,
+ *     always take the portable scalar path ( see BatchSimdCompiled ).
+ *
+ * Results match EasingFunctions::GetFunctionValue with
+ *   from = 0 and to = 1 within BatchMaxUlp units in the
+ *    last place of max(|value|, 1), and the derivatives
+ *     match GetFunctionDerivatives within BatchDerivativeMaxUlp.
+ *
+ * BEZIER easing needs its curve, so it has its own overloads
+ *   taking a CubicBezier ( the Type overloads ease linearly ).
+ *
+-------------------------------------------------------- **/
+
+#ifndef EASING_BATCH_H
+#define EASING_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+#include "EasingFunctions.h"
+
+#if defined(__GNUC__) && !defined(__clang__) && ( defined(__x86_64__) || defined(__i386__) )
+#define MOTION_BATCH_X86
+#include <immintrin.h>
+#endif
+
+namespace Motion
+{
+
+/** Whether the SIMD paths are compiled in ( GCC on x86 only, otherwise every path but SCALAR is unsupported ) */
+#ifdef MOTION_BATCH_X86
+constexpr bool BatchSimdCompiled = true;
+#else
+constexpr bool BatchSimdCompiled = false;
+#endif
+
+/** Maximum error of the batch kernels, in units of the last place of max(|value|, 1) */
+constexpr double BatchMaxUlp = 4.0;
+
+/** Maximum error of the batch derivative kernels, in units of the last place of max(|peak|, 1), peak being the largest
+ *  magnitude of the derivative over the easing ( the terms of the elastic and bounce derivatives cancel near their zeros,
+ *  so the error there is absolute to the scale of the curve, not to the value ) */
+constexpr double BatchDerivativeMaxUlp = 16.0;
+
+/** Instruction set used by the batch kernels */
+enum class BatchPath : uint8_t
+{
+    SCALAR,     // Portable fallback, one value per step
+    SSE2,       // 2 values per step
+    AVX2,       // 4 values per step ( with FMA )
+    AVX512,     // 8 values per step
+};
+
+namespace Batch
+{
+
+/** Bit pattern of 2^52 + 2^51, used for rounding and exponent manipulation */
+constexpr uint64_t RoundMagicBits = 0x4338000000000000ull;
+constexpr double RoundMagic = 6755399441055744.0;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+/** Portable lane of a single value */
+struct ScalarLane
+{
+    using V = double;
+    using M = bool;
+
+    static constexpr size_t Width = 1;
+
+    static inline V Set( double a )                     { return a; }
+    static inline V Load( const double* p )             { return *p; }
+    static inline void Store( double* p, V a )          { *p = a; }
+    static inline V Add( V a, V b )                     { return a + b; }
+    static inline V Sub( V a, V b )                     { return a - b; }
+    static inline V Mul( V a, V b )                     { return a * b; }
+    static inline V Div( V a, V b )                     { return a / b; }
+    static inline V MulAdd( V a, V b, V c )             { return a * b + c; }
+    static inline V Sqrt( V a )                         { return std::sqrt( a ); }
+    static inline V Abs( V a )                          { return std::fabs( a ); }
+    static inline V Min( V a, V b )                     { return b < a ? b : a; }
+    static inline V Max( V a, V b )                     { return b > a ? b : a; }
+    static inline M Less( V a, V b )                    { return a < b; }
+    static inline M LessEqual( V a, V b )               { return a <= b; }
+    static inline M Equal( V a, V b )                   { return a == b; }
+    static inline V Select( M m, V a, V b )             { return m ? a : b; }
+
+    /** Round to nearest integer ( |a| < 2^51 ) */
+    static inline V Round( V a )
+    {
+        return std::nearbyint( a );
+    }
+
+    /** 2^k for integral k in [-1022, 1023] */
+    static inline V Pow2( V k )
+    {
+        uint64_t bits = static_cast<uint64_t>( static_cast<int64_t>( k ) + 1023 ) << 52;
+        double r;
+        std::memcpy( &r, &bits, sizeof(r) );
+        return r;
+    }
+
+    /** Unbiased binary exponent as a double */
+    static inline V Exponent( V a )
+    {
+        uint64_t bits;
+        std::memcpy( &bits, &a, sizeof(bits) );
+        return static_cast<double>( static_cast<int64_t>( (bits >> 52) & 0x7ff ) - 1023 );
+    }
+
+    /** Significand scaled into [1, 2) */
+    static inline V Mantissa( V a )
+    {
+        uint64_t bits;
+        std::memcpy( &bits, &a, sizeof(bits) );
+        bits = (bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull;
+        double r;
+        std::memcpy( &r, &bits, sizeof(r) );
+        return r;
+    }
+};
+
+namespace Scalar
+{
+    using Lane = ScalarLane;
+    #include "EasingBatchKernel.inl"
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef MOTION_BATCH_X86
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+
+namespace Sse2
+{
+    /** SSE2 lane of two values */
+    struct Lane
+    {
+        using V = __m128d;
+        using M = __m128d;
+
+        static constexpr size_t Width = 2;
+
+        static inline V Set( double a )                 { return _mm_set1_pd( a ); }
+        static inline V Load( const double* p )         { return _mm_loadu_pd( p ); }
+        static inline void Store( double* p, V a )      { _mm_storeu_pd( p, a ); }
+        static inline V Add( V a, V b )                 { return _mm_add_pd( a, b ); }
+        static inline V Sub( V a, V b )                 { return _mm_sub_pd( a, b ); }
+        static inline V Mul( V a, V b )                 { return _mm_mul_pd( a, b ); }
+        static inline V Div( V a, V b )                 { return _mm_div_pd( a, b ); }
+        static inline V MulAdd( V a, V b, V c )         { return _mm_add_pd( _mm_mul_pd( a, b ), c ); }
+        static inline V Sqrt( V a )                     { return _mm_sqrt_pd( a ); }
+        static inline V Abs( V a )                      { return _mm_andnot_pd( _mm_set1_pd( -0.0 ), a ); }
+        static inline V Min( V a, V b )                 { return _mm_min_pd( a, b ); }
+        static inline V Max( V a, V b )                 { return _mm_max_pd( a, b ); }
+        static inline M Less( V a, V b )                { return _mm_cmplt_pd( a, b ); }
+        static inline M LessEqual( V a, V b )           { return _mm_cmple_pd( a, b ); }
+        static inline M Equal( V a, V b )               { return _mm_cmpeq_pd( a, b ); }
+        static inline V Select( M m, V a, V b )         { return _mm_or_pd( _mm_and_pd( m, a ), _mm_andnot_pd( m, b ) ); }
+
+        static inline V Round( V a )
+        {
+            const auto magic = _mm_set1_pd( RoundMagic );
+            return _mm_sub_pd( _mm_add_pd( a, magic ), magic );
+        }
+
+        static inline V Pow2( V k )
+        {
+            const auto bits = _mm_castpd_si128( _mm_add_pd( k, _mm_set1_pd( RoundMagic ) ) );
+            const auto biased = _mm_add_epi64( bits, _mm_set1_epi64x( 1023 - static_cast<int64_t>(RoundMagicBits) ) );
+            return _mm_castsi128_pd( _mm_slli_epi64( biased, 52 ) );
+        }
+
+        static inline V Exponent( V a )
+        {
+            const auto e = _mm_srli_epi64( _mm_slli_epi64( _mm_castpd_si128( a ), 1 ), 53 );
+            const auto two52 = _mm_set1_pd( 4503599627370496.0 );
+            const auto d = _mm_sub_pd( _mm_castsi128_pd( _mm_or_si128( e, _mm_castpd_si128( two52 ) ) ), two52 );
+            return _mm_sub_pd( d, _mm_set1_pd( 1023.0 ) );
+        }
+
+        static inline V Mantissa( V a )
+        {
+            const auto bits = _mm_and_si128( _mm_castpd_si128( a ), _mm_set1_epi64x( 0x000fffffffffffffll ) );
+            return _mm_castsi128_pd( _mm_or_si128( bits, _mm_set1_epi64x( 0x3ff0000000000000ll ) ) );
+        }
+    };
+
+    #include "EasingBatchKernel.inl"
+}
+
+#pragma GCC pop_options
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#pragma GCC optimize("fp-contract=off")   // FMA only where MulAdd asks for it
+
+namespace Avx2
+{
+    /** AVX2 lane of four values */
+    struct Lane
+    {
+        using V = __m256d;
+        using M = __m256d;
+
+        static constexpr size_t Width = 4;
+
+        static inline V Set( double a )                 { return _mm256_set1_pd( a ); }
+        static inline V Load( const double* p )         { return _mm256_loadu_pd( p ); }
+        static inline void Store( double* p, V a )      { _mm256_storeu_pd( p, a ); }
+        static inline V Add( V a, V b )                 { return _mm256_add_pd( a, b ); }
+        static inline V Sub( V a, V b )                 { return _mm256_sub_pd( a, b ); }
+        static inline V Mul( V a, V b )                 { return _mm256_mul_pd( a, b ); }
+        static inline V Div( V a, V b )                 { return _mm256_div_pd( a, b ); }
+        static inline V MulAdd( V a, V b, V c )         { return _mm256_fmadd_pd( a, b, c ); }
+        static inline V Sqrt( V a )                     { return _mm256_sqrt_pd( a ); }
+        static inline V Abs( V a )                      { return _mm256_andnot_pd( _mm256_set1_pd( -0.0 ), a ); }
+        static inline V Min( V a, V b )                 { return _mm256_min_pd( a, b ); }
+        static inline V Max( V a, V b )                 { return _mm256_max_pd( a, b ); }
+        static inline M Less( V a, V b )                { return _mm256_cmp_pd( a, b, _CMP_LT_OQ ); }
+        static inline M LessEqual( V a, V b )           { return _mm256_cmp_pd( a, b, _CMP_LE_OQ ); }
+        static inline M Equal( V a, V b )               { return _mm256_cmp_pd( a, b, _CMP_EQ_OQ ); }
+        static inline V Select( M m, V a, V b )         { return _mm256_blendv_pd( b, a, m ); }
+
+        static inline V Round( V a )
+        {
+            return _mm256_round_pd( a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+        }
+
+        static inline V Pow2( V k )
+        {
+            const auto bits = _mm256_castpd_si256( _mm256_add_pd( k, _mm256_set1_pd( RoundMagic ) ) );
+            const auto biased = _mm256_add_epi64( bits, _mm256_set1_epi64x( 1023 - static_cast<int64_t>(RoundMagicBits) ) );
+            return _mm256_castsi256_pd( _mm256_slli_epi64( biased, 52 ) );
+        }
+
+        static inline V Exponent( V a )
+        {
+            const auto e = _mm256_srli_epi64( _mm256_slli_epi64( _mm256_castpd_si256( a ), 1 ), 53 );
+            const auto two52 = _mm256_set1_pd( 4503599627370496.0 );
+            const auto d = _mm256_sub_pd( _mm256_castsi256_pd( _mm256_or_si256( e, _mm256_castpd_si256( two52 ) ) ), two52 );
+            return _mm256_sub_pd( d, _mm256_set1_pd( 1023.0 ) );
+        }
+
+        static inline V Mantissa( V a )
+        {
+            const auto bits = _mm256_and_si256( _mm256_castpd_si256( a ), _mm256_set1_epi64x( 0x000fffffffffffffll ) );
+            return _mm256_castsi256_pd( _mm256_or_si256( bits, _mm256_set1_epi64x( 0x3ff0000000000000ll ) ) );
+        }
+    };
+
+    #include "EasingBatchKernel.inl"
+}
+
+#pragma GCC pop_options
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#pragma GCC optimize("fp-contract=off")   // as above
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"   // GCC 12 false positive in avx512fintrin.h
+#pragma GCC diagnostic ignored "-Wuninitialized"         // same, once inlined into the derivative kernels
+
+namespace Avx512
+{
+    /** AVX-512 lane of eight values */
+    struct Lane
+    {
+        using V = __m512d;
+        using M = __mmask8;
+
+        static constexpr size_t Width = 8;
+
+        static inline V Set( double a )                 { return _mm512_set1_pd( a ); }
+        static inline V Load( const double* p )         { return _mm512_loadu_pd( p ); }
+        static inline void Store( double* p, V a )      { _mm512_storeu_pd( p, a ); }
+        static inline V Add( V a, V b )                 { return _mm512_add_pd( a, b ); }
+        static inline V Sub( V a, V b )                 { return _mm512_sub_pd( a, b ); }
+        static inline V Mul( V a, V b )                 { return _mm512_mul_pd( a, b ); }
+        static inline V Div( V a, V b )                 { return _mm512_div_pd( a, b ); }
+        static inline V MulAdd( V a, V b, V c )         { return _mm512_fmadd_pd( a, b, c ); }
+        static inline V Sqrt( V a )                     { return _mm512_sqrt_pd( a ); }
+        static inline V Abs( V a )                      { return _mm512_abs_pd( a ); }
+        static inline V Min( V a, V b )                 { return _mm512_min_pd( a, b ); }
+        static inline V Max( V a, V b )                 { return _mm512_max_pd( a, b ); }
+        static inline M Less( V a, V b )                { return _mm512_cmp_pd_mask( a, b, _CMP_LT_OQ ); }
+        static inline M LessEqual( V a, V b )           { return _mm512_cmp_pd_mask( a, b, _CMP_LE_OQ ); }
+        static inline M Equal( V a, V b )               { return _mm512_cmp_pd_mask( a, b, _CMP_EQ_OQ ); }
+        static inline V Select( M m, V a, V b )         { return _mm512_mask_blend_pd( m, b, a ); }
+
+        static inline V Round( V a )
+        {
+            return _mm512_roundscale_pd( a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+        }
+
+        static inline V Pow2( V k )
+        {
+            const auto bits = _mm512_castpd_si512( _mm512_add_pd( k, _mm512_set1_pd( RoundMagic ) ) );
+            const auto biased = _mm512_add_epi64( bits, _mm512_set1_epi64( 1023 - static_cast<int64_t>(RoundMagicBits) ) );
+            return _mm512_castsi512_pd( _mm512_slli_epi64( biased, 52 ) );
+        }
+
+        static inline V Exponent( V a )
+        {
+            return _mm512_getexp_pd( a );
+        }
+
+        static inline V Mantissa( V a )
+        {
+            return _mm512_getmant_pd( a, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero );
+        }
+    };
+
+    #include "EasingBatchKernel.inl"
+}
+
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+
+#endif // MOTION_BATCH_X86
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+/** Batch kernel signature */
+using BatchKernel = void (*)( Type, Acceleration, const double*, double*, size_t, double, double );
+
+/** Get kernel of an instruction set ( nullptr if not compiled in ) */
+inline BatchKernel GetKernel( BatchPath path )
+{
+    switch( path )
+    {
+#ifdef MOTION_BATCH_X86
+        case BatchPath::SSE2:   return &Sse2::EvaluateBatch;
+        case BatchPath::AVX2:   return &Avx2::EvaluateBatch;
+        case BatchPath::AVX512: return &Avx512::EvaluateBatch;
+#endif
+        case BatchPath::SCALAR: return &Scalar::EvaluateBatch;
+        default:                return nullptr;
+    }
+}
+
+/** Batch derivative kernel signature */
+using BatchDerivativeKernel = void (*)( Type, Acceleration, const double*, double*, double*, size_t, double, double );
+
+/** Get derivative kernel of an instruction set ( nullptr if not compiled in ) */
+inline BatchDerivativeKernel GetDerivativeKernel( BatchPath path )
+{
+    switch( path )
+    {
+#ifdef MOTION_BATCH_X86
+        case BatchPath::SSE2:   return &Sse2::EvaluateBatchDerivatives;
+        case BatchPath::AVX2:   return &Avx2::EvaluateBatchDerivatives;
+        case BatchPath::AVX512: return &Avx512::EvaluateBatchDerivatives;
+#endif
+        case BatchPath::SCALAR: return &Scalar::EvaluateBatchDerivatives;
+        default:                return nullptr;
+    }
+}
+
+/** Batch bezier kernel signature */
+using BatchBezierKernel = void (*)( const CubicBezier&, Acceleration, const double*, double*, size_t );
+
+/** Get bezier kernel of an instruction set ( nullptr if not compiled in ) */
+inline BatchBezierKernel GetBezierKernel( BatchPath path )
+{
+    switch( path )
+    {
+#ifdef MOTION_BATCH_X86
+        case BatchPath::SSE2:   return &Sse2::EvaluateBatch;
+        case BatchPath::AVX2:   return &Avx2::EvaluateBatch;
+        case BatchPath::AVX512: return &Avx512::EvaluateBatch;
+#endif
+        case BatchPath::SCALAR: return &Scalar::EvaluateBatch;
+        default:                return nullptr;
+    }
+}
+
+/** Batch bezier derivative kernel signature */
+using BatchBezierDerivativeKernel = void (*)( const CubicBezier&, Acceleration, const double*, double*, double*, size_t );
+
+/** Get bezier derivative kernel of an instruction set ( nullptr if not compiled in ) */
+inline BatchBezierDerivativeKernel GetBezierDerivativeKernel( BatchPath path )
+{
+    switch( path )
+    {
+#ifdef MOTION_BATCH_X86
+        case BatchPath::SSE2:   return &Sse2::EvaluateBatchDerivatives;
+        case BatchPath::AVX2:   return &Avx2::EvaluateBatchDerivatives;
+        case BatchPath::AVX512: return &Avx512::EvaluateBatchDerivatives;
+#endif
+        case BatchPath::SCALAR: return &Scalar::EvaluateBatchDerivatives;
+        default:                return nullptr;
+    }
+}
+
+} // namespace Batch
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+/** Check if the CPU can run an instruction set */
+inline bool IsBatchPathSupported( BatchPath path )
+{
+#ifdef MOTION_BATCH_X86
+    __builtin_cpu_init();
+    switch( path )
+    {
+        case BatchPath::SSE2:   return __builtin_cpu_supports( "sse2" );
+        case BatchPath::AVX2:   return __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" );
+        case BatchPath::AVX512: return __builtin_cpu_supports( "avx512f" );
+        default:                return true;
+    }
+#else
+    return path == BatchPath::SCALAR;
+#endif
+}
+
+/** Get the widest instruction set supported by the CPU */
+inline BatchPath GetBatchPath()
+{
+    static const BatchPath path = []
+    {
+        for( auto p : { BatchPath::AVX512, BatchPath::AVX2, BatchPath::SSE2 } )
+        {
+            if( IsBatchPathSupported( p ) )
+            {
+                return p;
+            }
+        }
+        return BatchPath::SCALAR;
+    }();
+
+    return path;
+}
+
+/** Evaluate normalized easing function over an array of progress values, using a given instruction set */
+inline void EvaluateBatch( BatchPath path,
+                           Type type,
+                           Acceleration accel,
+                           const double* progress,
+                           double* out,
+                           size_t n,
+                           double modifier = 6.0,
+                           double gravity = 6.0 )
+{
+    Batch::GetKernel( path )( type, accel, progress, out, n, modifier, gravity );
+}
+
+/** Evaluate normalized easing function over an array of progress values */
+inline void EvaluateBatch( Type type,
+                           Acceleration accel,
+                           const double* progress,
+                           double* out,
+                           size_t n,
+                           double modifier = 6.0,
+                           double gravity = 6.0 )
+{
+    static const Batch::BatchKernel kernel = Batch::GetKernel( GetBatchPath() );
+    kernel( type, accel, progress, out, n, modifier, gravity );
+}
+
+/** Evaluate first and second derivatives of the normalized easing function over an array of progress values, using a given instruction set */
+inline void EvaluateBatchDerivatives( BatchPath path,
+                                      Type type,
+                                      Acceleration accel,
+                                      const double* progress,
+                                      double* first,
+                                      double* second,
+                                      size_t n,
+                                      double modifier = 6.0,
+                                      double gravity = 6.0 )
+{
+    Batch::GetDerivativeKernel( path )( type, accel, progress, first, second, n, modifier, gravity );
+}
+
+/** Evaluate first and second derivatives of the normalized easing function over an array of progress values */
+inline void EvaluateBatchDerivatives( Type type,
+                                      Acceleration accel,
+                                      const double* progress,
+                                      double* first,
+                                      double* second,
+                                      size_t n,
+                                      double modifier = 6.0,
+                                      double gravity = 6.0 )
+{
+    static const Batch::BatchDerivativeKernel kernel = Batch::GetDerivativeKernel( GetBatchPath() );
+    kernel( type, accel, progress, first, second, n, modifier, gravity );
+}
+
+/** Evaluate bezier easing over an array of progress values, using a given instruction set */
+inline void EvaluateBatch( BatchPath path,
+                           const CubicBezier& curve,
+                           Acceleration accel,
+                           const double* progress,
+                           double* out,
+                           size_t n )
+{
+    Batch::GetBezierKernel( path )( curve, accel, progress, out, n );
+}
+
+/** Evaluate bezier easing over an array of progress values */
+inline void EvaluateBatch( const CubicBezier& curve,
+                           Acceleration accel,
+                           const double* progress,
+                           double* out,
+                           size_t n )
+{
+    static const Batch::BatchBezierKernel kernel = Batch::GetBezierKernel( GetBatchPath() );
+    kernel( curve, accel, progress, out, n );
+}
+
+/** Evaluate first and second derivatives of bezier easing over an array of progress values, using a given instruction set */
+inline void EvaluateBatchDerivatives( BatchPath path,
+                                      const CubicBezier& curve,
+                                      Acceleration accel,
+                                      const double* progress,
+                                      double* first,
+                                      double* second,
+                                      size_t n )
+{
+    Batch::GetBezierDerivativeKernel( path )( curve, accel, progress, first, second, n );
+}
+
+/** Evaluate first and second derivatives of bezier easing over an array of progress values */
+inline void EvaluateBatchDerivatives( const CubicBezier& curve,
+                                      Acceleration accel,
+                                      const double* progress,
+                                      double* first,
+                                      double* second,
+                                      size_t n )
+{
+    static const Batch::BatchBezierDerivativeKernel kernel = Batch::GetBezierDerivativeKernel( GetBatchPath() );
+    kernel( curve, accel, progress, first, second, n );
+}
+
+} // namespace Motion
+
+#endif /** EASING_BATCH_H */
@@ -0,0 +1,617 @@
+/** --------------------------------------------------------
+ *
+ *               EASING BATCH KERNEL
+ *
+ * Kernel body shared by every instruction set. Included
+ *   once per instruction set by EasingBatch.h, inside a
+ *    namespace that defines the matching Lane type.
+ *
+ * No include guard on purpose.
+ *
+-------------------------------------------------------- **/
+
+using V = Lane::V;
+
+
+/** Vector math */
+
+
+/** Exponential ( about 1 ULP, flushes to zero below e^-708 ) */
+inline V Exp( V x )
+{
+    const auto clamped = Lane::Min( Lane::Set( 709.0 ), Lane::Max( Lane::Set( -708.0 ), x ) );
+
+    // Reduce to r in [-ln2/2, ln2/2], x = k*ln2 + r
+    const auto k = Lane::Round( Lane::Mul( clamped, Lane::Set( 1.44269504088896338700e+00 ) ) );
+    auto r = Lane::MulAdd( k, Lane::Set( -6.93147180369123816490e-01 ), clamped );
+    r = Lane::MulAdd( k, Lane::Set( -1.90821492927058770002e-10 ), r );
+
+    // Taylor series up to r^13
+    auto p = Lane::Set( 1.0/6227020800.0 );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0/479001600.0 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0/39916800.0 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0/3628800.0 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0/362880.0 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0/40320.0 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0/5040.0 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0/720.0 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0/120.0 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0/24.0 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0/6.0 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 0.5 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0 ) );
+    p = Lane::MulAdd( p, r, Lane::Set( 1.0 ) );
+
+    auto result = Lane::Mul( p, Lane::Pow2( k ) );
+    result = Lane::Select( Lane::Less( x, Lane::Set( -708.39 ) ), Lane::Set( 0.0 ), result );
+    result = Lane::Select( Lane::Less( Lane::Set( 709.78 ), x ), Lane::Set( std::numeric_limits<double>::infinity() ), result );
+    return result;
+}
+
+/** Natural logarithm ( about 1 ULP for normal numbers ) */
+inline V Log( V x )
+{
+    const auto sqrt2 = Lane::Set( 1.41421356237309504880 );
+
+    // Split into m * 2^e with m in [sqrt(2)/2, sqrt(2)]
+    auto e = Lane::Exponent( x );
+    auto m = Lane::Mantissa( x );
+    const auto big = Lane::Less( sqrt2, m );
+    m = Lane::Select( big, Lane::Mul( m, Lane::Set( 0.5 ) ), m );
+    e = Lane::Select( big, Lane::Add( e, Lane::Set( 1.0 ) ), e );
+
+    // log(1+f) = f - f^2/2 + s*(f^2/2 + R(s^2)), s = f/(2+f)
+    const auto f = Lane::Sub( m, Lane::Set( 1.0 ) );
+    const auto s = Lane::Div( f, Lane::Add( f, Lane::Set( 2.0 ) ) );
+    const auto z = Lane::Mul( s, s );
+    const auto w = Lane::Mul( z, z );
+    auto t1 = Lane::MulAdd( w, Lane::Set( 1.531383769920937332e-01 ), Lane::Set( 2.222219843214978396e-01 ) );
+    t1 = Lane::Mul( w, Lane::MulAdd( w, t1, Lane::Set( 3.999999999940941908e-01 ) ) );
+    auto t2 = Lane::MulAdd( w, Lane::Set( 1.479819860511658591e-01 ), Lane::Set( 1.818357216161805012e-01 ) );
+    t2 = Lane::MulAdd( w, t2, Lane::Set( 2.857142874366239149e-01 ) );
+    t2 = Lane::Mul( z, Lane::MulAdd( w, t2, Lane::Set( 6.666666666666735130e-01 ) ) );
+    const auto R = Lane::Add( t1, t2 );
+    const auto hfsq = Lane::Mul( Lane::Set( 0.5 ), Lane::Mul( f, f ) );
+
+    auto result = Lane::MulAdd( e, Lane::Set( 1.90821492927058770002e-10 ), Lane::Mul( s, Lane::Add( hfsq, R ) ) );
+    result = Lane::Sub( Lane::Sub( hfsq, result ), f );
+    result = Lane::MulAdd( e, Lane::Set( 6.93147180369123816490e-01 ), Lane::Sub( Lane::Set( 0.0 ), result ) );
+
+    // Special values
+    const auto inf = std::numeric_limits<double>::infinity();
+    result = Lane::Select( Lane::Equal( x, Lane::Set( 0.0 ) ), Lane::Set( -inf ), result );
+    result = Lane::Select( Lane::Less( x, Lane::Set( 0.0 ) ), Lane::Set( std::numeric_limits<double>::quiet_NaN() ), result );
+    result = Lane::Select( Lane::Equal( x, Lane::Set( inf ) ), x, result );
+    result = Lane::Select( Lane::Equal( x, x ), result, x );
+    return result;
+}
+
+/** Sine ( about 1 ULP for |x| < 2^20 ) */
+inline V Sin( V x )
+{
+    // Reduce to r in [-pi/4, pi/4], x = k*pi/2 + r
+    const auto k = Lane::Round( Lane::Mul( x, Lane::Set( 6.36619772367581382433e-01 ) ) );
+    auto r = Lane::MulAdd( k, Lane::Set( -1.57079632673412561417e+00 ), x );
+    r = Lane::MulAdd( k, Lane::Set( -6.07710050630396597660e-11 ), r );
+    r = Lane::MulAdd( k, Lane::Set( -2.02226624871116645580e-21 ), r );
+
+    const auto z = Lane::Mul( r, r );
+
+    // Sine polynomial
+    auto ps = Lane::MulAdd( z, Lane::Set( 1.58969099521155010221e-10 ), Lane::Set( -2.50507602534068634195e-08 ) );
+    ps = Lane::MulAdd( z, ps, Lane::Set( 2.75573137070700676789e-06 ) );
+    ps = Lane::MulAdd( z, ps, Lane::Set( -1.98412698298579493134e-04 ) );
+    ps = Lane::MulAdd( z, ps, Lane::Set( 8.33333333332248946124e-03 ) );
+    ps = Lane::MulAdd( z, ps, Lane::Set( -1.66666666666666324348e-01 ) );
+    const auto sine = Lane::MulAdd( Lane::Mul( z, r ), ps, r );
+
+    // Cosine polynomial
+    auto pc = Lane::MulAdd( z, Lane::Set( -1.13596475577881948265e-11 ), Lane::Set( 2.08757232129817482790e-09 ) );
+    pc = Lane::MulAdd( z, pc, Lane::Set( -2.75573143513906633035e-07 ) );
+    pc = Lane::MulAdd( z, pc, Lane::Set( 2.48015872894767294178e-05 ) );
+    pc = Lane::MulAdd( z, pc, Lane::Set( -1.38888888888741095749e-03 ) );
+    pc = Lane::MulAdd( z, pc, Lane::Set( 4.16666666666666019037e-02 ) );
+    const auto hz = Lane::Mul( Lane::Set( 0.5 ), z );
+    const auto w = Lane::Sub( Lane::Set( 1.0 ), hz );
+    const auto cosine = Lane::Add( w, Lane::MulAdd( Lane::Mul( z, z ), pc, Lane::Sub( Lane::Sub( Lane::Set( 1.0 ), w ), hz ) ) );
+
+    // Quadrant q = k mod 4
+    const auto quarter = Lane::Mul( k, Lane::Set( 0.25 ) );
+    auto fl = Lane::Round( quarter );
+    fl = Lane::Select( Lane::Less( quarter, fl ), Lane::Sub( fl, Lane::Set( 1.0 ) ), fl );
+    const auto q = Lane::MulAdd( fl, Lane::Set( -4.0 ), k );
+
+    auto result = Lane::Select( Lane::Equal( Lane::Abs( Lane::Sub( q, Lane::Set( 2.0 ) ) ), Lane::Set( 1.0 ) ), cosine, sine );
+    result = Lane::Select( Lane::LessEqual( Lane::Set( 2.0 ), q ), Lane::Sub( Lane::Set( 0.0 ), result ), result );
+    return result;
+}
+
+/** Power with an integral exponent */
+inline V PowInt( V x, int power )
+{
+    auto result = Lane::Set( 1.0 );
+    auto base = x;
+    for( unsigned e = static_cast<unsigned>( power < 0 ? -power : power ); e != 0; e >>= 1 )
+    {
+        if( e & 1 )
+        {
+            result = Lane::Mul( result, base );
+        }
+        base = Lane::Mul( base, base );
+    }
+
+    return power < 0 ? Lane::Div( Lane::Set( 1.0 ), result ) : result;
+}
+
+/** Power with an arbitrary exponent ( x >= 0 ) */
+inline V Pow( V x, double power )
+{
+    return Exp( Lane::Mul( Lane::Set( power ), Log( x ) ) );
+}
+
+
+/** Easing functions */
+
+
+/** Sinusoidal: 1 + sin(x*pi/2 - pi/2) */
+inline V Sine( V x )
+{
+    const auto h_pi = Lane::Set( M_PI*0.5 );
+    return Lane::Add( Lane::Set( 1.0 ), Sin( Lane::Sub( Lane::Mul( h_pi, x ), h_pi ) ) );
+}
+
+/** Back: x^3 - x*sin(x*pi) */
+inline V Back( V x )
+{
+    const auto cube = Lane::Mul( Lane::Mul( x, x ), x );
+    return Lane::Sub( cube, Lane::Mul( x, Sin( Lane::Mul( x, Lane::Set( M_PI ) ) ) ) );
+}
+
+/** Circular: 1 - sqrt((2 - inv) * inv), inv = 1 - x */
+inline V Circular( V x )
+{
+    const auto inv = Lane::Sub( Lane::Set( 1.0 ), x );
+    return Lane::Sub( Lane::Set( 1.0 ), Lane::Sqrt( Lane::Mul( Lane::Sub( Lane::Set( 2.0 ), inv ), inv ) ) );
+}
+
+/** Elastic: e^((x-1)*gravity) * sin(arg)/arg, arg = wobbles*pi*(1 - x) */
+inline V Elastic( V x, double wobbles, double gravity )
+{
+    const auto arg = Lane::Mul( Lane::Set( wobbles * M_PI ), Lane::Sub( Lane::Set( 1.0 ), x ) );
+    const auto decay = Exp( Lane::Mul( Lane::Sub( x, Lane::Set( 1.0 ) ), Lane::Set( gravity ) ) );
+    return Lane::Div( Lane::Mul( decay, Sin( arg ) ), arg );
+}
+
+/** Exponential: e^((x-1)*steepness) */
+inline V Exponential( V x, double steepness )
+{
+    return Exp( Lane::Mul( Lane::Sub( x, Lane::Set( 1.0 ) ), Lane::Set( steepness ) ) );
+}
+
+
+/** Easing derivatives */
+
+
+/** First and second derivatives of a lane */
+struct Rates
+{
+    V first;
+    V second;
+};
+
+/** Cosine */
+inline V Cos( V x )
+{
+    return Sin( Lane::Add( x, Lane::Set( M_PI*0.5 ) ) );
+}
+
+/** Power with an integral exponent: p*x^(p-1), p*(p-1)*x^(p-2) */
+inline Rates PowIntRates( V x, int power )
+{
+    const auto first = ( power == 0 ? Lane::Set( 0.0 ) : Lane::Mul( Lane::Set( power ), PowInt( x, power - 1 ) ) );
+    const auto second = ( power == 0 || power == 1 ? Lane::Set( 0.0 ) : Lane::Mul( Lane::Set( double(power) * (power - 1) ), PowInt( x, power - 2 ) ) );
+    return { first, second };
+}
+
+/** Power with an arbitrary exponent ( not integral ) */
+inline Rates PowRates( V x, double power )
+{
+    return { Lane::Mul( Lane::Set( power ), Pow( x, power - 1 ) ), Lane::Mul( Lane::Set( power * (power - 1) ), Pow( x, power - 2 ) ) };
+}
+
+/** Sinusoidal: h*sin(h*x), h^2*cos(h*x), h = pi/2 */
+inline Rates SineRates( V x )
+{
+    const auto h_pi = Lane::Set( M_PI*0.5 );
+    const auto arg = Lane::Mul( h_pi, x );
+    return { Lane::Mul( h_pi, Sin( arg ) ), Lane::Mul( Lane::Set( M_PI*M_PI*0.25 ), Cos( arg ) ) };
+}
+
+/** Back: 3x^2 - sin(pi*x) - pi*x*cos(pi*x), 6x - 2pi*cos(pi*x) + pi^2*x*sin(pi*x) */
+inline Rates BackRates( V x )
+{
+    const auto arg = Lane::Mul( x, Lane::Set( M_PI ) );
+    const auto s = Sin( arg );
+    const auto c = Cos( arg );
+    const auto first = Lane::Sub( Lane::Sub( Lane::Mul( Lane::Set( 3.0 ), Lane::Mul( x, x ) ), s ), Lane::Mul( arg, c ) );
+    const auto second = Lane::MulAdd( Lane::Mul( Lane::Set( M_PI ), arg ), s, Lane::Sub( Lane::Mul( Lane::Set( 6.0 ), x ), Lane::Mul( Lane::Set( 2*M_PI ), c ) ) );
+    return { first, second };
+}
+
+/** Circular: x/sqrt(u), 1/(u*sqrt(u)), u = (2 - inv) * inv */
+inline Rates CircularRates( V x )
+{
+    const auto inv = Lane::Sub( Lane::Set( 1.0 ), x );
+    const auto u = Lane::Mul( Lane::Sub( Lane::Set( 2.0 ), inv ), inv );
+    const auto root = Lane::Sqrt( u );
+    return { Lane::Div( x, root ), Lane::Div( Lane::Set( 1.0 ), Lane::Mul( u, root ) ) };
+}
+
+/** Elastic: derivatives of e^((x-1)*gravity) * sinc(arg), sinc goes through its series near 0 ( sign receives the sign of the value ) */
+inline Rates ElasticRates( V x, double wobbles, double gravity, V& sign )
+{
+    const auto k = wobbles * M_PI;
+    const auto arg = Lane::Mul( Lane::Set( k ), Lane::Sub( Lane::Set( 1.0 ), x ) );
+    const auto decay = Exp( Lane::Mul( Lane::Sub( x, Lane::Set( 1.0 ) ), Lane::Set( gravity ) ) );
+
+    // Closed form
+    const auto s = Sin( arg );
+    const auto c = Cos( arg );
+    const auto a2 = Lane::Mul( arg, arg );
+    auto sinc = Lane::Div( s, arg );
+    auto sinc1 = Lane::Div( Lane::Sub( Lane::Mul( arg, c ), s ), a2 );
+    auto sinc2 = Lane::Div( Lane::Sub( Lane::Sub( Lane::Mul( Lane::Set( 2.0 ), s ), Lane::Mul( Lane::Set( 2.0 ), Lane::Mul( arg, c ) ) ), Lane::Mul( a2, s ) ),
+                            Lane::Mul( a2, arg ) );
+
+    // Series
+    const auto series = [&]( const double (&coefficients)[EasingDerivative::SincTerms] )
+    {
+        auto sum = Lane::Set( coefficients[EasingDerivative::SincTerms-1] );
+        for( size_t i = EasingDerivative::SincTerms-1; i-- > 0; )
+        {
+            sum = Lane::MulAdd( sum, a2, Lane::Set( coefficients[i] ) );
+        }
+        return sum;
+    };
+
+    const auto near = Lane::Less( Lane::Abs( arg ), Lane::Set( EasingDerivative::SincSeriesBound ) );
+    sinc = Lane::Select( near, series( EasingDerivative::SincSeries ), sinc );
+    sinc1 = Lane::Select( near, Lane::Mul( arg, series( EasingDerivative::SincFirstSeries ) ), sinc1 );
+    sinc2 = Lane::Select( near, series( EasingDerivative::SincSecondSeries ), sinc2 );
+    sign = Lane::Select( Lane::Less( Lane::Mul( decay, sinc ), Lane::Set( 0.0 ) ), Lane::Set( -1.0 ), Lane::Set( 1.0 ) );
+
+    // d(arg)/dx is -k
+    const auto g = Lane::Set( gravity );
+    const auto d1 = Lane::Mul( Lane::Set( -k ), sinc1 );
+    const auto d2 = Lane::Mul( Lane::Set( k * k ), sinc2 );
+    const auto first = Lane::Mul( decay, Lane::MulAdd( g, sinc, d1 ) );
+    const auto second = Lane::Mul( decay, Lane::MulAdd( Lane::Mul( g, g ), sinc, Lane::MulAdd( Lane::Mul( Lane::Set( 2.0 ), g ), d1, d2 ) ) );
+    return { first, second };
+}
+
+/** Exponential: steepness*e, steepness^2*e */
+inline Rates ExponentialRates( V x, double steepness )
+{
+    const auto e = Exponential( x, steepness );
+    return { Lane::Mul( Lane::Set( steepness ), e ), Lane::Mul( Lane::Set( steepness * steepness ), e ) };
+}
+
+
+/** Bezier easing */
+
+
+/** Check if every value of a lane is 0 */
+inline bool IsZero( V a )
+{
+    double values[Lane::Width];
+    Lane::Store( values, a );
+    for( size_t j = 0; j < Lane::Width; ++j )
+    {
+        if( values[j] != 0 )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Multiply and add with two roundings, as scalar code does ( bezier lanes then match CubicBezier bit for bit ) */
+inline V MulThenAdd( V a, V b, V c )
+{
+    return Lane::Add( Lane::Mul( a, b ), c );
+}
+
+/** Cubic polynomial ( ( a*t + b )*t + c )*t */
+inline V Cubic( const CubicBezier::Polynomial& p, V t )
+{
+    return Lane::Mul( MulThenAdd( MulThenAdd( Lane::Set( p.a ), t, Lane::Set( p.b ) ), t, Lane::Set( p.c ) ), t );
+}
+
+/** Cubic polynomial slope ( 3*a*t + 2*b )*t + c */
+inline V CubicSlope( const CubicBezier::Polynomial& p, V t )
+{
+    return MulThenAdd( MulThenAdd( Lane::Set( 3*p.a ), t, Lane::Set( 2*p.b ) ), t, Lane::Set( p.c ) );
+}
+
+/** Bezier curve parameter at progress in [0, 1], the same steps as CubicBezier::Solve ( lanes that still miss the tolerance are solved one by one ) */
+inline V BezierSolve( const CubicBezier& curve, V progress )
+{
+    const auto zero = Lane::Set( 0.0 );
+    const auto one = Lane::Set( 1.0 );
+    const auto half = Lane::Set( 0.5 );
+    const auto& x = curve.GetX();
+
+    // Table interval, floor( scaled ) corrected from the rounded value
+    const auto scaled = Lane::Mul( progress, Lane::Set( static_cast<double>( BezierTableIntervals ) ) );
+    auto index = Lane::Round( Lane::Sub( scaled, half ) );
+    index = Lane::Select( Lane::Less( scaled, index ), Lane::Sub( index, one ), index );
+    index = Lane::Select( Lane::LessEqual( Lane::Add( index, one ), scaled ), Lane::Add( index, one ), index );
+    index = Lane::Min( Lane::Max( index, zero ), Lane::Set( static_cast<double>( BezierTableIntervals - 1 ) ) );
+
+    double indices[Lane::Width];
+    double lo_values[Lane::Width];
+    double hi_values[Lane::Width];
+    Lane::Store( indices, index );
+    for( size_t j = 0; j < Lane::Width; ++j )
+    {
+        const auto i = static_cast<size_t>( indices[j] );
+        lo_values[j] = curve.GetTable()[i];
+        hi_values[j] = curve.GetTable()[i+1];
+    }
+
+    auto lo = Lane::Load( lo_values );
+    auto hi = Lane::Load( hi_values );
+    auto t = MulThenAdd( Lane::Sub( hi, lo ), Lane::Sub( scaled, index ), lo );
+
+    // Lanes stop at the step CubicBezier::Solve returns from
+    auto active = one;
+    for( size_t step = 0; step < BezierNewtonSteps; ++step )
+    {
+        const auto error = Lane::Sub( Cubic( x, t ), progress );
+        const auto below = Lane::Less( error, zero );
+        lo = Lane::Select( below, t, lo );
+        hi = Lane::Select( below, hi, t );
+
+        const auto newton = Lane::Sub( t, Lane::Div( error, CubicSlope( x, t ) ) );
+        const auto mid = Lane::Mul( Lane::Add( lo, hi ), half );
+        const auto bounded = Lane::Select( Lane::LessEqual( lo, newton ), Lane::Select( Lane::LessEqual( newton, hi ), newton, mid ), mid );
+        const auto next = Lane::Select( Lane::Equal( error, zero ), t, bounded );
+        const auto converged = Lane::Less( Lane::Abs( Lane::Sub( next, t ) ), Lane::Set( BezierNewtonTolerance ) );
+
+        t = Lane::Select( Lane::Less( zero, active ), next, t );
+        active = Lane::Select( converged, zero, active );
+        if( IsZero( active ) )
+        {
+            break;
+        }
+    }
+
+    double t_values[Lane::Width];
+    double active_values[Lane::Width];
+    double progress_values[Lane::Width];
+    Lane::Store( t_values, t );
+    Lane::Store( active_values, active );
+    Lane::Store( progress_values, progress );
+    for( size_t j = 0; j < Lane::Width; ++j )
+    {
+        if( active_values[j] != 0 )
+        {
+            t_values[j] = curve.Solve( progress_values[j] );
+        }
+    }
+    return Lane::Load( t_values );
+}
+
+/** Bezier: y(t) at x(t) = x, continued along the end tangents outside [0, 1] */
+inline V Bezier( const CubicBezier& curve, V x )
+{
+    const auto zero = Lane::Set( 0.0 );
+    const auto one = Lane::Set( 1.0 );
+    const auto y = Cubic( curve.GetY(), BezierSolve( curve, Lane::Min( Lane::Max( x, zero ), one ) ) );
+    const auto below = Lane::Mul( x, Lane::Set( curve.GetStartSlope() ) );
+    const auto above = MulThenAdd( Lane::Sub( x, one ), Lane::Set( curve.GetEndSlope() ), one );
+    return Lane::Select( Lane::LessEqual( x, zero ), below, Lane::Select( Lane::LessEqual( one, x ), above, y ) );
+}
+
+/** Bezier: y'/x', ( y''x' - y'x'' ) / x'^3, end slopes and 0 outside ( 0, 1 ) */
+inline Rates BezierRates( const CubicBezier& curve, V x )
+{
+    const auto zero = Lane::Set( 0.0 );
+    const auto one = Lane::Set( 1.0 );
+    const auto& px = curve.GetX();
+    const auto& py = curve.GetY();
+
+    const auto t = BezierSolve( curve, Lane::Min( Lane::Max( x, zero ), one ) );
+    const auto dx = CubicSlope( px, t );
+    const auto dy = CubicSlope( py, t );
+    const auto ddx = MulThenAdd( Lane::Set( 6*px.a ), t, Lane::Set( 2*px.b ) );
+    const auto ddy = MulThenAdd( Lane::Set( 6*py.a ), t, Lane::Set( 2*py.b ) );
+    const auto first = Lane::Div( dy, dx );
+    const auto second = Lane::Div( Lane::Sub( Lane::Mul( ddy, dx ), Lane::Mul( dy, ddx ) ), Lane::Mul( Lane::Mul( dx, dx ), dx ) );
+
+    const auto below = Lane::LessEqual( x, zero );
+    const auto above = Lane::LessEqual( one, x );
+    return { Lane::Select( below, Lane::Set( curve.GetStartSlope() ), Lane::Select( above, Lane::Set( curve.GetEndSlope() ), first ) ),
+             Lane::Select( below, zero, Lane::Select( above, zero, second ) ) };
+}
+
+
+/** Batch evaluation */
+
+
+/** Apply function over the whole batch, as f(x) for IN and 1 - f(1-x) for OUT */
+template<typename Function>
+inline void Stream( Acceleration accel, const double* progress, double* out, size_t n, Function function )
+{
+    const auto one = Lane::Set( 1.0 );
+    const auto ease = [&]( V x )
+    {
+        return ( accel == Acceleration::OUT ? Lane::Sub( one, function( Lane::Sub( one, x ) ) ) : function( x ) );
+    };
+
+    size_t i = 0;
+    for( ; i + Lane::Width <= n; i += Lane::Width )
+    {
+        Lane::Store( out + i, ease( Lane::Load( progress + i ) ) );
+    }
+
+    // Remaining values go through a padded lane
+    if( i < n )
+    {
+        double in_tail[Lane::Width] {};
+        double out_tail[Lane::Width] {};
+        std::memcpy( in_tail, progress + i, (n - i) * sizeof(double) );
+        Lane::Store( out_tail, ease( Lane::Load( in_tail ) ) );
+        std::memcpy( out + i, out_tail, (n - i) * sizeof(double) );
+    }
+}
+
+/** Evaluate normalized easing function over an array of progress values */
+inline void EvaluateBatch( Type type,
+                           Acceleration accel,
+                           const double* progress,
+                           double* out,
+                           size_t n,
+                           double modifier,
+                           double gravity )
+{
+    switch( type )
+    {
+        case Type::POW:
+        {
+            // Integral powers keep the exact sign and rounding of repeated multiplication
+            if( modifier == std::floor( modifier ) && std::fabs( modifier ) <= 64 )
+            {
+                const auto power = static_cast<int>( modifier );
+                Stream( accel, progress, out, n, [=]( V x ) { return PowInt( x, power ); } );
+            }
+            else
+            {
+                Stream( accel, progress, out, n, [=]( V x ) { return Pow( x, modifier ); } );
+            }
+        }
+        break;
+        case Type::QUAD:        Stream( accel, progress, out, n, [=]( V x ) { return Lane::Mul( x, x ); } );                   break;
+        case Type::CUBIC:       Stream( accel, progress, out, n, [=]( V x ) { return Lane::Mul( Lane::Mul( x, x ), x ); } );   break;
+        case Type::SINE:        Stream( accel, progress, out, n, [=]( V x ) { return Sine( x ); } );                          break;
+        case Type::BACK:        Stream( accel, progress, out, n, [=]( V x ) { return Back( x ); } );                          break;
+        case Type::CIRCULAR:    Stream( accel, progress, out, n, [=]( V x ) { return Circular( x ); } );                      break;
+        case Type::ELASTIC:     Stream( accel, progress, out, n, [=]( V x ) { return Elastic( x, modifier, gravity ); } );   break;
+        case Type::BOUNCE:      Stream( accel, progress, out, n, [=]( V x ) { return Lane::Abs( Elastic( x, modifier, gravity ) ); } );  break;
+        case Type::EXPONENTIAL: Stream( accel, progress, out, n, [=]( V x ) { return Exponential( x, modifier ); } );        break;
+        default:                std::memmove( out, progress, n * sizeof(double) );                                           break;
+    }
+}
+
+/** Apply derivatives over the whole batch, as f'(x), f''(x) for IN and f'(1-x), -f''(1-x) for OUT */
+template<typename Function>
+inline void StreamRates( Acceleration accel, const double* progress, double* first, double* second, size_t n, Function function )
+{
+    const auto one = Lane::Set( 1.0 );
+    const auto rates = [&]( V x ) -> Rates
+    {
+        if( accel == Acceleration::OUT )
+        {
+            const auto mirrored = function( Lane::Sub( one, x ) );
+            return { mirrored.first, Lane::Sub( Lane::Set( 0.0 ), mirrored.second ) };
+        }
+        return function( x );
+    };
+
+    size_t i = 0;
+    for( ; i + Lane::Width <= n; i += Lane::Width )
+    {
+        const auto r = rates( Lane::Load( progress + i ) );
+        Lane::Store( first + i, r.first );
+        Lane::Store( second + i, r.second );
+    }
+
+    // Remaining values go through a padded lane
+    if( i < n )
+    {
+        double in_tail[Lane::Width] {};
+        double first_tail[Lane::Width] {};
+        double second_tail[Lane::Width] {};
+        std::memcpy( in_tail, progress + i, (n - i) * sizeof(double) );
+        const auto r = rates( Lane::Load( in_tail ) );
+        Lane::Store( first_tail, r.first );
+        Lane::Store( second_tail, r.second );
+        std::memcpy( first + i, first_tail, (n - i) * sizeof(double) );
+        std::memcpy( second + i, second_tail, (n - i) * sizeof(double) );
+    }
+}
+
+/** Evaluate first and second derivatives of the normalized easing function over an array of progress values */
+inline void EvaluateBatchDerivatives( Type type,
+                                      Acceleration accel,
+                                      const double* progress,
+                                      double* first,
+                                      double* second,
+                                      size_t n,
+                                      double modifier,
+                                      double gravity )
+{
+    switch( type )
+    {
+        case Type::POW:
+        {
+            if( modifier == std::floor( modifier ) && std::fabs( modifier ) <= 64 )
+            {
+                const auto power = static_cast<int>( modifier );
+                StreamRates( accel, progress, first, second, n, [=]( V x ) { return PowIntRates( x, power ); } );
+            }
+            else
+            {
+                StreamRates( accel, progress, first, second, n, [=]( V x ) { return PowRates( x, modifier ); } );
+            }
+        }
+        break;
+        case Type::QUAD:        StreamRates( accel, progress, first, second, n, [=]( V x ) { return PowIntRates( x, 2 ); } );          break;
+        case Type::CUBIC:       StreamRates( accel, progress, first, second, n, [=]( V x ) { return PowIntRates( x, 3 ); } );          break;
+        case Type::SINE:        StreamRates( accel, progress, first, second, n, [=]( V x ) { return SineRates( x ); } );               break;
+        case Type::BACK:        StreamRates( accel, progress, first, second, n, [=]( V x ) { return BackRates( x ); } );               break;
+        case Type::CIRCULAR:    StreamRates( accel, progress, first, second, n, [=]( V x ) { return CircularRates( x ); } );           break;
+        case Type::ELASTIC:
+            StreamRates( accel, progress, first, second, n, [=]( V x ) { V sign; return ElasticRates( x, modifier, gravity, sign ); } );
+        break;
+        case Type::BOUNCE:
+            StreamRates( accel, progress, first, second, n, [=]( V x )
+            {
+                V sign;
+                const auto r = ElasticRates( x, modifier, gravity, sign );
+                return Rates{ Lane::Mul( sign, r.first ), Lane::Mul( sign, r.second ) };
+            } );
+        break;
+        case Type::EXPONENTIAL: StreamRates( accel, progress, first, second, n, [=]( V x ) { return ExponentialRates( x, modifier ); } ); break;
+        default:
+        {
+            for( size_t i = 0; i < n; ++i )
+            {
+                first[i] = 1.0;
+                second[i] = 0.0;
+            }
+        }
+        break;
+    }
+}
+
+/** Evaluate bezier easing over an array of progress values */
+inline void EvaluateBatch( const CubicBezier& curve,
+                           Acceleration accel,
+                           const double* progress,
+                           double* out,
+                           size_t n )
+{
+    Stream( accel, progress, out, n, [&]( V x ) { return Bezier( curve, x ); } );
+}
+
+/** Evaluate first and second derivatives of bezier easing over an array of progress values */
+inline void EvaluateBatchDerivatives( const CubicBezier& curve,
+                                      Acceleration accel,
+                                      const double* progress,
+                                      double* first,
+                                      double* second,
+                                      size_t n )
+{
+    StreamRates( accel, progress, first, second, n, [&]( V x ) { return BezierRates( curve, x ); } );
+}
@@ -13,9 +13,12 @@
 #define EASING_FUNCTIONS_H
 
 #include <cmath>
+#include <array>
 #include <limits>
 #include <functional>
 
+#include "MotionStats.h"
+
 namespace Motion
 {
 
@@ -32,6 +35,7 @@ enum class Type : uint8_t
     BOUNCE,         // Bouncing motion ( modifier controls number of bounces )
     SINE,           // Sinusoidal
     EXPONENTIAL,    // Exponential ( modifier controls the steepness of the curve )
+    BEZIER,         // CSS cubic-bezier ( control points are given by the motion parameters )
 };
 
 /** Acceleration of the selected motion type */
@@ -45,52 +49,566 @@ using Easing = std::function<double (double, double, double)>;
 
 namespace EasingFunction
 {
-    static Easing Linear = []( double x, double slope, double ) -> double
+    inline double Linear( double x, double slope, double )
     {
         return x*slope;
-    };
+    }
 
-    static Easing Pow = []( double x, double power, double ) -> double
+    inline double Pow( double x, double power, double )
     {
         return std::pow( x, power );
-    };
+    }
 
-    static Easing Sine = []( double x, double, double ) -> double
+    inline double Sine( double x, double, double )
     {
         const auto h_pi = M_PI*0.5;
         return 1 + std::sin( h_pi*x - h_pi );
-    };
+    }
 
-    static Easing Back = []( double x, double, double ) -> double
+    inline double Back( double x, double, double )
     {
         return std::pow(x, 3) - x*std::sin( x*M_PI );
-    };
+    }
 
-    static Easing Circular = []( double x, double, double ) -> double
+    inline double Circular( double x, double, double )
     {
         const auto inv = 1-x;
         return 1 - std::sqrt( (2 - inv) * inv );
-    };
+    }
 
-    static Easing Elastic = []( double x, double wobbles, double gravity ) -> double
+    inline double Elastic( double x, double wobbles, double gravity )
     {
         const auto arg = wobbles * M_PI * (1 - x);
         return std::pow( M_E, (x - 1) * gravity ) * std::sin(arg)/arg;
-    };
+    }
 
-    static Easing Bounce = []( double x, double bounces, double gravity ) -> double
+    inline double Bounce( double x, double bounces, double gravity )
     {
         const auto arg = bounces * M_PI * (1 - x);
         return std::abs(std::pow( M_E, (x - 1) * gravity ) * std::sin(arg)/arg);
-    };
+    }
 
-    static Easing Exponential = []( double x, double steepness, double ) -> double
+    inline double Exponential( double x, double steepness, double )
     {
         return std::pow( M_E, (x - 1) * steepness );
+    }
+}
+
+/** Easing function value with its first and second derivatives */
+struct EasingDerivatives
+{
+    /** Function value */
+    double value {};
+
+    /** First derivative */
+    double first {};
+
+    /** Second derivative */
+    double second {};
+};
+
+/** Closed-form derivatives of the easing functions, matching EasingFunction */
+namespace EasingDerivative
+{
+    /** Taylor coefficients in arg^2 of sinc(arg) = sin(arg)/arg and its derivatives, used for |arg| < 1 where the closed forms cancel */
+    constexpr double SincSeries[] =
+    {
+        1.0, -1.0/6, 1.0/120, -1.0/5040, 1.0/362880, -1.0/39916800, 1.0/6227020800.0,
+        -1.0/1307674368000.0, 1.0/355687428096000.0, -1.0/121645100408832000.0
+    };
+    constexpr double SincFirstSeries[] =    // times arg
+    {
+        -1.0/3, 1.0/30, -1.0/840, 1.0/45360, -1.0/3991680, 1.0/518918400.0, -1.0/93405312000.0,
+        1.0/22230464256000.0, -1.0/6758061133824000.0, 1.0/2554547108585472000.0
+    };
+    constexpr double SincSecondSeries[] =
+    {
+        -1.0/3, 1.0/10, -1.0/168, 1.0/6480, -1.0/443520, 1.0/47174400.0, -1.0/7185024000.0,
+        1.0/1482030950400.0, -1.0/397533007872000.0, 1.0/134449847820288000.0
+    };
+
+    /** Series of the sinc coefficients */
+    constexpr size_t SincTerms = sizeof(SincSeries) / sizeof(double);
+
+    /** Arguments below which sinc goes through its series */
+    constexpr double SincSeriesBound = 1.0;
+
+    /** Evaluate a series in z ( Horner ) */
+    inline double Series( const double (&coefficients)[SincTerms], double z )
+    {
+        double sum = coefficients[SincTerms-1];
+        for( size_t i = SincTerms-1; i-- > 0; )
+        {
+            sum = sum * z + coefficients[i];
+        }
+        return sum;
+    }
+
+    inline EasingDerivatives Linear( double x, double slope, double gravity )
+    {
+        return { EasingFunction::Linear( x, slope, gravity ), slope, 0 };
+    }
+
+    inline EasingDerivatives Pow( double x, double power, double gravity )
+    {
+        // Constant terms are kept exact, x^-n is infinite at 0
+        const auto first = ( power == 0 ? 0.0 : power * std::pow( x, power - 1 ) );
+        const auto second = ( power == 0 || power == 1 ? 0.0 : power * (power - 1) * std::pow( x, power - 2 ) );
+        return { EasingFunction::Pow( x, power, gravity ), first, second };
+    }
+
+    inline EasingDerivatives Sine( double x, double modifier, double gravity )
+    {
+        const auto h_pi = M_PI*0.5;
+        return { EasingFunction::Sine( x, modifier, gravity ), h_pi * std::sin( h_pi*x ), h_pi * h_pi * std::cos( h_pi*x ) };
+    }
+
+    inline EasingDerivatives Back( double x, double modifier, double gravity )
+    {
+        const auto s = std::sin( x*M_PI );
+        const auto c = std::cos( x*M_PI );
+        return { EasingFunction::Back( x, modifier, gravity ),
+                 3*x*x - s - M_PI*x*c,
+                 6*x - 2*M_PI*c + M_PI*M_PI*x*s };
+    }
+
+    inline EasingDerivatives Circular( double x, double modifier, double gravity )
+    {
+        const auto inv = 1-x;
+        const auto u = (2 - inv) * inv;
+        const auto root = std::sqrt( u );
+        return { EasingFunction::Circular( x, modifier, gravity ), x / root, 1 / ( u * root ) };
+    }
+
+    inline EasingDerivatives Elastic( double x, double wobbles, double gravity )
+    {
+        // e^((x-1)g) * sinc(k(1-x)), sinc and its derivatives go through their series near 0
+        const auto k = wobbles * M_PI;
+        const auto arg = k * (1 - x);
+        const auto decay = std::pow( M_E, (x - 1) * gravity );
+
+        double sinc, sinc1, sinc2;
+        if( std::fabs( arg ) < SincSeriesBound )
+        {
+            const auto z = arg*arg;
+            sinc = Series( SincSeries, z );
+            sinc1 = arg * Series( SincFirstSeries, z );
+            sinc2 = Series( SincSecondSeries, z );
+        }
+        else
+        {
+            const auto s = std::sin( arg );
+            const auto c = std::cos( arg );
+            sinc = s/arg;
+            sinc1 = ( arg*c - s ) / ( arg*arg );
+            sinc2 = ( 2*s - 2*arg*c - arg*arg*s ) / ( arg*arg*arg );
+        }
+
+        // d(arg)/dx is -k
+        const auto d1 = -k * sinc1;
+        const auto d2 = k * k * sinc2;
+        return { EasingFunction::Elastic( x, wobbles, gravity ),
+                 decay * ( gravity*sinc + d1 ),
+                 decay * ( gravity*gravity*sinc + 2*gravity*d1 + d2 ) };
+    }
+
+    inline EasingDerivatives Bounce( double x, double bounces, double gravity )
+    {
+        const auto raw = Elastic( x, bounces, gravity );
+        const auto sign = ( raw.value < 0 ? -1.0 : 1.0 );
+        return { EasingFunction::Bounce( x, bounces, gravity ), sign * raw.first, sign * raw.second };
+    }
+
+    inline EasingDerivatives Exponential( double x, double steepness, double gravity )
+    {
+        const auto e = EasingFunction::Exponential( x, steepness, gravity );
+        return { e, steepness * e, steepness * steepness * e };
+    }
+}
+
+/** Control points of a CSS cubic-bezier( x1, y1, x2, y2 ) curve from ( 0, 0 ) to ( 1, 1 ), CSS "ease" by default */
+struct BezierPoints
+{
+    /** First control point */
+    double x1 {0.25};
+    double y1 {0.1};
+
+    /** Second control point */
+    double x2 {0.25};
+    double y2 {1.0};
+};
+
+inline bool operator==( const BezierPoints& a, const BezierPoints& b )
+{
+    return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2;
+}
+
+/** Intervals of the bezier solver table */
+constexpr size_t BezierTableIntervals = 64;
+
+/** Newton-Raphson steps of the bezier solver before it falls back to bisection */
+constexpr size_t BezierNewtonSteps = 8;
+
+/** Newton-Raphson step below which a bezier parameter is solved ( convergence is quadratic, the step after it would be below epsilon ) */
+constexpr double BezierNewtonTolerance = 1.5e-8;
+
+/** Bisection bracket below which a bezier parameter is solved */
+constexpr double BezierTolerance = 4 * std::numeric_limits<double>::epsilon();
+
+/** Cubic bezier easing, solving x(t) = progress for the curve parameter t and returning y(t)
+ *  ( a table of t over progress gives the bracket and the first guess, safeguarded Newton-Raphson steps refine it ) */
+class CubicBezier
+{
+public:
+
+    /** Polynomial a*t^3 + b*t^2 + c*t of one coordinate */
+    struct Polynomial
+    {
+        double a {};
+        double b {};
+        double c {};
+
+        inline double At( double t ) const { return ( ( a*t + b )*t + c )*t; }
+        inline double Slope( double t ) const { return ( 3*a*t + 2*b )*t + c; }
+        inline double Curvature( double t ) const { return 6*a*t + 2*b; }
+    };
+
+    /** Curve parameter at every progress i / BezierTableIntervals */
+    using Table = std::array<double, BezierTableIntervals + 1>;
+
+private:
+
+    /** Control points, as given */
+    BezierPoints points;
+
+    /** Progress over the curve parameter */
+    Polynomial x_polynomial;
+
+    /** Eased value over the curve parameter */
+    Polynomial y_polynomial;
+
+    /** Slope of the line extending the curve below progress 0 */
+    double start_slope {};
+
+    /** Slope of the line extending the curve above progress 1 */
+    double end_slope {};
+
+    /** Solver table */
+    Table table {};
+
+public:
+
+    /** Constructor, precomputes the solver table */
+    explicit CubicBezier( const BezierPoints& control )
+        : points( control )
+    {
+        // Control x is clamped to [0, 1], so that x(t) never decreases
+        const auto x1 = std::fmin( std::fmax( points.x1, 0.0 ), 1.0 );
+        const auto x2 = std::fmin( std::fmax( points.x2, 0.0 ), 1.0 );
+        x_polynomial = MakePolynomial( x1, x2 );
+        y_polynomial = MakePolynomial( points.y1, points.y2 );
+
+        // Outside [0, 1] the curve goes on along its end tangents, as in CSS
+        start_slope = ( x1 > 0 ? points.y1 / x1 : ( x2 > 0 ? points.y2 / x2 : 0.0 ) );
+        end_slope = ( x2 < 1 ? (points.y2 - 1) / (x2 - 1) : ( x1 < 1 ? (points.y1 - 1) / (x1 - 1) : 0.0 ) );
+
+        table.front() = 0.0;
+        table.back() = 1.0;
+        for( size_t i = 1; i < BezierTableIntervals; ++i )
+        {
+            const auto progress = static_cast<double>( i ) / BezierTableIntervals;
+            double lo = table[i-1];
+            double hi = 1.0;
+            while( hi - lo > std::numeric_limits<double>::epsilon() )
+            {
+                const auto mid = (lo + hi) / 2;
+                ( x_polynomial.At( mid ) < progress ? lo : hi ) = mid;
+            }
+            table[i] = (lo + hi) / 2;
+        }
+    }
+
+    /** Get curve parameter at a progress in [0, 1] */
+    inline double Solve( double progress ) const
+    {
+        const auto scaled = progress * BezierTableIntervals;
+        const auto i = std::min( static_cast<size_t>( scaled ), BezierTableIntervals - 1 );
+        double lo = table[i];
+        double hi = table[i+1];
+        auto t = lo + (hi - lo) * (scaled - i);
+
+        for( size_t step = 0; step < BezierNewtonSteps; ++step )
+        {
+            const auto next = Step( progress, t, lo, hi );
+            if( std::fabs( next - t ) < BezierNewtonTolerance )
+            {
+                return next;
+            }
+            t = next;
+        }
+
+        // Newton-Raphson converges slowly where x(t) is flat, bisect what is left of the bracket
+        while( hi - lo > BezierTolerance )
+        {
+            const auto error = x_polynomial.At( t ) - progress;
+            if( error == 0 )
+            {
+                break;
+            }
+            ( error < 0 ? lo : hi ) = t;
+            t = (lo + hi) * 0.5;
+        }
+        return t;
+    }
+
+    /** Newton-Raphson step towards x(t) = progress, narrowing the bracket, bisection when the step leaves it ( or the slope is 0 ) */
+    inline double Step( double progress, double t, double& lo, double& hi ) const
+    {
+        const auto error = x_polynomial.At( t ) - progress;
+        if( error == 0 )
+        {
+            return t;
+        }
+        ( error < 0 ? lo : hi ) = t;
+
+        const auto newton = t - error / x_polynomial.Slope( t );
+        return ( lo <= newton && newton <= hi ? newton : (lo + hi) * 0.5 );
+    }
+
+    /** Get eased value at a progress */
+    inline double Value( double progress ) const
+    {
+        if( progress <= 0 )
+        {
+            return progress * start_slope;
+        }
+        if( progress >= 1 )
+        {
+            return 1 + (progress - 1) * end_slope;
+        }
+        return y_polynomial.At( Solve( progress ) );
+    }
+
+    /** Get eased value and its derivatives over progress at a progress */
+    inline EasingDerivatives Derivatives( double progress ) const
+    {
+        if( progress <= 0 || progress >= 1 )
+        {
+            return { Value( progress ), ( progress <= 0 ? start_slope : end_slope ), 0.0 };
+        }
+
+        // dy/dx = y'/x', d2y/dx2 = ( y''x' - y'x'' ) / x'^3
+        const auto t = Solve( progress );
+        const auto dx = x_polynomial.Slope( t );
+        const auto dy = y_polynomial.Slope( t );
+        return { y_polynomial.At( t ), dy / dx, ( y_polynomial.Curvature( t ) * dx - dy * x_polynomial.Curvature( t ) ) / ( dx * dx * dx ) };
+    }
+
+    /** Get control points */
+    inline const BezierPoints& GetPoints() const
+    {
+        return points;
+    }
+
+    /** Get progress polynomial */
+    inline const Polynomial& GetX() const
+    {
+        return x_polynomial;
+    }
+
+    /** Get eased value polynomial */
+    inline const Polynomial& GetY() const
+    {
+        return y_polynomial;
+    }
+
+    /** Get slope below progress 0 */
+    inline double GetStartSlope() const
+    {
+        return start_slope;
+    }
+
+    /** Get slope above progress 1 */
+    inline double GetEndSlope() const
+    {
+        return end_slope;
+    }
+
+    /** Get solver table */
+    inline const Table& GetTable() const
+    {
+        return table;
+    }
+
+private:
+
+    /** Bezier polynomial from ( 0, 0 ) through two control coordinates to ( 1, 1 ) */
+    static Polynomial MakePolynomial( double p1, double p2 )
+    {
+        Polynomial polynomial;
+        polynomial.c = 3 * p1;
+        polynomial.b = 3 * (p2 - p1) - polynomial.c;
+        polynomial.a = 1 - polynomial.c - polynomial.b;
+        return polynomial;
+    }
+
+}; // class CubicBezier
+
+/** Compile-time selection of the easing function of a type */
+template<Type type> struct EasingFunctionOf;
+
+template<> struct EasingFunctionOf<Type::LINEAR>
+{
+    static inline double Value( double x, double, double ) { return EasingFunction::Linear( x, 1.0, 1.0 ); }
+    static inline EasingDerivatives Derivatives( double x, double, double ) { return EasingDerivative::Linear( x, 1.0, 1.0 ); }
+};
+
+template<> struct EasingFunctionOf<Type::POW>
+{
+    static inline double Value( double x, double modifier, double gravity ) { return EasingFunction::Pow( x, modifier, gravity ); }
+    static inline EasingDerivatives Derivatives( double x, double modifier, double gravity ) { return EasingDerivative::Pow( x, modifier, gravity ); }
+};
+
+template<> struct EasingFunctionOf<Type::QUAD>
+{
+    static inline double Value( double x, double, double gravity ) { return EasingFunction::Pow( x, 2, gravity ); }
+    static inline EasingDerivatives Derivatives( double x, double, double gravity ) { return EasingDerivative::Pow( x, 2, gravity ); }
+};
+
+template<> struct EasingFunctionOf<Type::CUBIC>
+{
+    static inline double Value( double x, double, double gravity ) { return EasingFunction::Pow( x, 3, gravity ); }
+    static inline EasingDerivatives Derivatives( double x, double, double gravity ) { return EasingDerivative::Pow( x, 3, gravity ); }
+};
+
+template<> struct EasingFunctionOf<Type::BACK>
+{
+    static inline double Value( double x, double modifier, double gravity ) { return EasingFunction::Back( x, modifier, gravity ); }
+    static inline EasingDerivatives Derivatives( double x, double modifier, double gravity ) { return EasingDerivative::Back( x, modifier, gravity ); }
+};
+
+template<> struct EasingFunctionOf<Type::CIRCULAR>
+{
+    static inline double Value( double x, double modifier, double gravity ) { return EasingFunction::Circular( x, modifier, gravity ); }
+    static inline EasingDerivatives Derivatives( double x, double modifier, double gravity ) { return EasingDerivative::Circular( x, modifier, gravity ); }
+};
+
+template<> struct EasingFunctionOf<Type::ELASTIC>
+{
+    static inline double Value( double x, double modifier, double gravity ) { return EasingFunction::Elastic( x, modifier, gravity ); }
+    static inline EasingDerivatives Derivatives( double x, double modifier, double gravity ) { return EasingDerivative::Elastic( x, modifier, gravity ); }
+};
+
+template<> struct EasingFunctionOf<Type::BOUNCE>
+{
+    static inline double Value( double x, double modifier, double gravity ) { return EasingFunction::Bounce( x, modifier, gravity ); }
+    static inline EasingDerivatives Derivatives( double x, double modifier, double gravity ) { return EasingDerivative::Bounce( x, modifier, gravity ); }
+};
+
+template<> struct EasingFunctionOf<Type::SINE>
+{
+    static inline double Value( double x, double modifier, double gravity ) { return EasingFunction::Sine( x, modifier, gravity ); }
+    static inline EasingDerivatives Derivatives( double x, double modifier, double gravity ) { return EasingDerivative::Sine( x, modifier, gravity ); }
+};
+
+template<> struct EasingFunctionOf<Type::EXPONENTIAL>
+{
+    static inline double Value( double x, double modifier, double gravity ) { return EasingFunction::Exponential( x, modifier, gravity ); }
+    static inline EasingDerivatives Derivatives( double x, double modifier, double gravity ) { return EasingDerivative::Exponential( x, modifier, gravity ); }
+};
+
+/** Get easing function value of a compile-time type and acceleration ( BEZIER eases along its curve, linearly without one ) */
+template<Type type, Acceleration accel>
+inline double Ease( double x, double modifier = 6.0, double gravity = 6.0, const CubicBezier* bezier = nullptr )
+{
+    if constexpr( type == Type::BEZIER )
+    {
+        if( !bezier )
+        {
+            return x;
+        }
+        return ( accel == Acceleration::IN ? bezier->Value( x ) : 1-bezier->Value( 1-x ) );
+    }
+    else if constexpr( type == Type::LINEAR || accel == Acceleration::IN )
+    {
+        return EasingFunctionOf<type>::Value( x, modifier, gravity );
+    }
+    else
+    {
+        return 1-EasingFunctionOf<type>::Value( 1-x, modifier, gravity );
+    }
+}
+
+/** Get easing function value of a compile-time type and acceleration, normalized over [from, to] */
+template<Type type, Acceleration accel>
+inline double EaseNormalized( double x, double from, double to, double modifier = 6.0, double gravity = 6.0, const CubicBezier* bezier = nullptr )
+{
+    if constexpr( type == Type::LINEAR )
+    {
+        return Ease<type, accel>( x, modifier, gravity );
+    }
+    else
+    {
+        const auto l = to-from;
+        const auto f = ( from == 0.0 ? 0.0 : Ease<type, accel>( from, modifier, gravity, bezier ) );
+        const auto t = ( to == 1.0 ? 1.0 : Ease<type, accel>( to, modifier, gravity, bezier ) );
+        const auto c = Ease<type, accel>( x*l+from, modifier, gravity, bezier );
+        auto d = t-f;
+        const auto delta = std::numeric_limits<decltype(d)>::epsilon();
+        if( d < delta ) d = delta;
+        return (c - f) / d;
+    }
+}
+
+/** Get easing function value and derivatives of a compile-time type and acceleration */
+template<Type type, Acceleration accel>
+inline EasingDerivatives EaseDerivatives( double x, double modifier = 6.0, double gravity = 6.0, const CubicBezier* bezier = nullptr )
+{
+    const auto derivatives = [&]( double value )
+    {
+        if constexpr( type == Type::BEZIER )
+        {
+            return ( bezier ? bezier->Derivatives( value ) : EasingDerivative::Linear( value, 1.0, 1.0 ) );
+        }
+        else
+        {
+            return EasingFunctionOf<type>::Derivatives( value, modifier, gravity );
+        }
     };
+
+    if constexpr( type == Type::LINEAR || accel == Acceleration::IN )
+    {
+        return derivatives( x );
+    }
+    else
+    {
+        const auto mirrored = derivatives( 1-x );
+        return { 1-mirrored.value, mirrored.first, -mirrored.second };
+    }
 }
 
-class EasingFunctions 
+/** Get easing function value and derivatives of a compile-time type and acceleration, normalized over [from, to] */
+template<Type type, Acceleration accel>
+inline EasingDerivatives EaseNormalizedDerivatives( double x, double from, double to, double modifier = 6.0, double gravity = 6.0, const CubicBezier* bezier = nullptr )
+{
+    if constexpr( type == Type::LINEAR )
+    {
+        return EaseDerivatives<type, accel>( x, modifier, gravity );
+    }
+    else
+    {
+        const auto l = to-from;
+        const auto f = ( from == 0.0 ? 0.0 : Ease<type, accel>( from, modifier, gravity, bezier ) );
+        const auto t = ( to == 1.0 ? 1.0 : Ease<type, accel>( to, modifier, gravity, bezier ) );
+        const auto c = EaseDerivatives<type, accel>( x*l+from, modifier, gravity, bezier );
+        auto d = t-f;
+        const auto delta = std::numeric_limits<decltype(d)>::epsilon();
+        if( d < delta ) d = delta;
+        return { (c.value - f) / d, c.first * l / d, c.second * l * l / d };
+    }
+}
+
+class EasingFunctions
 {   
     
 public:
@@ -99,7 +617,7 @@ public:
     inline static Easing Normalized( double from, double to, const Easing& func, bool inverted = false )
     {
         return Easing(
-            [&]( double val, double modifier = 1, double gravity = 6 )
+            [=]( double val, double modifier = 1, double gravity = 6 )
             {
                 const auto l = to-from;
                 const auto f = ( from == 0.0 ? 0.0 : ( inverted ? 1-func(1-from, modifier, gravity) : func(from, modifier, gravity) ) );
@@ -112,117 +630,146 @@ public:
             }
         );
     }
+
+    /** Get easing function value of a compile-time type */
+    template<Type type>
+    inline static double GetFunctionValue( double val,
+                                           double from,
+                                           double to,
+                                           Acceleration accel = Acceleration::IN,
+                                           double modifier = 6.0,
+                                           double gravity = 6.0,
+                                           const CubicBezier* bezier = nullptr )
+    {
+        Stats::CountEvaluation( static_cast<size_t>( type ) );
+
+        if( from == 0.0 && to == 1.0 )
+        {
+            return ( accel == Acceleration::OUT ? Ease<type, Acceleration::OUT>( val, modifier, gravity, bezier )
+                                                : Ease<type, Acceleration::IN>( val, modifier, gravity, bezier ) );
+        }
+        else
+        {
+            return ( accel == Acceleration::OUT ? EaseNormalized<type, Acceleration::OUT>( val, from, to, modifier, gravity, bezier )
+                                                : EaseNormalized<type, Acceleration::IN>( val, from, to, modifier, gravity, bezier ) );
+        }
+    }
     
-    /** Get easing function value by enum */
+    /** Get easing function value by enum ( BEZIER eases along the given curve ) */
     inline static double GetFunctionValue( double val, 
                                            double from,
                                            double to,
                                            Type type,
                                            Acceleration accel = Acceleration::IN,
                                            double modifier = 6.0,
-                                           double gravity = 6.0 ) 
+                                           double gravity = 6.0,
+                                           const CubicBezier* bezier = nullptr )
     {
-        // Calculate current step
+        switch( type ) 
+        {
+            case Type::POW:          return GetFunctionValue<Type::POW>( val, from, to, accel, modifier, gravity );
+            case Type::QUAD:         return GetFunctionValue<Type::QUAD>( val, from, to, accel, modifier, gravity );
+            case Type::CUBIC:        return GetFunctionValue<Type::CUBIC>( val, from, to, accel, modifier, gravity );
+            case Type::SINE:         return GetFunctionValue<Type::SINE>( val, from, to, accel, modifier, gravity );
+            case Type::BACK:         return GetFunctionValue<Type::BACK>( val, from, to, accel, modifier, gravity );
+            case Type::CIRCULAR:     return GetFunctionValue<Type::CIRCULAR>( val, from, to, accel, modifier, gravity );
+            case Type::ELASTIC:      return GetFunctionValue<Type::ELASTIC>( val, from, to, accel, modifier, gravity );
+            case Type::BOUNCE:       return GetFunctionValue<Type::BOUNCE>( val, from, to, accel, modifier, gravity );
+            case Type::EXPONENTIAL:  return GetFunctionValue<Type::EXPONENTIAL>( val, from, to, accel, modifier, gravity );
+            case Type::BEZIER:       return GetFunctionValue<Type::BEZIER>( val, from, to, accel, modifier, gravity, bezier );
+            default:                 return GetFunctionValue<Type::LINEAR>( val, from, to, accel, modifier, gravity );
+        }
+    }
+
+    /** Get easing function value and derivatives of a compile-time type */
+    template<Type type>
+    inline static EasingDerivatives GetFunctionDerivatives( double val,
+                                                            double from,
+                                                            double to,
+                                                            Acceleration accel = Acceleration::IN,
+                                                            double modifier = 6.0,
+                                                            double gravity = 6.0,
+                                                            const CubicBezier* bezier = nullptr )
+    {
+        Stats::CountEvaluation( static_cast<size_t>( type ) );
 
-        if( from == 0.0 && to == 1.0 ) 
+        if( from == 0.0 && to == 1.0 )
         {
-            switch( type ) 
-            {
-                case Type::POW:
-                {
-                    switch( accel ) 
-                    {
-                        case Acceleration::IN:   return EasingFunction::Pow( val, modifier, gravity );
-                        case Acceleration::OUT:  return 1-EasingFunction::Pow( 1-val, modifier, gravity );
-                    }
-                }
-                case Type::QUAD:
-                {
-                    switch( accel ) 
-                    {
-                        case Acceleration::IN:   return EasingFunction::Pow( val, 2, gravity );
-                        case Acceleration::OUT:  return 1-EasingFunction::Pow( 1-val, 2, gravity );
-                    }
-                }
-                case Type::CUBIC:
-                {
-                    switch( accel ) 
-                    {
-                        case Acceleration::IN:   return EasingFunction::Pow( val, 3, gravity );
-                        case Acceleration::OUT:  return 1-EasingFunction::Pow( 1-val, 3, gravity );
-                    }
-                }
-                case Type::SINE:
-                {
-                    switch( accel ) 
-                    {
-                        case Acceleration::IN:   return EasingFunction::Sine( val, modifier, gravity );
-                        case Acceleration::OUT:  return 1-EasingFunction::Sine( 1-val, modifier, gravity );
-                    }
-                }
-                case Type::BACK:
-                {
-                    switch( accel ) 
-                    {
-                        case Acceleration::IN:   return EasingFunction::Back( val, modifier, gravity );
-                        case Acceleration::OUT:  return 1-EasingFunction::Back( 1-val, modifier, gravity );
-                    }
-                }
-                case Type::CIRCULAR:
-                {
-                    switch( accel ) 
-                    {
-                        case Acceleration::IN:   return EasingFunction::Circular( val, modifier, gravity );
-                        case Acceleration::OUT:  return 1-EasingFunction::Circular( 1-val, modifier, gravity );
-                    }
-                }                
-                case Type::ELASTIC:
-                {
-                    switch( accel ) 
-                    {
-                        case Acceleration::IN:   return EasingFunction::Elastic( val, modifier, gravity );
-                        case Acceleration::OUT:  return 1-EasingFunction::Elastic( 1-val, modifier, gravity );
-                    }
-                }
-                case Type::BOUNCE:
-                {
-                    switch( accel ) 
-                    {
-                        case Acceleration::IN:   return EasingFunction::Bounce( val, modifier, gravity );
-                        case Acceleration::OUT:  return 1-EasingFunction::Bounce( 1-val, modifier, gravity );
-                    }
-                }
-                case Type::EXPONENTIAL:
-                {
-                    switch( accel ) 
-                    {
-                        case Acceleration::IN:   return EasingFunction::Exponential( val, modifier, gravity );
-                        case Acceleration::OUT:  return 1-EasingFunction::Exponential( 1-val, modifier, gravity );
-                    }
-                }
-                default: return EasingFunction::Linear( val, 1.0, 1.0 );
-                
-            }
-            
+            return ( accel == Acceleration::OUT ? EaseDerivatives<type, Acceleration::OUT>( val, modifier, gravity, bezier )
+                                                : EaseDerivatives<type, Acceleration::IN>( val, modifier, gravity, bezier ) );
         }
-        else 
+        else
         {
-            switch( type ) 
-            {
-                case Type::POW:          return Normalized( from, to, EasingFunction::Pow,           (accel == Acceleration::OUT) )( val, modifier, gravity );
-                case Type::QUAD:         return Normalized( from, to, EasingFunction::Pow,           (accel == Acceleration::OUT) )( val, 2, gravity );
-                case Type::CUBIC:        return Normalized( from, to, EasingFunction::Pow,           (accel == Acceleration::OUT) )( val, 3, gravity );
-                case Type::SINE:         return Normalized( from, to, EasingFunction::Sine,          (accel == Acceleration::OUT) )( val, modifier, gravity );
-                case Type::BACK:         return Normalized( from, to, EasingFunction::Back,          (accel == Acceleration::OUT) )( val, modifier, gravity );
-                case Type::CIRCULAR:     return Normalized( from, to, EasingFunction::Circular,      (accel == Acceleration::OUT) )( val, modifier, gravity );
-                case Type::ELASTIC:      return Normalized( from, to, EasingFunction::Elastic,       (accel == Acceleration::OUT) )( val, modifier, gravity );
-                case Type::BOUNCE:       return Normalized( from, to, EasingFunction::Bounce,        (accel == Acceleration::OUT) )( val, modifier, gravity );
-                case Type::EXPONENTIAL:  return Normalized( from, to, EasingFunction::Exponential,   (accel == Acceleration::OUT) )( val, modifier, gravity );
-                default:                       return EasingFunction::Linear( val, 1.0, 1.0 );
-            }
+            return ( accel == Acceleration::OUT ? EaseNormalizedDerivatives<type, Acceleration::OUT>( val, from, to, modifier, gravity, bezier )
+                                                : EaseNormalizedDerivatives<type, Acceleration::IN>( val, from, to, modifier, gravity, bezier ) );
         }
     }
-    
+
+    /** Get easing function value and derivatives by enum ( BEZIER eases along the given curve ) */
+    inline static EasingDerivatives GetFunctionDerivatives( double val,
+                                                            double from,
+                                                            double to,
+                                                            Type type,
+                                                            Acceleration accel = Acceleration::IN,
+                                                            double modifier = 6.0,
+                                                            double gravity = 6.0,
+                                                            const CubicBezier* bezier = nullptr )
+    {
+        switch( type )
+        {
+            case Type::POW:          return GetFunctionDerivatives<Type::POW>( val, from, to, accel, modifier, gravity );
+            case Type::QUAD:         return GetFunctionDerivatives<Type::QUAD>( val, from, to, accel, modifier, gravity );
+            case Type::CUBIC:        return GetFunctionDerivatives<Type::CUBIC>( val, from, to, accel, modifier, gravity );
+            case Type::SINE:         return GetFunctionDerivatives<Type::SINE>( val, from, to, accel, modifier, gravity );
+            case Type::BACK:         return GetFunctionDerivatives<Type::BACK>( val, from, to, accel, modifier, gravity );
+            case Type::CIRCULAR:     return GetFunctionDerivatives<Type::CIRCULAR>( val, from, to, accel, modifier, gravity );
+            case Type::ELASTIC:      return GetFunctionDerivatives<Type::ELASTIC>( val, from, to, accel, modifier, gravity );
+            case Type::BOUNCE:       return GetFunctionDerivatives<Type::BOUNCE>( val, from, to, accel, modifier, gravity );
+            case Type::EXPONENTIAL:  return GetFunctionDerivatives<Type::EXPONENTIAL>( val, from, to, accel, modifier, gravity );
+            case Type::BEZIER:       return GetFunctionDerivatives<Type::BEZIER>( val, from, to, accel, modifier, gravity, bezier );
+            default:                 return GetFunctionDerivatives<Type::LINEAR>( val, from, to, accel, modifier, gravity );
+        }
+    }
+
+};
+
+/** Easing policy resolving the function from the motion parameters at runtime */
+struct DynamicEasing
+{
+    /** Get easing type used for motion parameters of a given type */
+    static constexpr Type Resolve( Type type ) { return type; }
+
+    /** Get easing function value */
+    static inline double Evaluate( double val, double from, double to, Type type, Acceleration accel, double modifier, double gravity, const CubicBezier* bezier = nullptr )
+    {
+        return EasingFunctions::GetFunctionValue( val, from, to, type, accel, modifier, gravity, bezier );
+    }
+
+    /** Get easing function value and derivatives */
+    static inline EasingDerivatives Derivatives( double val, double from, double to, Type type, Acceleration accel, double modifier, double gravity, const CubicBezier* bezier = nullptr )
+    {
+        return EasingFunctions::GetFunctionDerivatives( val, from, to, type, accel, modifier, gravity, bezier );
+    }
+};
+
+/** Easing policy fixed to a single type at compile time ( the type of the motion parameters is ignored ) */
+template<Type type>
+struct StaticEasing
+{
+    /** Get easing type used for motion parameters of a given type */
+    static constexpr Type Resolve( Type ) { return type; }
+
+    /** Get easing function value */
+    static inline double Evaluate( double val, double from, double to, Type, Acceleration accel, double modifier, double gravity, const CubicBezier* bezier = nullptr )
+    {
+        return EasingFunctions::GetFunctionValue<type>( val, from, to, accel, modifier, gravity, bezier );
+    }
+
+    /** Get easing function value and derivatives */
+    static inline EasingDerivatives Derivatives( double val, double from, double to, Type, Acceleration accel, double modifier, double gravity, const CubicBezier* bezier = nullptr )
+    {
+        return EasingFunctions::GetFunctionDerivatives<type>( val, from, to, accel, modifier, gravity, bezier );
+    }
 };
 
 } // namespace egt
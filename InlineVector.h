@@ -0,0 +1,276 @@
+/** --------------------------------------------------------
+ *
+ *                  INLINE VECTOR
+ *
+ * Sequence container keeping its first few items inside
+ *   the object itself, so that short sequences ( motion
+ *    queues are usually one to a few segments ) are built,
+ *     copied and moved without touching the heap. Longer
+ *      sequences spill over to a heap buffer, which is kept
+ *       for reuse until the container is destroyed.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_INLINE_VECTOR_H
+#define MOTION_INLINE_VECTOR_H
+
+#include <array>
+#include <vector>
+#include <iterator>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+
+namespace Motion
+{
+
+/** Vector-like container with inline storage for up to Capacity items ( plain data items only ) */
+template<typename T, size_t Capacity>
+class InlineVector
+{
+    static_assert( std::is_trivially_copyable<T>::value, "Inline items are copied as plain data" );
+    static_assert( Capacity > 0, "Inline capacity must not be zero" );
+
+public:
+
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+
+    /** Inline storage, holds the items while there are at most Capacity of them */
+    std::array<T, Capacity> local;
+
+    /** Heap storage, holds all the items once there are more than Capacity */
+    std::vector<T> heap;
+
+    /** Number of items */
+    size_t count {};
+
+public:
+
+    /** Constructor */
+    InlineVector() = default;
+
+    /** Constructor from a list of items */
+    InlineVector( std::initializer_list<T> items )
+    {
+        reserve( items.size() );
+        for( const auto& item : items )
+        {
+            push_back( item );
+        }
+    }
+
+    /** Copy constructor ( copies only the items in use ) */
+    InlineVector( const InlineVector& other )
+    {
+        *this = other;
+    }
+
+    /** Move constructor */
+    InlineVector( InlineVector&& other ) noexcept
+    {
+        *this = std::move( other );
+    }
+
+    /** Copy assignment ( keeps this container's heap buffer for reuse ) */
+    InlineVector& operator=( const InlineVector& other )
+    {
+        if( this != &other )
+        {
+            if( other.IsSpilled() )
+            {
+                heap.assign( other.heap.begin(), other.heap.end() );
+            }
+            else
+            {
+                heap.clear();
+                std::copy( other.local.begin(), other.local.begin() + other.count, local.begin() );
+            }
+            count = other.count;
+        }
+        return *this;
+    }
+
+    /** Move assignment */
+    InlineVector& operator=( InlineVector&& other ) noexcept
+    {
+        if( this != &other )
+        {
+            if( other.IsSpilled() )
+            {
+                heap = std::move( other.heap );
+            }
+            else
+            {
+                heap.clear();
+                std::copy( other.local.begin(), other.local.begin() + other.count, local.begin() );
+            }
+            count = other.count;
+            other.clear();
+        }
+        return *this;
+    }
+
+    /** Append item */
+    inline void push_back( const T& item )
+    {
+        if( count < Capacity )
+        {
+            local[count] = item;
+        }
+        else
+        {
+            // Spill the inline items over to the heap, item may be one of them so it is copied first
+            if( count == Capacity )
+            {
+                const T copy = item;
+                heap.reserve( 2 * Capacity );
+                heap.assign( local.begin(), local.end() );
+                heap.push_back( copy );
+            }
+            else
+            {
+                heap.push_back( item );
+            }
+        }
+        ++count;
+    }
+
+    /** Construct item in place at the end */
+    template<typename... Args>
+    inline T& emplace_back( Args&&... args )
+    {
+        push_back( T{ std::forward<Args>(args)... } );
+        return back();
+    }
+
+    /** Remove last item */
+    inline void pop_back()
+    {
+        if( IsSpilled() )
+        {
+            heap.pop_back();
+            if( count - 1 == Capacity )
+            {
+                std::copy( heap.begin(), heap.end(), local.begin() );
+                heap.clear();
+            }
+        }
+        --count;
+    }
+
+    /** Remove all items ( the heap buffer is kept ) */
+    inline void clear()
+    {
+        heap.clear();
+        count = 0;
+    }
+
+    /** Reserve heap storage for sequences longer than the inline capacity */
+    inline void reserve( size_t size )
+    {
+        if( size > Capacity )
+        {
+            heap.reserve( size );
+        }
+    }
+
+    /** Get number of items */
+    inline size_t size() const
+    {
+        return count;
+    }
+
+    /** Check if there are no items */
+    inline bool empty() const
+    {
+        return count == 0;
+    }
+
+    /** Get number of items held without allocating */
+    static constexpr size_t inline_capacity()
+    {
+        return Capacity;
+    }
+
+    /** Get items */
+    inline T* data()
+    {
+        return IsSpilled() ? heap.data() : local.data();
+    }
+
+    /** Get items */
+    inline const T* data() const
+    {
+        return IsSpilled() ? heap.data() : local.data();
+    }
+
+    /** Get item */
+    inline T& operator[]( size_t i )
+    {
+        return data()[i];
+    }
+
+    /** Get item */
+    inline const T& operator[]( size_t i ) const
+    {
+        return data()[i];
+    }
+
+    /** Get first item */
+    inline T& front()
+    {
+        return data()[0];
+    }
+
+    /** Get first item */
+    inline const T& front() const
+    {
+        return data()[0];
+    }
+
+    /** Get last item */
+    inline T& back()
+    {
+        return data()[count - 1];
+    }
+
+    /** Get last item */
+    inline const T& back() const
+    {
+        return data()[count - 1];
+    }
+
+    /** Iterators over the items in use */
+    inline iterator begin() { return data(); }
+    inline iterator end() { return data() + count; }
+    inline const_iterator begin() const { return data(); }
+    inline const_iterator end() const { return data() + count; }
+    inline reverse_iterator rbegin() { return reverse_iterator( end() ); }
+    inline reverse_iterator rend() { return reverse_iterator( begin() ); }
+    inline const_reverse_iterator rbegin() const { return const_reverse_iterator( end() ); }
+    inline const_reverse_iterator rend() const { return const_reverse_iterator( begin() ); }
+
+private:
+
+    /** Check if the items live on the heap */
+    inline bool IsSpilled() const
+    {
+        return count > Capacity;
+    }
+
+}; // class InlineVector
+
+} // namespace Motion
+
+#endif /** MOTION_INLINE_VECTOR_H */
@@ -16,20 +16,70 @@
 #ifndef MOTION_H
 #define MOTION_H
 
+#include <array>
+#include <variant>
+#include <stdexcept>
+
 #include "MotionCore.h"
+#include "MotionVectorCore.h"
+#include "SpringCore.h"
 #include "Point.h"
 
 namespace Motion
 {
 
-// Single motion object
+// Set runtime calculation of a motion held by a motion object ( springs are always calculated )
+template<typename Core>
+void SetModeRuntime( Core& core, bool runtime_calculation )
+{
+    core.SetRuntimeCalculation( runtime_calculation );
+}
+
+template<typename Core, size_t Dimension>
+void SetModeRuntime( std::array<Core, Dimension>& cores, bool runtime_calculation )
+{
+    for( auto& core : cores )
+    {
+        core.SetRuntimeCalculation( runtime_calculation );
+    }
+}
+
+template<typename ValueType, size_t Dimension>
+void SetModeRuntime( SpringCore<ValueType, Dimension>&, bool )
+{}
+
+// Switch a motion object to a mode, the motion of that mode is kept if it is in use already ( no allocation once warm )
+template<typename Mode, typename Modes>
+Mode& SelectMode( Modes& modes, bool runtime_calculation )
+{
+    if( auto* current = std::get_if<Mode>( &modes ) )
+    {
+        return *current;
+    }
+
+    auto& mode = modes.template emplace<Mode>();
+    SetModeRuntime( mode, runtime_calculation );
+    return mode;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+// Single motion object ( eased, or springing towards a target that may move )
 template<typename ValueType>
 struct Motion
 {
-    MotionCore<ValueType> motion {};
+    using Eased = MotionCore<ValueType>;
+    using Spring = SpringCore<ValueType>;
+
+    // Only the motion of the mode in use is held
+    std::variant<Eased, Spring> mode;
+    bool runtime_calculation {};
 
     explicit Motion( bool runtime_calculation = true )
-        : motion(runtime_calculation)
+        : mode( std::in_place_type<Eased>, runtime_calculation ),
+          runtime_calculation(runtime_calculation)
     {}
 
     // Set simple parameters
@@ -42,7 +92,7 @@ struct Motion
         double modifier = 4,
         double gravity = 2 )
     {
-        motion.SetParameters( start_value, end_value, frame_duration, type, duration_split, modifier, gravity );
+        SelectMode<Eased>( mode, runtime_calculation ).SetParameters( start_value, end_value, frame_duration, type, duration_split, modifier, gravity );
     }
 
     // Set complex parameters
@@ -50,52 +100,209 @@ struct Motion
         ValueType start_value,
         ValueType end_value,
         TimeType frame_duration,
-        MotionQueue<ValueType> params )
+        const MotionQueue<ValueType>& params )
+    {
+        SelectMode<Eased>( mode, runtime_calculation ).SetParameters( start_value, end_value, frame_duration, params );
+    }
+
+    // Set spring parameters, the value springs from start to target until it rests
+    void SetSpring(
+        ValueType start_value,
+        ValueType target,
+        SpringParameters params = {} )
+    {
+        SelectMode<Spring>( mode, runtime_calculation ).SetParameters( {start_value}, {target}, params );
+    }
+
+    // Move the spring target mid-flight ( O(1), an eased motion hands its current value and velocity over to the spring )
+    void SetTarget( ValueType target )
     {
-        motion.SetParameters( start_value, end_value, frame_duration, params );
+        if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->SetTarget( {target} );
+            return;
+        }
+
+        const auto& eased = std::get<Eased>( mode );
+        const auto value = static_cast<double>( eased.GetCurrentValue() );
+        const auto velocity = eased.GetCurrentVelocity();
+        SelectMode<Spring>( mode, runtime_calculation ).Start( {value}, {velocity}, {static_cast<double>( target )} );
     }
 
     // Advance to next frame
     void AdvanceToNext()
     {
-        motion.AdvanceToNext();
+        if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->AdvanceToNext();
+        }
+        else
+        {
+            std::get<Eased>( mode ).AdvanceToNext();
+        }
     }
 
     // Check if interpolation is finished
-    bool HasFinished()
+    bool HasFinished() const
     {
-        return motion.HasFinished();
+        const auto* spring = std::get_if<Spring>( &mode );
+        return spring ? spring->HasFinished() : std::get<Eased>( mode ).HasFinished();
     }
 
     // Get current interpolated value
-    ValueType GetCurrentValue()
+    ValueType GetCurrentValue() const
+    {
+        const auto* spring = std::get_if<Spring>( &mode );
+        return spring ? spring->GetCurrentValue()[0] : std::get<Eased>( mode ).GetCurrentValue();
+    }
+
+    // Get current velocity, in value per frame
+    double GetCurrentVelocity() const
     {
-        return motion.GetCurrentValue();
+        const auto* spring = std::get_if<Spring>( &mode );
+        return spring ? spring->GetCurrentVelocity()[0] : std::get<Eased>( mode ).GetCurrentVelocity();
+    }
+
+    // Get current acceleration, in value per frame squared
+    double GetCurrentAcceleration() const
+    {
+        const auto* spring = std::get_if<Spring>( &mode );
+        return spring ? spring->GetCurrentAcceleration()[0] : std::get<Eased>( mode ).GetCurrentAcceleration();
     }
 
     // Reset all interpolation data
     void Reset()
     {
-        motion.Reset();
+        if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->Reset();
+        }
+        else
+        {
+            std::get<Eased>( mode ).Reset();
+        }
+    }
+
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+// Read-only view of one axis of a multi-axis motion, valid whichever mode the motion is in
+template<typename ValueType, size_t Dimension>
+class MotionAxis
+{
+    using Shared = MotionVectorCore<ValueType, Dimension>;
+    using PerAxis = std::array<MotionCore<ValueType>, Dimension>;
+    using Spring = SpringCore<ValueType, Dimension>;
+    using Modes = std::variant<Shared, PerAxis, Spring>;
+
+    const Modes* modes;
+    size_t axis;
+
+public:
+
+    // Throws std::out_of_range past the last axis, like std::array::at()
+    MotionAxis( const Modes& modes, size_t axis )
+        : modes(&modes),
+          axis(axis)
+    {
+        if( axis >= Dimension )
+        {
+            throw std::out_of_range( "MotionAxis: axis out of range" );
+        }
+    }
+
+    // Check if the axis has finished ( axes sharing one easing or spring finish together )
+    bool HasFinished() const
+    {
+        if( const auto* axes = std::get_if<PerAxis>( modes ) )
+        {
+            return (*axes)[axis].HasFinished();
+        }
+
+        if( const auto* spring = std::get_if<Spring>( modes ) )
+        {
+            return spring->HasFinished();
+        }
+
+        return std::get<Shared>( *modes ).HasFinished();
+    }
+
+    // Get current interpolated value of the axis
+    ValueType GetCurrentValue() const
+    {
+        if( const auto* axes = std::get_if<PerAxis>( modes ) )
+        {
+            return (*axes)[axis].GetCurrentValue();
+        }
+
+        if( const auto* spring = std::get_if<Spring>( modes ) )
+        {
+            return spring->GetCurrentValue()[axis];
+        }
+
+        return std::get<Shared>( *modes ).GetCurrentValue()[axis];
+    }
+
+    // Get current velocity of the axis, in value per frame
+    double GetCurrentVelocity() const
+    {
+        if( const auto* axes = std::get_if<PerAxis>( modes ) )
+        {
+            return (*axes)[axis].GetCurrentVelocity();
+        }
+
+        if( const auto* spring = std::get_if<Spring>( modes ) )
+        {
+            return spring->GetCurrentVelocity()[axis];
+        }
+
+        return std::get<Shared>( *modes ).GetCurrentVelocity()[axis];
     }
 
+    // Get current acceleration of the axis, in value per frame squared
+    double GetCurrentAcceleration() const
+    {
+        if( const auto* axes = std::get_if<PerAxis>( modes ) )
+        {
+            return (*axes)[axis].GetCurrentAcceleration();
+        }
+
+        if( const auto* spring = std::get_if<Spring>( modes ) )
+        {
+            return spring->GetCurrentAcceleration()[axis];
+        }
+
+        return std::get<Shared>( *modes ).GetCurrentAcceleration()[axis];
+    }
 };
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 
-// Two-dimensional motion object
+// Two-dimensional motion object ( both axes share one easing evaluation, unless given separate queues, or spring towards a target )
 template<typename ValueType>
 struct Motion2D
 {
-    MotionCore<ValueType> x {}, y {};
+    using Shared = MotionVectorCore<ValueType, 2>;
+    using PerAxis = std::array<MotionCore<ValueType>, 2>;
+    using Spring = SpringCore<ValueType, 2>;
+
+    // Only the motion of the mode in use is held
+    std::variant<Shared, PerAxis, Spring> mode;
+    bool runtime_calculation {};
 
     explicit Motion2D( bool runtime_calculation = true )
-        : x(runtime_calculation),
-          y(runtime_calculation)
+        : mode( std::in_place_type<Shared>, runtime_calculation ),
+          runtime_calculation(runtime_calculation)
     {}
 
+    // Axis view, in every mode ( 0 is x, 1 is y )
+    MotionAxis<ValueType, 2> at( size_t i ) const { return { mode, i }; }
+
     // Set simple parameters
     void SetParameters(
         Point2D<ValueType> start_value,
@@ -106,8 +313,8 @@ struct Motion2D
         double modifier = 4,
         double gravity = 2 )
     {
-        x.SetParameters( start_value.x, end_value.x, frame_duration, type, duration_split, modifier, gravity );
-        y.SetParameters( start_value.y, end_value.y, frame_duration, type, duration_split, modifier, gravity );
+        auto& shared = SelectMode<Shared>( mode, runtime_calculation );
+        shared.SetParameters( {start_value.x, start_value.y}, {end_value.x, end_value.y}, frame_duration, type, duration_split, modifier, gravity );
     }
 
     // Set complex parameters
@@ -115,36 +322,112 @@ struct Motion2D
         Point2D<ValueType> start_value,
         Point2D<ValueType> end_value,
         TimeType frame_duration,
-        MotionQueue<ValueType> params )
+        const MotionQueue<ValueType>& params )
     {
-        x.SetParameters( start_value.x, end_value.x, frame_duration, params );
-        y.SetParameters( start_value.y, end_value.y, frame_duration, params );
+        auto& shared = SelectMode<Shared>( mode, runtime_calculation );
+        shared.SetParameters( {start_value.x, start_value.y}, {end_value.x, end_value.y}, frame_duration, params );
+    }
+
+    // Set complex parameters for each axis ( slower, easing is evaluated per axis )
+    void SetParameters(
+        Point2D<ValueType> start_value,
+        Point2D<ValueType> end_value,
+        TimeType frame_duration,
+        const MotionQueue<ValueType>& x_params,
+        const MotionQueue<ValueType>& y_params )
+    {
+        auto& axes = SelectMode<PerAxis>( mode, runtime_calculation );
+        axes[0].SetParameters( start_value.x, end_value.x, frame_duration, x_params );
+        axes[1].SetParameters( start_value.y, end_value.y, frame_duration, y_params );
+    }
+
+    // Set spring parameters, the point springs from start to target until it rests
+    void SetSpring(
+        Point2D<ValueType> start_value,
+        Point2D<ValueType> target,
+        SpringParameters params = {} )
+    {
+        SelectMode<Spring>( mode, runtime_calculation ).SetParameters( {start_value.x, start_value.y}, {target.x, target.y}, params );
+    }
+
+    // Move the spring target mid-flight ( O(1), an eased motion hands its current value and velocity over to the spring )
+    void SetTarget( Point2D<ValueType> target )
+    {
+        if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->SetTarget( {target.x, target.y} );
+            return;
+        }
+
+        const auto value = GetCurrentValue();
+        const auto* axes = std::get_if<PerAxis>( &mode );
+        const auto velocity = ( axes ? std::array<double, 2> { (*axes)[0].GetCurrentVelocity(), (*axes)[1].GetCurrentVelocity() } : std::get<Shared>( mode ).GetCurrentVelocity() );
+        auto& spring = SelectMode<Spring>( mode, runtime_calculation );
+        spring.Start( {static_cast<double>( value.x ), static_cast<double>( value.y )}, velocity, {static_cast<double>( target.x ), static_cast<double>( target.y )} );
     }
 
     // Advance to next frame
     void AdvanceToNext()
     {
-        x.AdvanceToNext();
-        y.AdvanceToNext();
+        if( auto* axes = std::get_if<PerAxis>( &mode ) )
+        {
+            (*axes)[0].AdvanceToNext();
+            (*axes)[1].AdvanceToNext();
+        }
+        else if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->AdvanceToNext();
+        }
+        else
+        {
+            std::get<Shared>( mode ).AdvanceToNext();
+        }
     }
 
     // Check if interpolation is finished
-    bool HasFinished()
+    bool HasFinished() const
     {
-        return x.HasFinished() && y.HasFinished();
+        if( const auto* axes = std::get_if<PerAxis>( &mode ) )
+        {
+            return (*axes)[0].HasFinished() && (*axes)[1].HasFinished();
+        }
+
+        if( const auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            return spring->HasFinished();
+        }
+
+        return std::get<Shared>( mode ).HasFinished();
     }
 
     // Get current interpolated value
-    Point2D<ValueType> GetCurrentValue()
+    Point2D<ValueType> GetCurrentValue() const
     {
-        return { x.GetCurrentValue(), y.GetCurrentValue() };
+        if( const auto* axes = std::get_if<PerAxis>( &mode ) )
+        {
+            return { (*axes)[0].GetCurrentValue(), (*axes)[1].GetCurrentValue() };
+        }
+
+        const auto& value = ( std::holds_alternative<Spring>( mode ) ? std::get<Spring>( mode ).GetCurrentValue() : std::get<Shared>( mode ).GetCurrentValue() );
+        return { value[0], value[1] };
     }
 
     // Reset all interpolation data
     void Reset()
     {
-        x.Reset();
-        y.Reset();
+        if( auto* axes = std::get_if<PerAxis>( &mode ) )
+        {
+            (*axes)[0].Reset();
+            (*axes)[1].Reset();
+        }
+        else if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->Reset();
+        }
+        else
+        {
+            std::get<Shared>( mode ).Reset();
+        }
     }
 };
 
@@ -152,18 +435,26 @@ struct Motion2D
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 
-// Three-dimensional motion object
+// Three-dimensional motion object ( all axes share one easing evaluation, unless given separate queues, or spring towards a target )
 template<typename ValueType>
 struct Motion3D
 {
-    MotionCore<ValueType> x {}, y {}, z {};
+    using Shared = MotionVectorCore<ValueType, 3>;
+    using PerAxis = std::array<MotionCore<ValueType>, 3>;
+    using Spring = SpringCore<ValueType, 3>;
+
+    // Only the motion of the mode in use is held
+    std::variant<Shared, PerAxis, Spring> mode;
+    bool runtime_calculation {};
 
     explicit Motion3D( bool runtime_calculation = true )
-        : x(runtime_calculation),
-          y(runtime_calculation),
-          z(runtime_calculation)
+        : mode( std::in_place_type<Shared>, runtime_calculation ),
+          runtime_calculation(runtime_calculation)
     {}
 
+    // Axis view, in every mode ( 0 is x, 1 is y, 2 is z )
+    MotionAxis<ValueType, 3> at( size_t i ) const { return { mode, i }; }
+
     // Set simple parameters
     void SetParameters(
         Point3D<ValueType> start_value,
@@ -174,9 +465,8 @@ struct Motion3D
         double modifier = 4,
         double gravity = 2 )
     {
-        x.SetParameters( start_value.x, end_value.x, frame_duration, type, duration_split, modifier, gravity );
-        y.SetParameters( start_value.y, end_value.y, frame_duration, type, duration_split, modifier, gravity );
-        z.SetParameters( start_value.z, end_value.z, frame_duration, type, duration_split, modifier, gravity );
+        auto& shared = SelectMode<Shared>( mode, runtime_calculation );
+        shared.SetParameters( {start_value.x, start_value.y, start_value.z}, {end_value.x, end_value.y, end_value.z}, frame_duration, type, duration_split, modifier, gravity );
     }
 
     // Set complex parameters
@@ -184,39 +474,119 @@ struct Motion3D
         Point3D<ValueType> start_value,
         Point3D<ValueType> end_value,
         TimeType frame_duration,
-        MotionQueue<ValueType> params )
+        const MotionQueue<ValueType>& params )
+    {
+        auto& shared = SelectMode<Shared>( mode, runtime_calculation );
+        shared.SetParameters( {start_value.x, start_value.y, start_value.z}, {end_value.x, end_value.y, end_value.z}, frame_duration, params );
+    }
+
+    // Set complex parameters for each axis ( slower, easing is evaluated per axis )
+    void SetParameters(
+        Point3D<ValueType> start_value,
+        Point3D<ValueType> end_value,
+        TimeType frame_duration,
+        const MotionQueue<ValueType>& x_params,
+        const MotionQueue<ValueType>& y_params,
+        const MotionQueue<ValueType>& z_params )
+    {
+        auto& axes = SelectMode<PerAxis>( mode, runtime_calculation );
+        axes[0].SetParameters( start_value.x, end_value.x, frame_duration, x_params );
+        axes[1].SetParameters( start_value.y, end_value.y, frame_duration, y_params );
+        axes[2].SetParameters( start_value.z, end_value.z, frame_duration, z_params );
+    }
+
+    // Set spring parameters, the point springs from start to target until it rests
+    void SetSpring(
+        Point3D<ValueType> start_value,
+        Point3D<ValueType> target,
+        SpringParameters params = {} )
     {
-        x.SetParameters( start_value.x, end_value.x, frame_duration, params );
-        y.SetParameters( start_value.y, end_value.y, frame_duration, params );
-        z.SetParameters( start_value.z, end_value.z, frame_duration, params );
+        auto& spring = SelectMode<Spring>( mode, runtime_calculation );
+        spring.SetParameters( {start_value.x, start_value.y, start_value.z}, {target.x, target.y, target.z}, params );
+    }
+
+    // Move the spring target mid-flight ( O(1), an eased motion hands its current value and velocity over to the spring )
+    void SetTarget( Point3D<ValueType> target )
+    {
+        if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->SetTarget( {target.x, target.y, target.z} );
+            return;
+        }
+
+        const auto value = GetCurrentValue();
+        const auto* axes = std::get_if<PerAxis>( &mode );
+        const auto velocity = ( axes ? std::array<double, 3> { (*axes)[0].GetCurrentVelocity(), (*axes)[1].GetCurrentVelocity(), (*axes)[2].GetCurrentVelocity() } : std::get<Shared>( mode ).GetCurrentVelocity() );
+        auto& spring = SelectMode<Spring>( mode, runtime_calculation );
+        spring.Start( {static_cast<double>( value.x ), static_cast<double>( value.y ), static_cast<double>( value.z )}, velocity,
+                      {static_cast<double>( target.x ), static_cast<double>( target.y ), static_cast<double>( target.z )} );
     }
 
     // Advance to next frame
     void AdvanceToNext()
     {
-        x.AdvanceToNext();
-        y.AdvanceToNext();
-        z.AdvanceToNext();
+        if( auto* axes = std::get_if<PerAxis>( &mode ) )
+        {
+            (*axes)[0].AdvanceToNext();
+            (*axes)[1].AdvanceToNext();
+            (*axes)[2].AdvanceToNext();
+        }
+        else if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->AdvanceToNext();
+        }
+        else
+        {
+            std::get<Shared>( mode ).AdvanceToNext();
+        }
     }
 
     // Check if interpolation is finished
-    bool HasFinished()
+    bool HasFinished() const
     {
-        return x.HasFinished() && y.HasFinished() && z.HasFinished();
+        if( const auto* axes = std::get_if<PerAxis>( &mode ) )
+        {
+            return (*axes)[0].HasFinished() && (*axes)[1].HasFinished() && (*axes)[2].HasFinished();
+        }
+
+        if( const auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            return spring->HasFinished();
+        }
+
+        return std::get<Shared>( mode ).HasFinished();
     }
 
     // Get current interpolated value
-    Point3D<ValueType> GetCurrentValue()
+    Point3D<ValueType> GetCurrentValue() const
     {
-        return { x.GetCurrentValue(), y.GetCurrentValue(), z.GetCurrentValue() };
+        if( const auto* axes = std::get_if<PerAxis>( &mode ) )
+        {
+            return { (*axes)[0].GetCurrentValue(), (*axes)[1].GetCurrentValue(), (*axes)[2].GetCurrentValue() };
+        }
+
+        const auto& value = ( std::holds_alternative<Spring>( mode ) ? std::get<Spring>( mode ).GetCurrentValue() : std::get<Shared>( mode ).GetCurrentValue() );
+        return { value[0], value[1], value[2] };
     }
 
     // Reset all interpolation data
     void Reset()
     {
-        x.Reset();
-        y.Reset();
-        z.Reset();
+        if( auto* axes = std::get_if<PerAxis>( &mode ) )
+        {
+            for( auto& axis : *axes )
+            {
+                axis.Reset();
+            }
+        }
+        else if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->Reset();
+        }
+        else
+        {
+            std::get<Shared>( mode ).Reset();
+        }
     }
 };
 
@@ -224,18 +594,25 @@ struct Motion3D
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 
-// Multi-dimensional motion object
+// Multi-dimensional motion object ( all axes share one easing evaluation, unless given separate queues, or spring towards a target )
 template<typename ValueType, size_t Dimension>
 struct MotionND
 {
-    std::array<MotionCore<ValueType>, Dimension> motion {};
+    using Shared = MotionVectorCore<ValueType, Dimension>;
+    using PerAxis = std::array<MotionCore<ValueType>, Dimension>;
+    using Spring = SpringCore<ValueType, Dimension>;
+
+    // Only the motion of the mode in use is held
+    std::variant<Shared, PerAxis, Spring> mode;
+    bool runtime_calculation {};
 
     explicit MotionND( bool runtime_calculation = true )
-        : motion(runtime_calculation)
+        : mode( std::in_place_type<Shared>, runtime_calculation ),
+          runtime_calculation(runtime_calculation)
     {}
 
-    MotionCore<ValueType>& at( size_t i ) { return motion.at(i); }
-    const MotionCore<ValueType>& at( size_t i ) const { return motion.at(i); }
+    // Axis view, in every mode ( parameters are set on the whole motion )
+    MotionAxis<ValueType, Dimension> at( size_t i ) const { return { mode, i }; }
 
     // Set simple parameters
     void SetParameters(
@@ -247,10 +624,8 @@ struct MotionND
         double modifier = 4,
         double gravity = 2 )
     {
-        for( decltype(Dimension) i = 0; i < Dimension; ++i )
-        {
-            motion.at(i).SetParameters( start_value.at(i), end_value.at(i), frame_duration, type, duration_split, modifier, gravity );
-        }
+        auto& shared = SelectMode<Shared>( mode, runtime_calculation );
+        shared.SetParameters( start_value.values, end_value.values, frame_duration, type, duration_split, modifier, gravity );
     }
 
     // Set complex parameters
@@ -258,27 +633,94 @@ struct MotionND
         PointND<ValueType, Dimension> start_value,
         PointND<ValueType, Dimension> end_value,
         TimeType frame_duration,
-        MotionQueue<ValueType> params )
+        const MotionQueue<ValueType>& params )
     {
+        SelectMode<Shared>( mode, runtime_calculation ).SetParameters( start_value.values, end_value.values, frame_duration, params );
+    }
+
+    // Set complex parameters for each axis ( slower, easing is evaluated per axis )
+    void SetParameters(
+        PointND<ValueType, Dimension> start_value,
+        PointND<ValueType, Dimension> end_value,
+        TimeType frame_duration,
+        const std::array<MotionQueue<ValueType>, Dimension>& params )
+    {
+        auto& axes = SelectMode<PerAxis>( mode, runtime_calculation );
         for( decltype(Dimension) i = 0; i < Dimension; ++i )
         {
-            motion.at(i).SetParameters( start_value.at(i), end_value.at(i), frame_duration, params );
+            axes.at(i).SetParameters( start_value.at(i), end_value.at(i), frame_duration, params.at(i) );
         }
     }
 
+    // Set spring parameters, the point springs from start to target until it rests
+    void SetSpring(
+        PointND<ValueType, Dimension> start_value,
+        PointND<ValueType, Dimension> target,
+        SpringParameters params = {} )
+    {
+        SelectMode<Spring>( mode, runtime_calculation ).SetParameters( start_value.values, target.values, params );
+    }
+
+    // Move the spring target mid-flight ( O(1) per axis, an eased motion hands its current value and velocity over to the spring )
+    void SetTarget( PointND<ValueType, Dimension> target )
+    {
+        if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->SetTarget( target.values );
+            return;
+        }
+
+        const auto value = GetCurrentValue();
+        const auto* axes = std::get_if<PerAxis>( &mode );
+        auto velocity = ( axes ? std::array<double, Dimension> {} : std::get<Shared>( mode ).GetCurrentVelocity() );
+        std::array<double, Dimension> position {}, spring_target {};
+        for( decltype(Dimension) i = 0; i < Dimension; ++i )
+        {
+            if( axes )
+            {
+                velocity.at(i) = axes->at(i).GetCurrentVelocity();
+            }
+            position.at(i) = static_cast<double>( value.at(i) );
+            spring_target.at(i) = static_cast<double>( target.at(i) );
+        }
+
+        SelectMode<Spring>( mode, runtime_calculation ).Start( position, velocity, spring_target );
+    }
+
     // Advance to next frame
     void AdvanceToNext()
     {
-        for( auto& m : motion )
+        if( auto* axes = std::get_if<PerAxis>( &mode ) )
+        {
+            for( auto& m : *axes )
+            {
+                m.AdvanceToNext();
+            }
+        }
+        else if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->AdvanceToNext();
+        }
+        else
         {
-            m.AdvanceToNext();
+            std::get<Shared>( mode ).AdvanceToNext();
         }
     }
 
     // Check if interpolation is finished
     bool HasFinished() const
     {
-        for( const auto& m : motion )
+        if( const auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            return spring->HasFinished();
+        }
+
+        if( const auto* vector = std::get_if<Shared>( &mode ) )
+        {
+            return vector->HasFinished();
+        }
+
+        for( const auto& m : std::get<PerAxis>( mode ) )
         {
             if( !m.HasFinished() )
             {
@@ -292,9 +734,22 @@ struct MotionND
     PointND<ValueType, Dimension> GetCurrentValue() const
     {
         PointND<ValueType, Dimension> p {};
+        if( const auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            p.values = spring->GetCurrentValue();
+            return p;
+        }
+
+        if( const auto* vector = std::get_if<Shared>( &mode ) )
+        {
+            p.values = vector->GetCurrentValue();
+            return p;
+        }
+
+        const auto& axes = std::get<PerAxis>( mode );
         for( decltype(Dimension) i = 0; i < Dimension; ++i )
         {
-            p.at(i) = motion.at(i).GetCurrentValue();
+            p.at(i) = axes[i].GetCurrentValue();
         }
         return p;
     }
@@ -302,9 +757,20 @@ struct MotionND
     // Reset all interpolation data
     void Reset()
     {
-        for( auto& m : motion )
+        if( auto* axes = std::get_if<PerAxis>( &mode ) )
+        {
+            for( auto& m : *axes )
+            {
+                m.Reset();
+            }
+        }
+        else if( auto* spring = std::get_if<Spring>( &mode ) )
+        {
+            spring->Reset();
+        }
+        else
         {
-            m.Reset();
+            std::get<Shared>( mode ).Reset();
         }
     }
 };
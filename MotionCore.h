@@ -17,61 +17,60 @@
 #define MOTION_CORE_H
 
 #include <vector>
-#include <deque>
 #include <fstream>
+#include <chrono>
+#include <cmath>
 
-#include "EasingFunctions.h"
+#include "MotionPlan.h"
+#include "AlignedAllocator.h"
+#include "BakedCurveCache.h"
+#include "CurveFile.h"
+#include "CompressedCurve.h"
+#include "MotionMath.h"
+#include "MotionStats.h"
 
 namespace Motion
 {
 
-using TimeType = uint32_t;
+/** Frames baked at a time by streamed baking */
+constexpr size_t DefaultStreamChunk = 1024;
 
-/** Singme motion parameters */
-template<typename ValueType>
-struct MotionParameters
+/** Easing class ( EasingPolicy may fix the easing type at compile time, see StaticEasing, and Math picks floating or fixed point ) */
+template<typename ValueType, typename EasingPolicy = DynamicEasing, typename Math = DefaultMath<ValueType, EasingPolicy>>
+class MotionCore
 {
-    /** Type of easing */
-    Type motion_type;
+    using MotionIdx = uint8_t;
+    using Interpolated = std::vector<ValueType, AlignedAllocator<ValueType>>;
+    using Scalar = typename Math::Scalar;
+    
+private:
 
-    /** Type of easing */
-    Acceleration accel_type;
+    // Playback state read on every step, kept together at the front
 
-    /** Duration of the animation (fraction of the total) */
-    double duration {0.5};
+    /** Contiguous buffer of interpolated values ( only the resident chunk when streaming ) */
+    Interpolated interpolated_values;
 
-    /** Length of the animation (fraction of the total) */
-    double length {0.5};
+    /** Index of the next interpolated value to play */
+    size_t baked_cursor {};
 
-    /** Starting value of the function */
-    ValueType start_value {0};
+    /** Number of precomputed values, own, streamed, shared or mapped */
+    size_t baked_count {};
 
-    /** Ending value of the function */
-    ValueType end_value {1};
+    /** Current value */
+    ValueType current_value {};
 
-    /** Extra modifier for Bounce/Elastic/Pow/Exponential */
-    double modifier {};
+    /** Last precomputed value played */
+    ValueType baked_value {};
 
-    /** Gravity modifier for Bounce/Elastic */
-    double gravity {};
+    /** Fraction of a frame played past the current one ( AdvanceBy ) */
+    double frame_fraction {};
 
-    /** Elapsed time */
-    TimeType elapsed_time {};
-};
+    /** Runtime calculation flag */
+    bool runtime_calculation {};
 
-/** Motion parameters queue type */
-template<typename ValueType>
-using MotionQueue = std::vector<MotionParameters<ValueType>>;
+    /** Own interpolated values are played directly */
+    bool buffered {};
 
-/** Easing class */
-template<typename ValueType>
-class MotionCore
-{
-    using MotionIdx = uint8_t;
-    using Interpolated = std::deque<ValueType>;
-    
-private:
-    
     /** Starting value */
     ValueType start_value {};
     
@@ -81,24 +80,75 @@ private:
     /** Total duration in frames */
     TimeType total_duration {};
     
-    /** Queue of animations */
-    MotionQueue<ValueType> motion_queue;
+    /** Precompiled queue of animations */
+    MotionPlanPtr plan;
+
+    /** Plan compiled from the own queue, rebuilt in place and never handed out */
+    OwnMotionPlan own_plan;
     
-    /** Queue of interpolated values */
-    Interpolated interpolated_values;
+    /** Index of the current plan segment */
+    size_t segment_index {};
     
-    /** Current value */
-    ValueType current_value {};
+    /** Elapsed time in the current plan segment */
+    TimeType elapsed_time {};
+
+    /** Ending value of each plan segment ( empty when there is nothing to animate ) */
+    std::vector<Scalar> segment_end_values;
+
+    /** Value arithmetic, holding what it needs of the plan */
+    Math math;
+    
+    /** Index of the first interpolated value held in the buffer */
+    size_t window_begin {};
+
+    /** Number of values of a streamed motion ( 0 unless streaming ) */
+    size_t streamed_count {};
+
+    /** Frames baked per streamed chunk */
+    size_t stream_chunk { DefaultStreamChunk };
+
+    /** Frame the plan cursor has been played to while streaming */
+    size_t stream_frame {};
+
+    /** Value at the plan cursor while streaming */
+    ValueType stream_value {};
+
+    /** Normalized curve shared with other motions, used instead of interpolated values */
+    BakedCurvePtr shared_curve;
+
+    /** Memory mapped curve file, used instead of interpolated values */
+    MappedCurvePtr mapped_curve;
+
+    /** Compressed curve, used instead of interpolated values */
+    CompressedCurvePtr compressed_curve;
+
+    /** Normalized or mapped samples played directly, scaled by unit_scale and moved by unit_offset ( null otherwise ) */
+    const double* unit_samples {};
+
+    /** Offset of the directly played samples */
+    double unit_offset {};
+
+    /** Scale of the directly played samples */
+    double unit_scale {};
+
+    /** Maximum error of compressed baking ( 0 keeps every baked value ) */
+    double compression_error {};
+
+    /** Shared curve baking flag */
+    bool shared_baking {};
+
+    /** Streamed baking flag */
+    bool streamed_baking {};
     
     /** Current animation starting point */
-    double current_start_value {};
+    Scalar current_start_value {};
     
     /** Current animation ending point */
-    double current_end_value {};
-    
-    /** Runtime calculation flag */
-    bool runtime_calculation {};
+    Scalar current_end_value {};
     
+    /** Precomputed value at the cursor, read by AdvanceBy() while a frame fraction is played */
+    ValueType baked_next {};
+
 public:
         
     /** Constructor */
@@ -110,66 +160,345 @@ public:
     inline void Reset() 
     {
         current_value = start_value;
-        current_start_value = start_value;
-        current_end_value = end_value;
+        current_start_value = Math::FromDouble( start_value );
+        segment_index = 0;
+        elapsed_time = 0;
+        current_end_value = Math::FromDouble( end_value );
+        segment_end_values.clear();
+        frame_fraction = 0;
+        baked_value = start_value;
+        baked_cursor = 0;
+        stream_frame = 0;
+        stream_value = start_value;
+
+        if( !plan || plan->IsEmpty() )
+        {
+            return;
+        }
+
+        // Segment ending values, accumulated exactly as during playback
+        double value = start_value + (end_value-start_value) * (*plan)[0].length;
+
+        // Nothing to animate
+        if( std::fabs(start_value - value) <= std::numeric_limits<decltype(value)>::epsilon() )
+        {
+            current_end_value = Math::FromDouble( value );
+            segment_index = plan->GetSegmentCount();
+            return;
+        }
+
+        segment_end_values.reserve( std::max( plan->GetSegmentCount(), MotionQueueCapacity ) );
+        segment_end_values.emplace_back( Math::FromDouble( value ) );
+        for( size_t i = 1; i < plan->GetSegmentCount(); ++i )
+        {
+            value += (end_value-start_value) * (*plan)[i].length;
+            segment_end_values.emplace_back( Math::FromDouble( value ) );
+        }
+
+        current_end_value = segment_end_values.front();
+        elapsed_time = plan->GetInitialElapsed();
+    }
+    
+    /** Check if the plan has been played through */
+    inline bool HasPlanFinished() const
+    {
+        return !plan || segment_index >= plan->GetSegmentCount();
     }
     
     /** Check if animation has finished */
-    inline bool HasFinished() 
+    inline bool HasFinished() const
     {
         if( runtime_calculation )
         {
-            return motion_queue.empty();
+            return HasPlanFinished();
         }
         else
         {
-            return interpolated_values.empty();
+            return baked_cursor >= GetBakedCount();
         }
     }
     
-    /** Advance to next frame */
+    /** Advance to next frame ( a frame fraction played by AdvanceBy() is dropped ) */
     void AdvanceToNext() 
     {
+        frame_fraction = 0;
+
         if( runtime_calculation )
         {
             CalculateNext();
         }
         else
         {
-            if( !interpolated_values.empty() )
+            if( baked_cursor < baked_count )
+            {
+                current_value = baked_value = GetBakedValue( baked_cursor++ );
+            }
+        }
+    }
+
+    /** Advance by a number of frames, which may be fractional ( O(1) per crossed segment ) */
+    void AdvanceBy( double frames )
+    {
+        if( !(frames > 0) )
+        {
+            return;
+        }
+
+        // The value at the cursor was read already if a fraction of the current frame was played
+        const bool has_next = ( frame_fraction > 0 && baked_cursor < GetBakedCount() );
+
+        const auto total = frame_fraction + frames;
+        const auto whole = std::floor( total );
+        frame_fraction = total - whole;
+
+        if( runtime_calculation )
+        {
+            SkipFrames( whole );
+
+            // Evaluate the easing between two frames
+            if( frame_fraction > 0 && !HasPlanFinished() )
+            {
+                current_value = Math::template ToValue<ValueType>( Math::Apply( math.Step( *plan, segment_index, elapsed_time + frame_fraction ), current_start_value, current_end_value ) );
+            }
+        }
+        else
+        {
+            const auto count = static_cast<size_t>( std::fmin( whole, static_cast<double>(GetBakedCount() - baked_cursor) ) );
+            if( count > 0 )
+            {
+                baked_cursor += count;
+                baked_value = ( count == 1 && has_next ? baked_next : GetBakedValue( baked_cursor-1 ) );
+            }
+            current_value = baked_value;
+
+            // Interpolate between two precomputed values, each read once even across streamed chunks
+            if( frame_fraction > 0 && baked_cursor < GetBakedCount() )
             {
-                current_value = interpolated_values.front();
-                interpolated_values.pop_front();
+                if( count > 0 || !has_next )
+                {
+                    baked_next = GetBakedValue( baked_cursor );
+                }
+                current_value = static_cast<ValueType>( baked_value + (static_cast<double>( baked_next ) - baked_value) * frame_fraction );
             }
         }
     }
+
+    /** Advance by a span of time at a given frame rate */
+    template<typename Rep, typename Period>
+    inline void AdvanceBy( std::chrono::duration<Rep, Period> time, double frame_rate = 60.0 )
+    {
+        AdvanceBy( std::chrono::duration<double>( time ).count() * frame_rate );
+    }
     
     /** Calculate next value */
     void CalculateNext()
     {
-        if( motion_queue.empty() )
+        if( HasPlanFinished() )
         {
             return;
         }
 
-        motion_queue.back().elapsed_time++;
+        const StatsTimer timer( StatsCounter::CALCULATION_NS );
+        Stats::Add( StatsCounter::CALCULATIONS );
+
+        elapsed_time++;
 
         if( CalculateCurrentEasingValue() )
         {
-            motion_queue.pop_back();
-            if( !motion_queue.empty() )
+            NextSegment();
+        }
+    }
+
+    /** Skip whole frames of the plan, jumping straight over complete segments */
+    void SkipFrames( double frames )
+    {
+        while( frames > 0 && !HasPlanFinished() )
+        {
+            const auto& segment = (*plan)[segment_index];
+            const auto remaining = static_cast<double>( segment.end_frame - elapsed_time );
+
+            if( frames < remaining )
             {
-                motion_queue.back().elapsed_time = 0;
-                current_start_value = current_end_value;
-                current_end_value += (end_value-start_value) * motion_queue.back().length;
+                elapsed_time += static_cast<TimeType>( frames );
+                CalculateCurrentEasingValue();
+                return;
             }
+
+            frames -= remaining;
+            elapsed_time = segment.end_frame;
+            CalculateCurrentEasingValue();
+            NextSegment();
+        }
+    }
+
+    /** Move on from a completed segment */
+    inline void NextSegment()
+    {
+        Stats::Add( StatsCounter::SEGMENT_TRANSITIONS );
+
+        if( ++segment_index < plan->GetSegmentCount() )
+        {
+            elapsed_time = 0;
+            current_start_value = current_end_value;
+            current_end_value = segment_end_values[segment_index];
+        }
+    }
+
+    /** Get value at a given frame since the start, without changing the current state ( O(log segments) ) */
+    ValueType EvaluateAt( TimeType frame ) const
+    {
+        if( frame == 0 || segment_end_values.empty() )
+        {
+            return start_value;
+        }
+
+        // Played through
+        if( frame >= plan->GetPlayedDuration() )
+        {
+            return Math::template ToValue<ValueType>( segment_end_values.back() );
+        }
+
+        const auto i = plan->FindSegment( frame );
+        const auto& segment = (*plan)[i];
+        const auto elapsed = plan->GetSegmentElapsed( i, frame );
+
+        if( elapsed == segment.end_frame )
+        {
+            return Math::template ToValue<ValueType>( segment_end_values[i] );
+        }
+
+        const auto segment_start = ( i == 0 ? Math::FromDouble( start_value ) : segment_end_values[i-1] );
+        return Math::template ToValue<ValueType>( Math::Apply( math.Step( *plan, i, elapsed ), segment_start, segment_end_values[i] ) );
+    }
+
+    /** Get value, velocity and acceleration per frame at a given, possibly fractional, frame since the start ( analytic, O(log segments) ) */
+    EasingDerivatives DerivativesAt( double frame ) const
+    {
+        // Played through or nothing to animate, the value is at rest
+        if( segment_end_values.empty() || !( frame < plan->GetPlayedDuration() ) )
+        {
+            return { segment_end_values.empty() ? static_cast<double>( start_value ) : Math::ToDouble( segment_end_values.back() ), 0, 0 };
+        }
+
+        frame = std::fmax( frame, 0.0 );
+        const auto whole = static_cast<TimeType>( frame );
+        auto i = plan->FindSegment( whole );
+        auto elapsed = plan->GetSegmentElapsed( i, whole );
+
+        // Segment completed on this very frame, the next one is due
+        if( elapsed == (*plan)[i].end_frame )
+        {
+            ++i;
+            elapsed = 0;
+        }
+
+        const auto segment_start = ( i == 0 ? Math::FromDouble( start_value ) : segment_end_values[i-1] );
+        return SegmentDerivatives( i, elapsed + ( frame - whole ), segment_start );
+    }
+
+    /** Get value, velocity and acceleration per frame at the current, possibly fractional, frame */
+    EasingDerivatives GetCurrentDerivatives() const
+    {
+        if( HasFinished() )
+        {
+            return { static_cast<double>( current_value ), 0, 0 };
+        }
+
+        if( runtime_calculation )
+        {
+            return SegmentDerivatives( segment_index, elapsed_time + frame_fraction, current_start_value );
+        }
+
+        return DerivativesAt( baked_cursor + frame_fraction );
+    }
+
+    /** Get current velocity, in value per frame */
+    inline double GetCurrentVelocity() const
+    {
+        return GetCurrentDerivatives().first;
+    }
+
+    /** Get current acceleration, in value per frame squared */
+    inline double GetCurrentAcceleration() const
+    {
+        return GetCurrentDerivatives().second;
+    }
+
+    /** Jump to a given frame since the start, as if AdvanceToNext() was called that many times after Reset() */
+    void Seek( TimeType frame )
+    {
+        if( runtime_calculation )
+        {
+            SeekPlan( frame );
+            return;
         }
+
+        // Precomputed values are kept whole, only the cursor moves
+        baked_cursor = std::min<size_t>( frame, GetBakedCount() );
+        current_value = baked_value = ( baked_cursor == 0 ? start_value : GetBakedValue( baked_cursor-1 ) );
+        frame_fraction = 0;
     }
     
+    /** Move the plan cursor to a given frame since the start */
+    void SeekPlan( TimeType frame )
+    {
+        if( segment_end_values.empty() )
+        {
+            Reset();
+            return;
+        }
+
+        current_value = baked_value = EvaluateAt( frame );
+        frame_fraction = 0;
+        PositionPlan( frame );
+
+        stream_frame = frame;
+        stream_value = current_value;
+    }
+
+    /** Set segment index, elapsed time and segment range for a given frame since the start */
+    void PositionPlan( TimeType frame )
+    {
+        if( frame == 0 )
+        {
+            segment_index = 0;
+            elapsed_time = plan->GetInitialElapsed();
+            current_start_value = Math::FromDouble( start_value );
+            current_end_value = segment_end_values.front();
+            return;
+        }
+
+        if( frame >= plan->GetPlayedDuration() )
+        {
+            segment_index = plan->GetSegmentCount();
+            elapsed_time = 0;
+            current_start_value = current_end_value = segment_end_values.back();
+            return;
+        }
+
+        segment_index = plan->FindSegment( frame );
+        elapsed_time = plan->GetSegmentElapsed( segment_index, frame );
+        current_start_value = ( segment_index == 0 ? Math::FromDouble( start_value ) : segment_end_values[segment_index-1] );
+        current_end_value = segment_end_values[segment_index];
+
+        // Segment completed on this very frame, the next one is due
+        if( elapsed_time == (*plan)[segment_index].end_frame )
+        {
+            elapsed_time = 0;
+            current_start_value = current_end_value;
+            current_end_value = segment_end_values[++segment_index];
+        }
+    }
+
     /** Fill interpolation vector */
     void FillInterpolationVector()
     {
+        const StatsTimer timer( StatsCounter::BAKE_NS );
+        Stats::Add( StatsCounter::BAKES );
+        Stats::Add( StatsCounter::BAKE_BYTES, total_duration * sizeof(ValueType) );
+
         interpolated_values.clear();
+        interpolated_values.reserve( total_duration );
 
         // Calculate easing values
         for( decltype(total_duration) t = 0; t < total_duration; ++t )
@@ -181,6 +510,85 @@ public:
         Reset();
     }
 
+    /** Replace the interpolated values with a compressed curve, releasing their memory */
+    void CompressInterpolationVector()
+    {
+        const StatsTimer timer( StatsCounter::BAKE_NS );
+
+        compressed_curve = std::make_shared<const CompressedCurve>(
+            CompressedCurve::Fit( interpolated_values.begin(), interpolated_values.end(), compression_error ) );
+        Interpolated().swap( interpolated_values );
+    }
+
+    /** Start streamed baking, only the first chunk is baked up front */
+    void StartStreaming()
+    {
+        interpolated_values.clear();
+        interpolated_values.reserve( std::min<size_t>( stream_chunk, total_duration ) );
+        streamed_count = total_duration;
+
+        if( streamed_count > 0 )
+        {
+            BakeChunk( 0 );
+        }
+    }
+
+    /** Bake the streamed chunk holding a given value, replacing the resident one */
+    void BakeChunk( size_t i )
+    {
+        const auto begin = i / stream_chunk * stream_chunk;
+        const auto end = std::min( begin + stream_chunk, streamed_count );
+        const auto played_value = current_value;
+
+        const StatsTimer timer( StatsCounter::BAKE_NS );
+        Stats::Add( StatsCounter::BAKES );
+        Stats::Add( StatsCounter::BAKE_BYTES, (end - begin) * sizeof(ValueType) );
+
+        // Chunks are baked in order while playing forward, seeking moves the plan cursor instead
+        if( begin != stream_frame )
+        {
+            stream_value = EvaluateAt( static_cast<TimeType>( begin ) );
+            PositionPlan( static_cast<TimeType>( begin ) );
+        }
+
+        current_value = stream_value;
+        interpolated_values.clear();
+        for( auto f = begin; f < end; ++f )
+        {
+            CalculateNext();
+            interpolated_values.emplace_back( current_value );
+        }
+
+        window_begin = begin;
+        stream_frame = end;
+        stream_value = current_value;
+        current_value = played_value;
+    }
+
+    /** Use the shared normalized curve of the plan, baking it only if no other motion did */
+    void AcquireSharedCurve()
+    {
+        interpolated_values.clear();
+
+        shared_curve = BakedCurveCache<EasingPolicy>::Instance().Acquire( *plan,
+            [this]()
+            {
+                MotionCore<double, EasingPolicy> unit( false );
+                unit.SetStartingValue( 0 );
+                unit.SetEndingValue( 1 );
+                unit.SetMotionPlan( plan );
+                return BakedSamples( unit.GetInterpolatedValues().begin(), unit.GetInterpolatedValues().end() );
+            }
+        );
+
+        // Range too small for the normalized curve to animate, bake our own
+        if( shared_curve->empty() )
+        {
+            shared_curve.reset();
+            FillInterpolationVector();
+        }
+    }
+
 
 /** ACCESSORS */
 
@@ -192,7 +600,7 @@ public:
     }
 
     /** Get current value */
-    inline ValueType GetCurrentValue()
+    inline ValueType GetCurrentValue() const
     {
         return current_value;
     }
@@ -225,6 +633,13 @@ public:
     inline void SetFrameDuration( TimeType frameDuration )
     {
         total_duration = frameDuration;
+
+        // Segment boundaries depend on the duration
+        if( plan && plan->GetFrameDuration() != total_duration && plan->HasSource() )
+        {
+            plan = own_plan.Compile<EasingPolicy>( *plan, total_duration, plan );
+            math.Prepare( *plan );
+        }
     } 
     
     /** Get frame duration */
@@ -233,52 +648,229 @@ public:
         return total_duration;
     }
     
-    /** Set motion parameters queue */
-    inline void SetMotionQueue( MotionQueue<ValueType>&& params )
+    /** Set motion parameters queue ( compiled into the plan, which keeps it ) */
+    inline void SetMotionQueue( const MotionQueue<ValueType>& params )
     {
-        motion_queue = MotionQueue<ValueType>( std::move(params) );
-        // Calculate new ending value
-        current_start_value = start_value;
-        current_end_value = start_value + (end_value-start_value) * motion_queue.back().length;
-        
-        if( std::fabs(current_start_value - current_end_value) <= std::numeric_limits<decltype(current_start_value)>::epsilon() )
+        SetMotionPlan( own_plan.Compile<EasingPolicy>( params, total_duration, plan ) );
+    }
+
+    /** Set precompiled motion plan ( may be shared, sets the frame duration too ) */
+    inline void SetMotionPlan( MotionPlanPtr motion_plan )
+    {
+        plan = std::move( motion_plan );
+        math.Prepare( *plan );
+        total_duration = plan->GetFrameDuration();
+        shared_curve.reset();
+        mapped_curve.reset();
+        compressed_curve.reset();
+        window_begin = 0;
+        streamed_count = 0;
+        Reset();
+
+        if( HasPlanFinished() )
         {
-            motion_queue.clear();
             interpolated_values.clear();
-            Reset();
-            return;
         }
+        else if( !runtime_calculation )
+        {
+            if( shared_baking )
+            {
+                AcquireSharedCurve();
+            }
+            else if( streamed_baking )
+            {
+                StartStreaming();
+            }
+            else
+            {
+                FillInterpolationVector();
+                if( compression_error > 0 )
+                {
+                    CompressInterpolationVector();
+                }
+            }
+        }
+
+        SelectBakedSource();
+    }
+
+    /** Pick where precomputed values are played from, once per plan, so stepping through them does not branch on it */
+    void SelectBakedSource()
+    {
+        unit_samples = nullptr;
+        unit_offset = 0;
+        unit_scale = 1;
+        buffered = false;
 
-        if( !runtime_calculation )
+        if( mapped_curve )
         {
-            FillInterpolationVector();
-        } 
+            baked_count = mapped_curve->GetSampleCount();
+            if( mapped_curve->GetHeader().format == SampleFormat::F64 )
+            {
+                unit_samples = static_cast<const double*>( mapped_curve->GetSamples() );
+            }
+        }
+        else if( shared_curve )
+        {
+            baked_count = shared_curve->size();
+            unit_samples = shared_curve->data();
+            unit_offset = static_cast<double>( start_value );
+            unit_scale = static_cast<double>( end_value - start_value );
+        }
+        else if( compressed_curve )
+        {
+            baked_count = compressed_curve->GetSampleCount();
+        }
+        else
+        {
+            baked_count = ( streamed_count ? streamed_count : interpolated_values.size() );
+            buffered = ( streamed_count == 0 );
+        }
+    }
+
+    /** Get motion parameters queue, rebuilt from the plan ( empty without one ) */
+    inline MotionQueue<ValueType> GetMotionQueue() const
+    {
+        return plan ? plan->template GetQueue<ValueType>() : MotionQueue<ValueType>();
     }
 
-    /** Get motion parameters queue */
-    inline MotionQueue<ValueType>& GetMotionQueue()
+    /** Get precompiled motion plan ( a copy when compiled from the own queue, later parameter changes don't touch it ) */
+    inline MotionPlanPtr GetMotionPlan() const
     {
-        return motion_queue;
+        return own_plan.Share( plan );
     }
 
-    /** Get interpolated values queue */
+    /** Get interpolated values ( all of them including the ones already played, the resident chunk when streaming, none when compressed ) */
     inline const Interpolated& GetInterpolatedValues()
     {
         return interpolated_values;
     }
+
+    /** Get index of the current plan segment ( the segment count once the plan has been played through ) */
+    inline size_t GetSegmentIndex()
+    {
+        return segment_index;
+    }
+
+    /** Get index of the next interpolated value to play */
+    inline size_t GetInterpolatedCursor()
+    {
+        return baked_cursor;
+    }
+
+    /** Play a memory mapped curve file, taking its values, duration and queue ( no samples are copied ) */
+    void SetMappedCurve( MappedCurvePtr curve )
+    {
+        const auto& header = curve->GetHeader();
+        start_value = static_cast<ValueType>( header.start_value );
+        end_value = static_cast<ValueType>( header.end_value );
+        total_duration = static_cast<TimeType>( header.frame_duration );
+        runtime_calculation = false;
+
+        // The plan is kept for EvaluateAt() and SeekPlan()
+        plan = own_plan.Compile<EasingPolicy>( curve->GetQueue<ValueType>(), total_duration, plan );
+        math.Prepare( *plan );
+        interpolated_values.clear();
+        shared_curve.reset();
+        compressed_curve.reset();
+        window_begin = 0;
+        streamed_count = 0;
+        mapped_curve = std::move( curve );
+        Reset();
+        SelectBakedSource();
+    }
+
+    /** Map and play a curve file, returns false if it is missing or invalid */
+    inline bool LoadCurveFile( const std::string& path )
+    {
+        auto curve = MappedCurve::Open( path );
+        if( !curve )
+        {
+            return false;
+        }
+
+        SetMappedCurve( std::move(curve) );
+        return true;
+    }
+
+    /** Write precomputed values to a curve file, returns false on I/O failure */
+    inline bool SaveCurveFile( const std::string& path, SampleFormat format = SampleFormat::F64 )
+    {
+        std::vector<double> values( GetBakedCount() );
+        for( size_t i = 0; i < values.size(); ++i )
+        {
+            values[i] = static_cast<double>( GetBakedValue( i ) );
+        }
+        return WriteCurveFile( path, values.begin(), values.end(), start_value, end_value, total_duration, GetMotionQueue(), format );
+    }
+
+    /** Get mapped curve ( null unless a curve file is played ) */
+    inline const MappedCurvePtr& GetMappedCurve()
+    {
+        return mapped_curve;
+    }
+
+    /** Get number of precomputed values, own, streamed, shared or mapped */
+    inline size_t GetBakedCount() const
+    {
+        return baked_count;
+    }
+
+    /** Get precomputed value, scaling the shared curve into the motion range ( bakes its chunk when streaming ) */
+    inline ValueType GetBakedValue( size_t i )
+    {
+        if( buffered )
+        {
+            return interpolated_values[i];
+        }
+
+        if( unit_samples )
+        {
+            return static_cast<ValueType>( unit_offset + unit_scale * unit_samples[i] );
+        }
+
+        if( mapped_curve )
+        {
+            return static_cast<ValueType>( mapped_curve->GetSample( i ) );
+        }
+
+        if( compressed_curve )
+        {
+            return compressed_curve->template Get<ValueType>( i );
+        }
+
+        if( i - window_begin >= interpolated_values.size() )
+        {
+            BakeChunk( i );
+        }
+
+        return interpolated_values[i - window_begin];
+    }
+
+    /** Get shared normalized curve ( null unless shared baking is in use ) */
+    inline const BakedCurvePtr& GetSharedCurve()
+    {
+        return shared_curve;
+    }
+
+    /** Get compressed curve ( null unless compressed baking is in use ) */
+    inline const CompressedCurvePtr& GetCompressedCurve()
+    {
+        return compressed_curve;
+    }
     
     /** Set parameters */
     inline void SetParameters(
         ValueType start_value,
         ValueType end_value,
         TimeType frame_duration,
-        MotionQueue<ValueType> params )
+        const MotionQueue<ValueType>& params )
     {
         SetStartingValue( start_value );
         SetEndingValue( end_value );
-        SetFrameDuration( frame_duration );
+        total_duration = frame_duration;    // the old queue is replaced, no need to recompile it
         SetCurrentValue( start_value );
-        SetMotionQueue( std::move(params) );
+        SetMotionQueue( params );
     }
     
     /** Set linear parameters */
@@ -293,7 +885,7 @@ public:
     {
         SetStartingValue( start_value );
         SetEndingValue( end_value );
-        SetFrameDuration( frame_duration );
+        total_duration = frame_duration;    // the old queue is replaced, no need to recompile it
         SetCurrentValue( start_value );
         SetMotionQueue( 
             {
@@ -310,13 +902,39 @@ public:
         runtime_calculation = runtime;
     }
 
+    /** Set shared baking flag ( precomputed values come from a curve shared by equal plans ) */
+    inline void SetSharedBaking( bool shared )
+    {
+        shared_baking = shared;
+    }
+
+    /** Set streamed baking flag ( precomputed values are baked a chunk at a time while playing, keeping one chunk resident ) */
+    inline void SetStreamedBaking( bool streamed, size_t chunk = DefaultStreamChunk )
+    {
+        streamed_baking = streamed;
+        stream_chunk = std::max<size_t>( chunk, 1 );
+    }
+
+    /** Set compressed baking, baked values are fitted with cubic segments within max_error and dropped ( 0 keeps them,
+     *  integral values are rounded back, so any error below 0.5 plays them exactly ) */
+    inline void SetCompression( double max_error )
+    {
+        compression_error = max_error;
+    }
+
+    /** Get streamed baking flag */
+    inline bool IsStreamed() const
+    {
+        return streamed_count > 0;
+    }
+
     /** Dump interpolated values to file for plotting */
     inline void DumpToFile( const std::string& path )
     {
         std::ofstream file( path == std::string() ? "motion_plot.xls" : path );
-        for( const auto value : interpolated_values )
+        for( size_t i = 0; i < GetBakedCount(); ++i )
         {
-            file << value << std::endl;
+            file << GetBakedValue( i ) << '\n';
         }
         file.close();
     }
@@ -324,46 +942,28 @@ public:
     /** Calculate current animation value */
     bool CalculateCurrentEasingValue()
     {
-        const auto& element = motion_queue.back();
-
-        // Calculate current motion progress
-        auto progress = static_cast<double>(element.elapsed_time) / (total_duration * element.duration);
+        const auto& segment = (*plan)[segment_index];
 
         // Check for progress completion
-        if( std::fabs(1.0 - progress) <= 0.1 )
+        if( elapsed_time == segment.end_frame )
         {
-            current_value = current_end_value;
+            current_value = Math::template ToValue<ValueType>( current_end_value );
             return true;
         }
-        else if( progress < std::numeric_limits<decltype(progress)>::epsilon() )
-        {
-            progress = std::numeric_limits<decltype(progress)>::epsilon();
-        }
-
-        // Calculate current step
-        double step = EasingFunctions::GetFunctionValue( progress,
-                                                         static_cast<double>(element.start_value),
-                                                         static_cast<double>(element.end_value),
-                                                         element.motion_type,
-                                                         element.accel_type,
-                                                         element.modifier,
-                                                         element.gravity );
 
         // Calculate new value
-        auto length = std::fabs(current_end_value - current_start_value);
-        step *= length;
-
-        if( current_start_value > current_end_value )
-        {
-            current_value = (length - step) + current_end_value;
-        }
-        else
-        {
-            current_value = step + current_start_value;
-        }
-
+        current_value = Math::template ToValue<ValueType>( Math::Apply( math.Step( *plan, segment_index, elapsed_time ), current_start_value, current_end_value ) );
         return false;
     }
+
+    /** Get value derivatives of a plan segment at a given, possibly fractional, elapsed time, scaled by its range */
+    inline EasingDerivatives SegmentDerivatives( size_t i, double elapsed, Scalar segment_start ) const
+    {
+        const auto step = (*plan)[i].template Derivatives<EasingPolicy>( elapsed );
+        const auto from = Math::ToDouble( segment_start );
+        const auto range = Math::ToDouble( segment_end_values[i] ) - from;
+        return { from + range * step.value, range * step.first, range * step.second };
+    }
     
 }; // class MotionCore
 
@@ -0,0 +1,387 @@
+/** --------------------------------------------------------
+ *
+ *                   MOTION MATH
+ *
+ * Arithmetic used by the motion classes to turn a plan
+ *   segment and an elapsed time into a value.
+ *
+ * Every value type evaluates the easing functions in floating
+ *   point by default, so cores, vector cores and motion systems
+ *    step alike. Integral types may opt in to a fixed point
+ *     pipeline ( FixedPointMath, Q16.16 unless configured ): the
+ *      eased steps are tabulated once per easing, and every
+ *       frame is a table lookup, an interpolation and a few
+ *        integer operations, with no floating point or libm
+ *         calls, for targets with weak or no FPU.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_MATH_H
+#define MOTION_MATH_H
+
+#include <vector>
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "MotionPlan.h"
+#include "MotionStats.h"
+
+namespace Motion
+{
+
+/** Floating point arithmetic, evaluating the easing every frame */
+template<typename EasingPolicy = DynamicEasing>
+struct FloatingPointMath
+{
+    /** Type of segment values */
+    using Scalar = double;
+
+    /** Type of eased steps */
+    using Fraction = double;
+
+    /** Get ready for a plan */
+    inline void Prepare( const MotionPlan& )
+    {}
+
+    /** Get eased step of a plan segment */
+    template<typename Elapsed>
+    inline Fraction Step( const MotionPlan& plan, size_t i, Elapsed elapsed ) const
+    {
+        return plan[i].template Step<EasingPolicy>( elapsed );
+    }
+
+    /** Get segment value from its eased step */
+    static inline Scalar Apply( Fraction step, Scalar start_value, Scalar end_value )
+    {
+        return MotionPlanSegment::Apply( step, start_value, end_value );
+    }
+
+    /** Convert from a plain value */
+    static inline Scalar FromDouble( double value )
+    {
+        return value;
+    }
+
+    /** Convert to a plain value */
+    static inline double ToDouble( Scalar value )
+    {
+        return value;
+    }
+
+    /** Convert to a motion value */
+    template<typename ValueType>
+    static inline ValueType ToValue( Scalar value )
+    {
+        return static_cast<ValueType>( value );
+    }
+};
+
+/** Samples of the fixed point step tables per unit of progress */
+constexpr size_t FixedStepResolution = 1024;
+
+/** Progress covered by the fixed point step tables ( segments complete up to 10% late ) */
+constexpr size_t FixedStepRange = 2;
+
+/** Fixed point eased steps over progress 0 to FixedStepRange */
+using FixedStepTable = std::vector<int32_t>;
+
+/** Process-wide cache of step tables, one per easing ( type, acceleration, modifiers, bezier points and window ) */
+template<typename EasingPolicy, unsigned FractionBits>
+class FixedStepTableCache
+{
+public:
+
+    /** Everything a step table depends on */
+    using Key = std::array<double, 12>;
+
+private:
+
+    /** Guards the tables and the purge threshold */
+    std::mutex mutex;
+
+    /** Tables by easing */
+    std::map<Key, std::weak_ptr<const FixedStepTable>> tables;
+
+    /** Map size at which released tables get purged */
+    size_t purge_threshold { 64 };
+
+public:
+
+    /** Get the process-wide cache */
+    static FixedStepTableCache& Instance()
+    {
+        static FixedStepTableCache cache;
+        return cache;
+    }
+
+    /** Build cache key of a segment's easing */
+    static Key MakeKey( const MotionPlanSegment& segment )
+    {
+        const auto bezier = ( segment.bezier ? segment.bezier->GetPoints() : BezierPoints{ 0, 0, 0, 0 } );
+        return {
+            static_cast<double>( segment.motion_type ), static_cast<double>( segment.accel_type ),
+            segment.modifier + 0.0, segment.gravity + 0.0,
+            segment.window_from + 0.0, segment.window_span + 0.0, segment.window_start + 0.0, segment.window_scale + 0.0,
+            bezier.x1 + 0.0, bezier.y1 + 0.0, bezier.x2 + 0.0, bezier.y2 + 0.0 };
+    }
+
+    /** Get the step table of a segment's easing, building it on a miss */
+    std::shared_ptr<const FixedStepTable> Acquire( const MotionPlanSegment& segment )
+    {
+        return Acquire( MakeKey( segment ), segment );
+    }
+
+    /** Get the step table of a segment's easing by its key, building it on a miss ( outside the lock ) */
+    std::shared_ptr<const FixedStepTable> Acquire( const Key& key, const MotionPlanSegment& segment )
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+
+            const auto it = tables.find( key );
+            if( it != tables.end() )
+            {
+                if( auto table = it->second.lock() )
+                {
+                    Stats::Add( StatsCounter::STEP_TABLE_HITS );
+                    return table;
+                }
+            }
+        }
+
+        Stats::Add( StatsCounter::STEP_TABLE_MISSES );
+        auto table = std::make_shared<const FixedStepTable>( Build( segment ) );
+
+        std::lock_guard<std::mutex> lock( mutex );
+
+        // Another thread may have built the same table meanwhile, the one already shared wins
+        const auto it = tables.find( key );
+        if( it != tables.end() )
+        {
+            if( auto built = it->second.lock() )
+            {
+                return built;
+            }
+            it->second = table;
+            return table;
+        }
+
+        if( tables.size() >= purge_threshold )
+        {
+            Purge();
+            purge_threshold = 2 * tables.size() + 64;
+        }
+
+        tables.emplace( key, table );
+        return table;
+    }
+
+private:
+
+    /** Drop entries of released tables */
+    void Purge()
+    {
+        for( auto it = tables.begin(); it != tables.end(); )
+        {
+            if( it->second.expired() )
+            {
+                it = tables.erase( it );
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    /** Tabulate the eased steps of a segment over progress */
+    static FixedStepTable Build( MotionPlanSegment segment )
+    {
+        constexpr double one = double( int64_t(1) << FractionBits );
+        constexpr double limit = std::numeric_limits<int32_t>::max();
+
+        // With this scale an elapsed time of k is a progress of k / FixedStepResolution
+        segment.frame_scale = FixedStepResolution;
+
+        FixedStepTable table( FixedStepRange * FixedStepResolution + 1 );
+        for( size_t k = 0; k < table.size(); ++k )
+        {
+            auto step = segment.Step<EasingPolicy>( static_cast<double>( k ) ) * one;
+
+            // Elastic and Bounce are NaN right at the end of the easing and Circular past it, where it has ended
+            if( std::isnan( step ) )
+            {
+                step = ( k >= FixedStepResolution ? one : 0.0 );
+            }
+
+            const auto clamped = ( step > limit ? limit : ( step < -limit ? -limit : step ) );
+            table[k] = static_cast<int32_t>( clamped + ( clamped < 0 ? -0.5 : 0.5 ) );
+        }
+        return table;
+    }
+
+}; // class FixedStepTableCache
+
+/** Fixed point arithmetic with a given number of fraction bits, for integral values */
+template<typename EasingPolicy = DynamicEasing, unsigned FractionBits = 16>
+struct FixedPointMath
+{
+    static_assert( FractionBits > 0 && FractionBits <= 24, "Steps and value fractions must fit 32 bits" );
+
+    /** Type of segment values ( fixed point ) */
+    using Scalar = int64_t;
+
+    /** Type of eased steps ( fixed point ) */
+    using Fraction = int32_t;
+
+    /** Fixed point one */
+    static constexpr Scalar One = Scalar(1) << FractionBits;
+
+    /** Fraction bits of table positions */
+    static constexpr unsigned PositionBits = 32;
+
+    /** Process-wide step tables */
+    using TableCache = FixedStepTableCache<EasingPolicy, FractionBits>;
+
+    /** Step table of a plan segment */
+    struct SegmentTable
+    {
+        /** Easing the steps were built for */
+        typename TableCache::Key key {};
+
+        /** Eased steps, shared by segments with the same easing */
+        std::shared_ptr<const FixedStepTable> steps;
+
+        /** Table position advanced per elapsed frame ( PositionBits fraction bits ) */
+        uint64_t position_step {};
+
+        /** Elapsed time from which the last table entry is used */
+        TimeType last_elapsed {};
+    };
+
+    /** Step tables of the current plan, by segment */
+    std::vector<SegmentTable> segment_tables;
+
+    /** Get ready for a plan, acquiring the step tables of its segments ( tables of unchanged easings are kept, without locking the cache ) */
+    void Prepare( const MotionPlan& plan )
+    {
+        auto& cache = TableCache::Instance();
+        constexpr double position_one = double( uint64_t(1) << PositionBits );
+
+        segment_tables.reserve( std::max( plan.GetSegmentCount(), MotionQueueCapacity ) );
+        segment_tables.resize( plan.GetSegmentCount() );
+        for( size_t i = 0; i < plan.GetSegmentCount(); ++i )
+        {
+            const auto& segment = plan[i];
+            auto& table = segment_tables[i];
+            const auto key = TableCache::MakeKey( segment );
+            if( !table.steps || table.key != key )
+            {
+                table.steps = cache.Acquire( key, segment );
+                table.key = key;
+            }
+
+            // Elapsed times past the table range, or segments that never progress, use the last entry
+            const double range = segment.frame_scale * FixedStepRange;
+            if( segment.frame_scale > 0 && range < MotionPlanSegment::Never )
+            {
+                table.position_step = static_cast<uint64_t>( FixedStepResolution * position_one / segment.frame_scale + 0.5 );
+                table.last_elapsed = static_cast<TimeType>( range );
+            }
+            else
+            {
+                table.position_step = 0;
+                table.last_elapsed = 0;
+            }
+        }
+    }
+
+    /** Get eased step of a plan segment at a whole elapsed time */
+    inline Fraction Step( const MotionPlan&, size_t i, TimeType elapsed ) const
+    {
+        const auto& table = segment_tables[i];
+        if( elapsed >= table.last_elapsed )
+        {
+            return table.steps->back();
+        }
+
+        return Lookup( *table.steps, elapsed * table.position_step );
+    }
+
+    /** Get eased step of a plan segment at a fractional elapsed time */
+    inline Fraction Step( const MotionPlan&, size_t i, double elapsed ) const
+    {
+        const auto& table = segment_tables[i];
+        if( !( elapsed < table.last_elapsed ) )
+        {
+            return table.steps->back();
+        }
+
+        return Lookup( *table.steps, static_cast<uint64_t>( elapsed * table.position_step ) );
+    }
+
+    /** Get segment value from its eased step ( start + (end - start) * step, without overflowing 64 bits ) */
+    static inline Scalar Apply( Fraction step, Scalar start_value, Scalar end_value )
+    {
+        const auto range = end_value - start_value;
+        const auto whole = range >> FractionBits;
+        const auto fraction = range & (One - 1);
+        return start_value + whole * step + ( ( fraction * step ) >> FractionBits );
+    }
+
+    /** Convert from a plain value ( setup only ) */
+    static inline Scalar FromDouble( double value )
+    {
+        return static_cast<Scalar>( value * One + ( value < 0 ? -0.5 : 0.5 ) );
+    }
+
+    /** Convert to a plain value ( queries only ) */
+    static inline double ToDouble( Scalar value )
+    {
+        return static_cast<double>( value ) / One;
+    }
+
+    /** Convert to a motion value, truncating toward zero like a cast from double */
+    template<typename ValueType>
+    static inline ValueType ToValue( Scalar value )
+    {
+        return static_cast<ValueType>( value / One );
+    }
+
+private:
+
+    /** Interpolate table entries at a position */
+    static inline Fraction Lookup( const FixedStepTable& steps, uint64_t position )
+    {
+        const auto index = static_cast<size_t>( position >> PositionBits );
+        if( index + 1 >= steps.size() )
+        {
+            return steps.back();
+        }
+
+        const auto weight = static_cast<int64_t>( ( position >> (PositionBits - 16) ) & 0xFFFF );
+        const auto low = steps[index];
+        return static_cast<Fraction>( low + ( ( ( int64_t( steps[index+1] ) - low ) * weight ) >> 16 ) );
+    }
+};
+
+/** Arithmetic used for a value type ( floating point, fixed point is chosen explicitly with FixedPointMath ) */
+template<typename ValueType, typename EasingPolicy, typename = void>
+struct MathOf
+{
+    using type = FloatingPointMath<EasingPolicy>;
+};
+
+/** Default arithmetic of a value type */
+template<typename ValueType, typename EasingPolicy = DynamicEasing>
+using DefaultMath = typename MathOf<ValueType, EasingPolicy>::type;
+
+} // namespace Motion
+
+#endif /** MOTION_MATH_H */
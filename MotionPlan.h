@@ -0,0 +1,486 @@
+/** --------------------------------------------------------
+ *
+ *                   MOTION PLAN
+ *
+ * Immutable, precompiled form of a motion parameters queue.
+ *
+ * Everything that stays constant for a whole segment (frame
+ *   boundaries, easing window endpoints, value fractions)
+ *    is computed once, so that every frame costs a single
+ *     easing call. Plans hold no start/end values, so one
+ *      plan can be shared by any number of motions.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_PLAN_H
+#define MOTION_PLAN_H
+
+#include <vector>
+#include <memory>
+#include <limits>
+#include <algorithm>
+
+#include "EasingFunctions.h"
+#include "InlineVector.h"
+
+namespace Motion
+{
+
+using TimeType = uint32_t;
+
+/** Singme motion parameters */
+template<typename ValueType>
+struct MotionParameters
+{
+    /** Type of easing */
+    Type motion_type;
+
+    /** Type of easing */
+    Acceleration accel_type;
+
+    /** Duration of the animation (fraction of the total) */
+    double duration {0.5};
+
+    /** Length of the animation (fraction of the total) */
+    double length {0.5};
+
+    /** Starting value of the function */
+    ValueType start_value {0};
+
+    /** Ending value of the function */
+    ValueType end_value {1};
+
+    /** Extra modifier for Bounce/Elastic/Pow/Exponential */
+    double modifier {};
+
+    /** Gravity modifier for Bounce/Elastic */
+    double gravity {};
+
+    /** Control points for Bezier */
+    BezierPoints bezier {};
+
+    /** Elapsed time */
+    TimeType elapsed_time {};
+};
+
+/** Number of queue entries held without allocating */
+constexpr size_t MotionQueueCapacity = 8;
+
+/** Motion parameters queue type ( longer queues spill over to the heap ) */
+template<typename ValueType>
+using MotionQueue = InlineVector<MotionParameters<ValueType>, MotionQueueCapacity>;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+/** Precompiled motion segment */
+struct MotionPlanSegment
+{
+    /** Elapsed time value that never completes a segment */
+    static constexpr TimeType Never = std::numeric_limits<TimeType>::max();
+
+    /** Type of easing */
+    Type motion_type;
+
+    /** Type of acceleration */
+    Acceleration accel_type;
+
+    /** Extra modifier for Bounce/Elastic/Pow/Exponential */
+    double modifier {};
+
+    /** Gravity modifier for Bounce/Elastic */
+    double gravity {};
+
+    /** Curve solver for Bezier ( null for other easings ) */
+    std::shared_ptr<const CubicBezier> bezier;
+
+    /** Segment duration in frames ( total duration * duration fraction ) */
+    double frame_scale {};
+
+    /** Elapsed time at which the segment completes */
+    TimeType end_frame { Never };
+
+    /** Plan frame at which the segment starts playing ( frames played by all previous segments ) */
+    TimeType start_frame {};
+
+    /** Length of the segment (fraction of the total) */
+    double length {};
+
+    /** Start of the easing window */
+    double window_from {0};
+
+    /** Width of the easing window */
+    double window_span {1};
+
+    /** Eased value at the start of the window */
+    double window_start {0};
+
+    /** Eased value range of the window */
+    double window_scale {1};
+
+    /** Get eased step ( 0 to 1 ) at a given, possibly fractional, elapsed time */
+    template<typename EasingPolicy = DynamicEasing>
+    inline double Step( double elapsed ) const
+    {
+        auto progress = elapsed / frame_scale;
+        if( progress < std::numeric_limits<decltype(progress)>::epsilon() )
+        {
+            progress = std::numeric_limits<decltype(progress)>::epsilon();
+        }
+
+        const auto c = EasingPolicy::Evaluate( progress*window_span + window_from, 0.0, 1.0, motion_type, accel_type, modifier, gravity, bezier.get() );
+        return (c - window_start) / window_scale;
+    }
+
+    /** Get eased step and its derivatives per frame at a given, possibly fractional, elapsed time */
+    template<typename EasingPolicy = DynamicEasing>
+    inline EasingDerivatives Derivatives( double elapsed ) const
+    {
+        auto progress = elapsed / frame_scale;
+        if( progress < std::numeric_limits<decltype(progress)>::epsilon() )
+        {
+            progress = std::numeric_limits<decltype(progress)>::epsilon();
+        }
+
+        // Chain rule through the window and the segment duration
+        const auto c = EasingPolicy::Derivatives( progress*window_span + window_from, 0.0, 1.0, motion_type, accel_type, modifier, gravity, bezier.get() );
+        const auto scale = window_span / ( window_scale * frame_scale );
+        return { (c.value - window_start) / window_scale, c.first * scale, c.second * scale * window_span / frame_scale };
+    }
+
+    /** Get segment value from its eased step, the same way MotionCore always did */
+    static inline double Apply( double step, double start_value, double end_value )
+    {
+        const auto length = std::fabs(end_value - start_value);
+        step *= length;
+
+        if( start_value > end_value )
+        {
+            return (length - step) + end_value;
+        }
+        else
+        {
+            return step + start_value;
+        }
+    }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+/** Immutable precompiled motion queue */
+class MotionPlan
+{
+    using Segments = std::vector<MotionPlanSegment>;
+    using Source = std::vector<MotionParameters<double>>;
+
+private:
+
+    /** Segments in playback order */
+    Segments segments;
+
+    /** Queue the plan was compiled from, in queue order ( kept out of the motions for retiming and curve files ) */
+    Source source;
+
+    /** Total duration in frames */
+    TimeType total_duration {};
+
+    /** Elapsed time the first segment starts from */
+    TimeType initial_elapsed {};
+
+    /** Plan frame at which the last segment completes */
+    TimeType played_duration {};
+
+public:
+
+    /** Compile motion queue ( consumed from the back, as in MotionCore ) */
+    template<typename EasingPolicy = DynamicEasing, typename ValueType>
+    static std::shared_ptr<const MotionPlan> Compile( const MotionQueue<ValueType>& queue, TimeType total_duration )
+    {
+        auto plan = std::make_shared<MotionPlan>();
+        plan->Rebuild<EasingPolicy>( queue, total_duration );
+        return plan;
+    }
+
+    /** Compile motion queue in place, reusing the segment storage ( only for plans no one else holds ) */
+    template<typename EasingPolicy = DynamicEasing, typename ValueType>
+    void Rebuild( const MotionQueue<ValueType>& queue, TimeType frame_duration )
+    {
+        source.reserve( std::max( queue.size(), MotionQueueCapacity ) );
+        source.clear();
+        for( const auto& element : queue )
+        {
+            source.push_back( { element.motion_type, element.accel_type, element.duration, element.length,
+                                static_cast<double>( element.start_value ), static_cast<double>( element.end_value ),
+                                element.modifier, element.gravity, element.bezier, element.elapsed_time } );
+        }
+
+        CompileSource<EasingPolicy>( frame_duration );
+    }
+
+    /** Compile the queue of another plan in place for a new duration ( only for plans no one else holds ) */
+    template<typename EasingPolicy = DynamicEasing>
+    void Rebuild( const MotionPlan& other, TimeType frame_duration )
+    {
+        if( &other != this )
+        {
+            source.reserve( std::max( other.source.size(), MotionQueueCapacity ) );
+            source.assign( other.source.begin(), other.source.end() );
+        }
+
+        CompileSource<EasingPolicy>( frame_duration );
+    }
+
+    /** Compile the source queue ( consumed from the back, as in MotionCore ) */
+    template<typename EasingPolicy = DynamicEasing>
+    void CompileSource( TimeType frame_duration )
+    {
+        size_t count = 0;
+        played_duration = 0;
+        total_duration = frame_duration;
+        initial_elapsed = ( source.empty() ? 0 : source.back().elapsed_time );
+        segments.reserve( std::max( source.size(), MotionQueueCapacity ) );
+
+        for( auto it = source.rbegin(); it != source.rend(); ++it, ++count )
+        {
+            const auto& element = *it;
+            const auto first = ( count == 0 ? initial_elapsed : TimeType{} );
+
+            MotionPlanSegment segment;
+            segment.motion_type = element.motion_type;
+            segment.accel_type = element.accel_type;
+            segment.modifier = element.modifier;
+            segment.gravity = element.gravity;
+            segment.frame_scale = frame_duration * element.duration;
+            segment.end_frame = FindEndFrame( segment.frame_scale, first );
+            segment.length = element.length;
+
+            // Bezier solver tables are only rebuilt when the control points change
+            if( EasingPolicy::Resolve( element.motion_type ) == Type::BEZIER )
+            {
+                const auto& previous = ( count < segments.size() ? segments[count].bezier : segment.bezier );
+                segment.bezier = ( previous && previous->GetPoints() == element.bezier ? previous : std::make_shared<const CubicBezier>( element.bezier ) );
+            }
+
+            // Easing window, as in EaseNormalized ( linear easing ignores it )
+            const auto from = static_cast<double>(element.start_value);
+            const auto to = static_cast<double>(element.end_value);
+            if( !(from == 0.0 && to == 1.0) && EasingPolicy::Resolve( element.motion_type ) != Type::LINEAR )
+            {
+                const auto ease = [&]( double x )
+                {
+                    return EasingPolicy::Evaluate( x, 0.0, 1.0, element.motion_type, element.accel_type, element.modifier, element.gravity, segment.bezier.get() );
+                };
+
+                const auto f = ( from == 0.0 ? 0.0 : ease( from ) );
+                const auto t = ( to == 1.0 ? 1.0 : ease( to ) );
+                auto d = t-f;
+                const auto delta = std::numeric_limits<decltype(d)>::epsilon();
+                if( d < delta ) d = delta;
+
+                segment.window_from = from;
+                segment.window_span = to-from;
+                segment.window_start = f;
+                segment.window_scale = d;
+            }
+
+            // Prefix sum of segment frame counts, for random access
+            segment.start_frame = played_duration;
+            const auto played = static_cast<uint64_t>(played_duration) + segment.end_frame - first;
+            played_duration = static_cast<TimeType>( std::min<uint64_t>( played, MotionPlanSegment::Never ) );
+
+            if( count < segments.size() )
+            {
+                segments[count] = std::move( segment );
+            }
+            else
+            {
+                segments.emplace_back( std::move( segment ) );
+            }
+        }
+        segments.erase( segments.begin() + count, segments.end() );
+    }
+
+    /** Find index of the segment playing a given plan frame ( binary search, frame 0 is before the first segment ) */
+    inline size_t FindSegment( TimeType frame ) const
+    {
+        if( frame == 0 )
+        {
+            return 0;
+        }
+
+        const auto it = std::upper_bound( segments.begin(), segments.end(), frame - 1,
+            []( TimeType value, const MotionPlanSegment& segment )
+            {
+                return value < segment.start_frame;
+            }
+        );
+
+        return static_cast<size_t>( it - segments.begin() ) - 1;
+    }
+
+    /** Get elapsed time of a segment at a given plan frame */
+    inline TimeType GetSegmentElapsed( size_t i, TimeType frame ) const
+    {
+        return frame - segments[i].start_frame + ( i == 0 ? initial_elapsed : TimeType{} );
+    }
+
+    /** Find first elapsed time after 'first' at which a segment completes ( progress within 10% of the end ) */
+    static TimeType FindEndFrame( double frame_scale, TimeType first )
+    {
+        const auto completes = [frame_scale]( double elapsed )
+        {
+            return std::fabs(1.0 - elapsed / frame_scale) <= 0.1;
+        };
+
+        const double last = frame_scale * 1.1 + 1;
+        double elapsed = std::fmax( static_cast<double>(first) + 1, std::floor( frame_scale * 0.9 ) - 1 );
+        for( ; elapsed <= last && elapsed < MotionPlanSegment::Never; ++elapsed )
+        {
+            if( completes( elapsed ) )
+            {
+                return static_cast<TimeType>( elapsed );
+            }
+        }
+
+        return MotionPlanSegment::Never;
+    }
+
+
+/** ACCESSORS */
+
+
+    /** Get segment by playback index */
+    inline const MotionPlanSegment& operator[]( size_t i ) const
+    {
+        return segments[i];
+    }
+
+    /** Get number of segments */
+    inline size_t GetSegmentCount() const
+    {
+        return segments.size();
+    }
+
+    /** Check if plan has no segments */
+    inline bool IsEmpty() const
+    {
+        return segments.empty();
+    }
+
+    /** Get total duration in frames */
+    inline TimeType GetFrameDuration() const
+    {
+        return total_duration;
+    }
+
+    /** Get elapsed time the first segment starts from */
+    inline TimeType GetInitialElapsed() const
+    {
+        return initial_elapsed;
+    }
+
+    /** Get number of frames until the last segment completes ( Never if some segment never does ) */
+    inline TimeType GetPlayedDuration() const
+    {
+        return played_duration;
+    }
+
+    /** Get segments in playback order */
+    inline const Segments& GetSegments() const
+    {
+        return segments;
+    }
+
+    /** Check if the plan was compiled from a queue with any elements */
+    inline bool HasSource() const
+    {
+        return !source.empty();
+    }
+
+    /** Rebuild the source queue */
+    template<typename ValueType>
+    MotionQueue<ValueType> GetQueue() const
+    {
+        MotionQueue<ValueType> queue;
+        queue.reserve( source.size() );
+        for( const auto& element : source )
+        {
+            queue.push_back( { element.motion_type, element.accel_type, element.duration, element.length,
+                               static_cast<ValueType>( element.start_value ), static_cast<ValueType>( element.end_value ),
+                               element.modifier, element.gravity, element.bezier, element.elapsed_time } );
+        }
+        return queue;
+    }
+
+}; // class MotionPlan
+
+/** Shared immutable plan */
+using MotionPlanPtr = std::shared_ptr<const MotionPlan>;
+
+/** Plan a motion compiles its own queue into, rebuilt in place so restarts don't allocate
+ *  ( it is never handed out, Share() gives an immutable copy, so only the motion and copies of it hold it ) */
+class OwnMotionPlan
+{
+private:
+
+    /** Plan storage */
+    std::shared_ptr<MotionPlan> plan;
+
+    /** Copy handed out since the last rebuild */
+    mutable MotionPlanPtr shared;
+
+public:
+
+    /** Compile a motion queue ( playing: plan the motion plays now ) */
+    template<typename EasingPolicy, typename ValueType>
+    MotionPlanPtr Compile( const MotionQueue<ValueType>& queue, TimeType frame_duration, const MotionPlanPtr& playing )
+    {
+        Detach( playing );
+        plan->Rebuild<EasingPolicy>( queue, frame_duration );
+        return plan;
+    }
+
+    /** Compile the queue of a plan for a new duration, which may be the own plan itself ( playing: plan the motion plays now ) */
+    template<typename EasingPolicy>
+    MotionPlanPtr Compile( const MotionPlan& source, TimeType frame_duration, const MotionPlanPtr& playing )
+    {
+        Detach( playing );
+        plan->Rebuild<EasingPolicy>( source, frame_duration );
+        return plan;
+    }
+
+    /** Get a plan that is safe to hand out: the played plan, or a copy of it if it is the own plan */
+    MotionPlanPtr Share( const MotionPlanPtr& playing ) const
+    {
+        if( !plan || playing != plan )
+        {
+            return playing;
+        }
+
+        if( !shared )
+        {
+            shared = std::make_shared<const MotionPlan>( *plan );
+        }
+        return shared;
+    }
+
+private:
+
+    /** Start a new plan if a copy of the motion still holds the current one ( every holder is a strong reference ) */
+    void Detach( const MotionPlanPtr& playing )
+    {
+        shared.reset();
+        if( !plan || plan.use_count() > ( playing == plan ? 2 : 1 ) )
+        {
+            plan = std::make_shared<MotionPlan>();
+        }
+    }
+
+}; // class OwnMotionPlan
+
+} // namespace Motion
+
+#endif /** MOTION_PLAN_H */
@@ -0,0 +1,224 @@
+/** --------------------------------------------------------
+ *
+ *                   MOTION STATS
+ *
+ * Optional instrumentation of the motion hot paths: easing
+ *   evaluations by type, CalculateNext() calls and time,
+ *    bake time and size, segment transitions and cache hits.
+ *
+ * Counting is off unless MOTION_STATS is defined to 1 for
+ *   the whole program ( every translation unit must agree ).
+ *    When off, every hook is an empty inline function and no
+ *     clock is read, so instrumented code compiles to exactly
+ *      what it was without the hooks.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_STATS_H
+#define MOTION_STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+#ifndef MOTION_STATS
+#define MOTION_STATS 0
+#endif
+
+namespace Motion
+{
+
+/** Instrumentation compile-time switch */
+constexpr bool StatsEnabled = ( MOTION_STATS != 0 );
+
+/** Instrumentation counters */
+enum class StatsCounter : uint8_t
+{
+    CALCULATIONS,           // CalculateNext() calls that advanced a motion
+    CALCULATION_NS,         // Time spent in those calls
+    BAKES,                  // Curves or streamed chunks baked
+    BAKE_NS,                // Time spent baking
+    BAKE_BYTES,             // Bytes of baked values written
+    SEGMENT_TRANSITIONS,    // Plan segments completed while playing
+    CURVE_CACHE_HITS,       // Shared curves found already baked
+    CURVE_CACHE_MISSES,     // Shared curves baked
+    STEP_TABLE_HITS,        // Fixed point step tables found already built
+    STEP_TABLE_MISSES,      // Fixed point step tables built
+    COUNT,
+};
+
+/** Number of counters */
+constexpr size_t StatsCounterCount = static_cast<size_t>( StatsCounter::COUNT );
+
+/** Number of easing type slots counted ( enough for every Type ) */
+constexpr size_t StatsTypeSlots = 16;
+
+/** Counter names, for reports */
+constexpr const char* StatsCounterNames[StatsCounterCount] =
+{
+    "calculations", "calculation_ns", "bakes", "bake_ns", "bake_bytes", "segment_transitions",
+    "curve_cache_hits", "curve_cache_misses", "step_table_hits", "step_table_misses"
+};
+
+/** Copy of the instrumentation counters at one point in time */
+struct StatsSnapshot
+{
+    /** Easing evaluations by Type */
+    std::array<uint64_t, StatsTypeSlots> evaluations {};
+
+    /** Other counters, by StatsCounter */
+    std::array<uint64_t, StatsCounterCount> counters {};
+
+    /** Get counter value */
+    inline uint64_t Get( StatsCounter counter ) const
+    {
+        return counters[static_cast<size_t>( counter )];
+    }
+
+    /** Get total easing evaluations */
+    inline uint64_t GetEvaluations() const
+    {
+        uint64_t total = 0;
+        for( const auto count : evaluations )
+        {
+            total += count;
+        }
+        return total;
+    }
+
+    /** Get average time of a CalculateNext() call in nanoseconds */
+    inline double GetCalculationNanoseconds() const
+    {
+        const auto calculations = Get( StatsCounter::CALCULATIONS );
+        return calculations ? double( Get( StatsCounter::CALCULATION_NS ) ) / calculations : 0.0;
+    }
+
+    /** Get counter growth since an earlier snapshot */
+    inline StatsSnapshot operator-( const StatsSnapshot& earlier ) const
+    {
+        StatsSnapshot delta;
+        for( size_t i = 0; i < StatsTypeSlots; ++i )
+        {
+            delta.evaluations[i] = evaluations[i] - earlier.evaluations[i];
+        }
+        for( size_t i = 0; i < StatsCounterCount; ++i )
+        {
+            delta.counters[i] = counters[i] - earlier.counters[i];
+        }
+        return delta;
+    }
+};
+
+/** Process-wide instrumentation counters ( relaxed atomics, safe to update from any thread ) */
+class Stats
+{
+    /** Counter storage ( zero initialized as a static ) */
+    struct Counters
+    {
+        std::array<std::atomic<uint64_t>, StatsTypeSlots> evaluations;
+        std::array<std::atomic<uint64_t>, StatsCounterCount> counters;
+    };
+
+    /** Counters of the process */
+    inline static Counters storage;
+
+public:
+
+    /** Add to a counter */
+    static inline void Add( StatsCounter counter, uint64_t value = 1 )
+    {
+        if constexpr( StatsEnabled )
+        {
+            storage.counters[static_cast<size_t>( counter )].fetch_add( value, std::memory_order_relaxed );
+        }
+    }
+
+    /** Count an easing evaluation of a given type */
+    static inline void CountEvaluation( size_t type )
+    {
+        if constexpr( StatsEnabled )
+        {
+            storage.evaluations[type % StatsTypeSlots].fetch_add( 1, std::memory_order_relaxed );
+        }
+    }
+
+    /** Get a copy of the counters ( all zero when instrumentation is off ) */
+    static StatsSnapshot Snapshot()
+    {
+        StatsSnapshot snapshot;
+        if constexpr( StatsEnabled )
+        {
+            for( size_t i = 0; i < StatsTypeSlots; ++i )
+            {
+                snapshot.evaluations[i] = storage.evaluations[i].load( std::memory_order_relaxed );
+            }
+            for( size_t i = 0; i < StatsCounterCount; ++i )
+            {
+                snapshot.counters[i] = storage.counters[i].load( std::memory_order_relaxed );
+            }
+        }
+        return snapshot;
+    }
+
+    /** Clear all counters */
+    static void Reset()
+    {
+        if constexpr( StatsEnabled )
+        {
+            for( auto& count : storage.evaluations )
+            {
+                count.store( 0, std::memory_order_relaxed );
+            }
+            for( auto& count : storage.counters )
+            {
+                count.store( 0, std::memory_order_relaxed );
+            }
+        }
+    }
+
+}; // class Stats
+
+/** Adds the time spent in a scope to a counter ( reads no clock when instrumentation is off ) */
+class StatsTimer
+{
+    using Clock = std::chrono::steady_clock;
+
+private:
+
+    /** Counter receiving the time */
+    StatsCounter counter;
+
+    /** Start of the scope */
+    Clock::time_point begin;
+
+public:
+
+    /** Constructor, starts timing */
+    explicit StatsTimer( StatsCounter counter )
+        : counter( counter )
+    {
+        if constexpr( StatsEnabled )
+        {
+            begin = Clock::now();
+        }
+    }
+
+    /** Destructor, adds the elapsed time */
+    ~StatsTimer()
+    {
+        if constexpr( StatsEnabled )
+        {
+            Stats::Add( counter, static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - begin ).count() ) );
+        }
+    }
+
+    StatsTimer( const StatsTimer& ) = delete;
+    StatsTimer& operator=( const StatsTimer& ) = delete;
+
+}; // class StatsTimer
+
+} // namespace Motion
+
+#endif /** MOTION_STATS_H */
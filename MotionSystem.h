@@ -0,0 +1,637 @@
+/** --------------------------------------------------------
+ *
+ *                  MOTION SYSTEM
+ *
+ * Pool of motion channels stored as structure-of-arrays,
+ *   intended for driving thousands of simultaneous
+ *    animations with a single update call per frame.
+ *
+ * Every channel follows the exact same rules as a runtime
+ *   calculated MotionCore, but its state is kept in tightly
+ *    packed arrays instead of separate objects.
+ *
+ * An update records segment transitions and completions in
+ *   a per-frame event buffer, optionally forwarded to a
+ *    lock-free queue, so finished channels are found without
+ *     polling every one of them.
+ *
+ * An update can also publish the values of every channel to
+ *   a triple buffered snapshot, letting another thread read
+ *    whole frames without locks while the next one is computed.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_SYSTEM_H
+#define MOTION_SYSTEM_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+#include "MotionCore.h"
+#include "ThreadPool.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+namespace Motion
+{
+
+/** Stable handle of a motion system channel */
+struct ChannelHandle
+{
+    /** Handle slot index */
+    uint32_t index { std::numeric_limits<uint32_t>::max() };
+
+    /** Slot generation at the time of creation */
+    uint32_t generation {};
+};
+
+/** Kind of a motion event */
+enum class MotionEventType : uint8_t
+{
+    STARTED,        // A timeline run started
+    SEGMENT,        // The next segment of the queue started
+    FINISHED,       // The motion reached its ending value
+};
+
+/** Event of a motion system channel during one update */
+struct MotionEvent
+{
+    /** Channel */
+    ChannelHandle handle;
+
+    /** Segment that started ( SEGMENT ), or the segment count ( FINISHED ) */
+    uint32_t segment {};
+
+    /** Kind of event */
+    MotionEventType type {};
+};
+
+/** Queue handing motion events over to another thread */
+using MotionEventQueue = SpscQueue<MotionEvent>;
+
+/** Values of every motion system channel after an update, indexed by handle */
+template<typename ValueType>
+struct MotionFrame
+{
+    /** Value of each handle slot */
+    std::vector<ValueType> values;
+
+    /** Generation of each handle slot ( a removed channel's slot has moved on ) */
+    std::vector<uint32_t> generations;
+
+    /** Updates run before the frame was published */
+    uint64_t update {};
+
+    /** Check if handle refers to a channel of the frame */
+    inline bool IsValid( ChannelHandle handle ) const
+    {
+        return handle.index < generations.size() && generations[handle.index] == handle.generation;
+    }
+
+    /** Get channel value */
+    inline ValueType GetValue( ChannelHandle handle ) const
+    {
+        return values[handle.index];
+    }
+};
+
+/** Frames of a motion system handed over to another thread */
+template<typename ValueType>
+using MotionSnapshot = TripleBuffer<MotionFrame<ValueType>>;
+
+/** Structure-of-arrays motion pool ( EasingPolicy as in MotionCore ) */
+template<typename ValueType, typename EasingPolicy = DynamicEasing>
+class MotionSystem
+{
+    using ChannelIdx = uint32_t;
+    using SegmentIdx = uint32_t;
+
+    static constexpr ChannelIdx InvalidIdx = std::numeric_limits<ChannelIdx>::max();
+
+    /** Outcome of advancing a channel by one frame */
+    enum class ChannelStep : uint8_t
+    {
+        MOVED,
+        SEGMENT,
+        FINISHED,
+    };
+
+private:
+
+    /** Index of the current segment of each channel */
+    std::vector<SegmentIdx> segment_index;
+
+    /** Index past the last segment of each channel */
+    std::vector<SegmentIdx> segment_last;
+
+    /** Number of segments of each channel's plan */
+    std::vector<SegmentIdx> segment_count;
+
+    /** Elapsed time in the current segment of each channel */
+    std::vector<TimeType> elapsed_time;
+
+    /** Current segment starting point of each channel */
+    std::vector<double> current_start_value;
+
+    /** Current segment ending point of each channel */
+    std::vector<double> current_end_value;
+
+    /** Full range (end - start) of each channel */
+    std::vector<double> value_range;
+
+    /** Current value of each channel */
+    std::vector<ValueType> current_value;
+
+    /** Handle slot owning each channel */
+    std::vector<ChannelIdx> channel_slot;
+
+    /** Precompiled segments of all channels, stored in playback order */
+    std::vector<MotionPlanSegment> segments;
+
+    /** Number of played or removed segments still in storage */
+    size_t dead_segments {};
+
+    /** Channel index of each handle slot */
+    std::vector<ChannelIdx> slot_channel;
+
+    /** Generation of each handle slot */
+    std::vector<uint32_t> slot_generation;
+
+    /** Released handle slots */
+    std::vector<ChannelIdx> free_slots;
+
+    /** Number of channels still in motion ( always placed first ) */
+    ChannelIdx active_count {};
+
+    /** Outcome of each channel during a parallel update */
+    std::vector<ChannelStep> steps;
+
+    /** Events of the last update */
+    std::vector<MotionEvent> events;
+
+    /** Queue the events of every update are pushed to ( none by default ) */
+    MotionEventQueue* event_queue {};
+
+    /** Events that did not fit in the queue */
+    size_t dropped_events {};
+
+    /** Snapshot every update is published to ( none by default ) */
+    MotionSnapshot<ValueType>* snapshot {};
+
+    /** Updates run since the system was created */
+    uint64_t update_count {};
+
+    /** Plan compiled by Add() from a queue, rebuilt in place for every channel */
+    MotionPlan scratch_plan;
+
+    /** Segment storage being compacted, swapped with the live one to keep both allocations */
+    std::vector<MotionPlanSegment> compacted;
+
+public:
+
+    /** Reserve storage for a number of channels and segments */
+    void Reserve( size_t channels, size_t segments_per_channel = 2 )
+    {
+        segment_index.reserve( channels );
+        segment_last.reserve( channels );
+        segment_count.reserve( channels );
+        elapsed_time.reserve( channels );
+        current_start_value.reserve( channels );
+        current_end_value.reserve( channels );
+        value_range.reserve( channels );
+        current_value.reserve( channels );
+        channel_slot.reserve( channels );
+        slot_channel.reserve( channels );
+        slot_generation.reserve( channels );
+        free_slots.reserve( channels );
+
+        // Played and removed segments stay in storage until they are as many as the live ones
+        segments.reserve( 2 * channels * segments_per_channel );
+        compacted.reserve( 2 * channels * segments_per_channel );
+    }
+
+    /** Add channel with complex parameters ( queue is consumed from the back, as in MotionCore ) */
+    ChannelHandle Add(
+        ValueType start_value,
+        ValueType end_value,
+        TimeType frame_duration,
+        const MotionQueue<ValueType>& params )
+    {
+        scratch_plan.Rebuild<EasingPolicy>( params, frame_duration );
+        return Add( start_value, end_value, scratch_plan );
+    }
+
+    /** Add channel following a precompiled plan */
+    ChannelHandle Add(
+        ValueType start_value,
+        ValueType end_value,
+        const MotionPlan& plan )
+    {
+        if( dead_segments > segments.size() / 2 )
+        {
+            CompactSegments();
+        }
+
+        const auto channel = static_cast<ChannelIdx>( current_value.size() );
+        const auto first = static_cast<SegmentIdx>( segments.size() );
+        segments.insert( segments.end(), plan.GetSegments().begin(), plan.GetSegments().end() );
+
+        const auto range = static_cast<double>( end_value - start_value );
+        const auto empty = plan.IsEmpty();
+
+        segment_index.emplace_back( first );
+        segment_last.emplace_back( static_cast<SegmentIdx>( segments.size() ) );
+        segment_count.emplace_back( static_cast<SegmentIdx>( plan.GetSegmentCount() ) );
+        elapsed_time.emplace_back( plan.GetInitialElapsed() );
+        current_start_value.emplace_back( start_value );
+        current_end_value.emplace_back( empty ? start_value : start_value + range * segments[first].length );
+        value_range.emplace_back( range );
+        current_value.emplace_back( start_value );
+
+        // Acquire handle slot
+        ChannelHandle handle;
+        if( !free_slots.empty() )
+        {
+            handle.index = free_slots.back();
+            free_slots.pop_back();
+            slot_channel[handle.index] = channel;
+        }
+        else
+        {
+            handle.index = static_cast<ChannelIdx>( slot_channel.size() );
+            slot_channel.emplace_back( channel );
+            slot_generation.emplace_back( 0 );
+        }
+        handle.generation = slot_generation[handle.index];
+        channel_slot.emplace_back( handle.index );
+
+        // Same early out as MotionCore::SetMotionQueue
+        if( empty || std::fabs(current_start_value[channel] - current_end_value[channel]) <= std::numeric_limits<double>::epsilon() )
+        {
+            dead_segments += segment_last[channel] - segment_index[channel];
+            segment_index[channel] = segment_last[channel];
+        }
+        else
+        {
+            SwapChannels( channel, active_count++ );
+        }
+
+        return handle;
+    }
+
+    /** Add channel with simple parameters */
+    ChannelHandle Add(
+        ValueType start_value,
+        ValueType end_value,
+        TimeType frame_duration,
+        Type type = Type::SINE,
+        double duration_split = 0.5,
+        double modifier = 4,
+        double gravity = 2 )
+    {
+        return Add( start_value, end_value, frame_duration,
+            {
+                {type, Acceleration::OUT, 1-duration_split, 0.5, 0, 1, modifier, gravity},
+                {type, Acceleration::IN,    duration_split, 0.5, 0, 1, modifier, gravity},
+            }
+        );
+    }
+
+    /** Remove channel, invalidating its handle */
+    bool Remove( ChannelHandle handle )
+    {
+        if( !IsValid( handle ) )
+        {
+            return false;
+        }
+
+        auto channel = slot_channel[handle.index];
+        dead_segments += segment_last[channel] - segment_index[channel];
+
+        // Keep the active range packed
+        if( channel < active_count )
+        {
+            SwapChannels( channel, --active_count );
+            channel = active_count;
+        }
+
+        const auto last = static_cast<ChannelIdx>( current_value.size() - 1 );
+        SwapChannels( channel, last );
+        PopChannel();
+
+        slot_channel[handle.index] = InvalidIdx;
+        slot_generation[handle.index]++;
+        free_slots.emplace_back( handle.index );
+
+        return true;
+    }
+
+    /** Remove all channels */
+    void Clear()
+    {
+        for( ChannelIdx slot = 0; slot < slot_channel.size(); ++slot )
+        {
+            if( slot_channel[slot] != InvalidIdx )
+            {
+                slot_channel[slot] = InvalidIdx;
+                slot_generation[slot]++;
+                free_slots.emplace_back( slot );
+            }
+        }
+
+        segment_index.clear();
+        segment_last.clear();
+        segment_count.clear();
+        elapsed_time.clear();
+        current_start_value.clear();
+        current_end_value.clear();
+        value_range.clear();
+        current_value.clear();
+        channel_slot.clear();
+        segments.clear();
+        dead_segments = 0;
+        active_count = 0;
+    }
+
+    /** Check if handle refers to a live channel */
+    inline bool IsValid( ChannelHandle handle ) const
+    {
+        return handle.index < slot_channel.size()
+            && slot_channel[handle.index] != InvalidIdx
+            && slot_generation[handle.index] == handle.generation;
+    }
+
+    /** Advance every active channel to the next frame, recording its events */
+    void Update()
+    {
+        events.clear();
+
+        ChannelIdx i = 0;
+        while( i < active_count )
+        {
+            const auto step = CalculateNext( i, dead_segments );
+            if( step != ChannelStep::MOVED )
+            {
+                AddEvent( i, step );
+            }
+
+            if( step != ChannelStep::FINISHED )
+            {
+                ++i;
+            }
+            else
+            {
+                // Finished channels are moved out of the active range
+                SwapChannels( i, --active_count );
+            }
+        }
+
+        EndUpdate();
+    }
+
+
+    /** Advance every active channel to the next frame on a thread pool ( same results, events and order as Update() ) */
+    void Update( ThreadPool& pool, size_t grain = 4096 )
+    {
+        events.clear();
+        steps.resize( active_count );
+        std::atomic<size_t> dead {};
+
+        pool.ParallelFor( active_count, grain,
+            [this, &dead]( size_t begin, size_t end )
+            {
+                size_t chunk_dead = 0;
+                for( auto i = begin; i < end; ++i )
+                {
+                    steps[i] = CalculateNext( static_cast<ChannelIdx>( i ), chunk_dead );
+                }
+                dead.fetch_add( chunk_dead, std::memory_order_relaxed );
+            }
+        );
+
+        dead_segments += dead;
+
+        // Record events and move finished channels out exactly as the serial update does
+        ChannelIdx i = 0;
+        while( i < active_count )
+        {
+            if( steps[i] != ChannelStep::MOVED )
+            {
+                AddEvent( i, steps[i] );
+            }
+
+            if( steps[i] != ChannelStep::FINISHED )
+            {
+                ++i;
+            }
+            else
+            {
+                --active_count;
+                SwapChannels( i, active_count );
+                std::swap( steps[i], steps[active_count] );
+            }
+        }
+
+        EndUpdate();
+    }
+
+    /** Set queue the events of every update are pushed to ( nullptr for none, the queue must outlive the system ) */
+    inline void SetEventQueue( MotionEventQueue* queue )
+    {
+        event_queue = queue;
+    }
+
+    /** Set snapshot every update is published to ( nullptr for none, the snapshot must outlive the system ) */
+    inline void SetSnapshot( MotionSnapshot<ValueType>* target )
+    {
+        snapshot = target;
+    }
+
+    /** Publish the values of every channel to a snapshot ( from the thread running the updates ) */
+    void Publish( MotionSnapshot<ValueType>& target )
+    {
+        auto& frame = target.GetWriteBuffer();
+        frame.values.resize( slot_channel.size() );
+        frame.generations.resize( slot_channel.size() );
+        frame.update = update_count;
+
+        for( ChannelIdx slot = 0; slot < slot_channel.size(); ++slot )
+        {
+            frame.generations[slot] = slot_generation[slot];
+            if( slot_channel[slot] != InvalidIdx )
+            {
+                frame.values[slot] = current_value[slot_channel[slot]];
+            }
+        }
+
+        target.Publish();
+    }
+
+
+/** ACCESSORS */
+
+
+    /** Check if channel animation has finished ( a removed channel counts as finished ) */
+    inline bool HasFinished( ChannelHandle handle ) const
+    {
+        return !IsValid( handle ) || slot_channel[handle.index] >= active_count;
+    }
+
+    /** Get channel current value ( handle must be valid ) */
+    inline ValueType GetCurrentValue( ChannelHandle handle ) const
+    {
+        assert( IsValid( handle ) && "stale or removed motion system handle" );
+        return current_value[slot_channel[handle.index]];
+    }
+
+    /** Get total number of channels */
+    inline size_t GetChannelCount() const
+    {
+        return current_value.size();
+    }
+
+    /** Get number of channels still in motion */
+    inline size_t GetActiveCount() const
+    {
+        return active_count;
+    }
+
+    /** Get packed current values ( order changes as channels finish or get removed ) */
+    inline const std::vector<ValueType>& GetCurrentValues() const
+    {
+        return current_value;
+    }
+
+    /** Get events of the last update, in channel order */
+    inline const std::vector<MotionEvent>& GetEvents() const
+    {
+        return events;
+    }
+
+    /** Get number of events that did not fit in the event queue */
+    inline size_t GetDroppedEventCount() const
+    {
+        return dropped_events;
+    }
+
+    /** Get number of updates run */
+    inline uint64_t GetUpdateCount() const
+    {
+        return update_count;
+    }
+
+private:
+
+    /** Calculate next value of a channel, counting completed segments */
+    inline ChannelStep CalculateNext( ChannelIdx i, size_t& dead )
+    {
+        const auto& segment = segments[segment_index[i]];
+
+        // Check for progress completion
+        if( ++elapsed_time[i] == segment.end_frame )
+        {
+            current_value[i] = current_end_value[i];
+            dead++;
+
+            if( ++segment_index[i] == segment_last[i] )
+            {
+                return ChannelStep::FINISHED;
+            }
+
+            elapsed_time[i] = 0;
+            current_start_value[i] = current_end_value[i];
+            current_end_value[i] += value_range[i] * segments[segment_index[i]].length;
+            return ChannelStep::SEGMENT;
+        }
+
+        // Calculate new value
+        current_value[i] = MotionPlanSegment::Apply( segment.Step<EasingPolicy>( elapsed_time[i] ), current_start_value[i], current_end_value[i] );
+        return ChannelStep::MOVED;
+    }
+
+    /** Record a segment transition or completion of a channel */
+    inline void AddEvent( ChannelIdx i, ChannelStep step )
+    {
+        const auto slot = channel_slot[i];
+        const auto segment = ( step == ChannelStep::SEGMENT ? segment_count[i] - (segment_last[i] - segment_index[i]) : segment_count[i] );
+        events.push_back( { { slot, slot_generation[slot] }, segment, step == ChannelStep::SEGMENT ? MotionEventType::SEGMENT : MotionEventType::FINISHED } );
+    }
+
+    /** Hand the results of an update over to the event queue and snapshot */
+    inline void EndUpdate()
+    {
+        ++update_count;
+
+        if( event_queue && !events.empty() )
+        {
+            dropped_events += events.size() - event_queue->Push( events.data(), events.size() );
+        }
+
+        if( snapshot )
+        {
+            Publish( *snapshot );
+        }
+    }
+
+    /** Swap two channels in every array */
+    void SwapChannels( ChannelIdx a, ChannelIdx b )
+    {
+        if( a == b )
+        {
+            return;
+        }
+
+        std::swap( segment_index[a], segment_index[b] );
+        std::swap( segment_last[a], segment_last[b] );
+        std::swap( segment_count[a], segment_count[b] );
+        std::swap( elapsed_time[a], elapsed_time[b] );
+        std::swap( current_start_value[a], current_start_value[b] );
+        std::swap( current_end_value[a], current_end_value[b] );
+        std::swap( value_range[a], value_range[b] );
+        std::swap( current_value[a], current_value[b] );
+        std::swap( channel_slot[a], channel_slot[b] );
+
+        slot_channel[channel_slot[a]] = a;
+        slot_channel[channel_slot[b]] = b;
+    }
+
+    /** Drop the last channel from every array */
+    void PopChannel()
+    {
+        segment_index.pop_back();
+        segment_last.pop_back();
+        segment_count.pop_back();
+        elapsed_time.pop_back();
+        current_start_value.pop_back();
+        current_end_value.pop_back();
+        value_range.pop_back();
+        current_value.pop_back();
+        channel_slot.pop_back();
+    }
+
+    /** Drop played and removed segments from the segment storage */
+    void CompactSegments()
+    {
+        compacted.clear();
+        compacted.reserve( segments.size() - dead_segments );
+
+        for( ChannelIdx i = 0; i < current_value.size(); ++i )
+        {
+            const auto first = static_cast<SegmentIdx>( compacted.size() );
+            compacted.insert( compacted.end(), segments.begin() + segment_index[i], segments.begin() + segment_last[i] );
+            segment_index[i] = first;
+            segment_last[i] = static_cast<SegmentIdx>( compacted.size() );
+        }
+
+        segments.swap( compacted );
+        dead_segments = 0;
+    }
+
+}; // class MotionSystem
+
+} // namespace Motion
+
+#endif /** MOTION_SYSTEM_H */
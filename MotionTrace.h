@@ -0,0 +1,187 @@
+/** --------------------------------------------------------
+ *
+ *                   MOTION TRACE
+ *
+ * Records a timeline of events and writes it in the Chrome
+ *   trace event format ( JSON ), which chrome://tracing and
+ *    ui.perfetto.dev open directly.
+ *
+ * Recording is explicit: nothing is traced unless a
+ *   recorder is created and fed, so it costs nothing to
+ *    code that does not use it.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_TRACE_H
+#define MOTION_TRACE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+
+namespace Motion
+{
+
+/** Chrome trace event recorder ( single thread ) */
+class TraceRecorder
+{
+    using Clock = std::chrono::steady_clock;
+
+public:
+
+    /** Recorded event */
+    struct Event
+    {
+        /** Event name */
+        std::string name;
+
+        /** Event category */
+        const char* category;
+
+        /** Event phase ( 'X' complete, 'i' instant, 'C' counter ) */
+        char phase;
+
+        /** Start time in microseconds since the recorder was created */
+        double timestamp;
+
+        /** Duration in microseconds ( complete events ) */
+        double duration;
+
+        /** Arguments, as the inside of a JSON object */
+        std::string args;
+    };
+
+    /** Records a complete event spanning a scope */
+    class Scope
+    {
+    private:
+
+        /** Recorder receiving the event */
+        TraceRecorder& trace;
+
+        /** Event name */
+        std::string name;
+
+        /** Event category */
+        const char* category;
+
+        /** Start of the scope */
+        double begin;
+
+    public:
+
+        /** Constructor, starts the event */
+        Scope( TraceRecorder& trace, std::string name, const char* category )
+            : trace( trace )
+            , name( std::move(name) )
+            , category( category )
+            , begin( trace.Now() )
+        {}
+
+        /** Destructor, records the event */
+        ~Scope()
+        {
+            trace.Complete( std::move(name), category, begin, trace.Now() );
+        }
+
+        Scope( const Scope& ) = delete;
+        Scope& operator=( const Scope& ) = delete;
+    };
+
+private:
+
+    /** Time origin */
+    Clock::time_point origin { Clock::now() };
+
+    /** Recorded events */
+    std::vector<Event> events;
+
+public:
+
+    /** Get microseconds since the recorder was created */
+    inline double Now() const
+    {
+        return std::chrono::duration<double, std::micro>( Clock::now() - origin ).count();
+    }
+
+    /** Record an event spanning two points in time */
+    inline void Complete( std::string name, const char* category, double begin, double end, std::string args = {} )
+    {
+        events.push_back( { std::move(name), category, 'X', begin, end - begin, std::move(args) } );
+    }
+
+    /** Record an event at a point in time */
+    inline void Instant( std::string name, const char* category, double timestamp, std::string args = {} )
+    {
+        events.push_back( { std::move(name), category, 'i', timestamp, 0, std::move(args) } );
+    }
+
+    /** Record a counter value, shown as a track */
+    inline void Counter( std::string name, double timestamp, double value )
+    {
+        events.push_back( { std::move(name), "counter", 'C', timestamp, 0, Arg( "value", value ) } );
+    }
+
+    /** Get recorded events */
+    inline const std::vector<Event>& GetEvents() const
+    {
+        return events;
+    }
+
+    /** Format a numeric argument, to be joined with commas into event arguments */
+    static std::string Arg( const char* key, double value )
+    {
+        char text[64];
+        std::snprintf( text, sizeof(text), "%.17g", value );
+        return std::string( "\"" ) + key + "\":" + text;
+    }
+
+    /** Write the events as a Chrome trace JSON file, returns false on I/O failure */
+    bool Write( const std::string& path ) const
+    {
+        std::ofstream file( path, std::ios::trunc );
+        if( !file )
+        {
+            return false;
+        }
+
+        file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        for( size_t i = 0; i < events.size(); ++i )
+        {
+            const auto& event = events[i];
+            char times[96];
+            std::snprintf( times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f", event.timestamp, event.duration );
+
+            file << "{\"name\":\"" << Escape( event.name ) << "\",\"cat\":\"" << event.category << "\",\"ph\":\"" << event.phase
+                 << "\"," << times << ",\"pid\":1,\"tid\":1" << ( event.phase == 'i' ? ",\"s\":\"t\"" : "" )
+                 << ",\"args\":{" << event.args << "}}" << ( i + 1 < events.size() ? ",\n" : "\n" );
+        }
+        file << "]}\n";
+
+        return static_cast<bool>( file.flush() );
+    }
+
+private:
+
+    /** Escape a string for JSON */
+    static std::string Escape( const std::string& text )
+    {
+        std::string escaped;
+        for( const char c : text )
+        {
+            if( c == '"' || c == '\\' )
+            {
+                escaped += '\\';
+            }
+            escaped += ( static_cast<unsigned char>(c) < 0x20 ? ' ' : c );
+        }
+        return escaped;
+    }
+
+}; // class TraceRecorder
+
+} // namespace Motion
+
+#endif /** MOTION_TRACE_H */
@@ -0,0 +1,434 @@
+/** --------------------------------------------------------
+ *
+ *                MOTION VECTOR CORE
+ *
+ * Multi-component counterpart of MotionCore, for points,
+ *   colors and other values whose components all follow
+ *    the same motion queue.
+ *
+ * The eased step is calculated once per frame and applied
+ *   to every component, which are kept side by side in
+ *    contiguous arrays, instead of running one MotionCore
+ *     and one easing call per component.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_VECTOR_CORE_H
+#define MOTION_VECTOR_CORE_H
+
+#include <array>
+#include <vector>
+
+#include "MotionPlan.h"
+#include "AlignedAllocator.h"
+#include "MotionMath.h"
+#include "MotionStats.h"
+
+namespace Motion
+{
+
+/** Vector easing class ( components behave exactly like separate MotionCore objects with the same queue ) */
+template<typename ValueType, size_t Dimension, typename EasingPolicy = DynamicEasing, typename Math = DefaultMath<ValueType, EasingPolicy>>
+class MotionVectorCore
+{
+    using Scalar = typename Math::Scalar;
+    using Vector = std::array<ValueType, Dimension>;
+    using Components = std::array<Scalar, Dimension>;
+    using Interpolated = std::vector<ValueType, AlignedAllocator<ValueType>>;
+    using SegmentValues = std::vector<Scalar, AlignedAllocator<Scalar>>;
+
+private:
+
+    /** Current animation starting point of each component */
+    alignas(CacheLineSize) Components current_start_value {};
+
+    /** Current animation ending point of each component */
+    alignas(CacheLineSize) Components current_end_value {};
+
+    /** Current value */
+    alignas(CacheLineSize) Vector current_value {};
+
+    /** Starting value */
+    Vector start_value {};
+
+    /** Target value */
+    Vector end_value {};
+
+    /** Total duration in frames */
+    TimeType total_duration {};
+
+    /** Precompiled queue of animations */
+    MotionPlanPtr plan;
+
+    /** Plan compiled from the own queue, rebuilt in place and never handed out */
+    OwnMotionPlan own_plan;
+
+    /** Value arithmetic, holding what it needs of the plan */
+    Math math;
+
+    /** Index of the current plan segment */
+    size_t segment_index {};
+
+    /** Elapsed time in the current plan segment */
+    TimeType elapsed_time {};
+
+    /** Ending value of each plan segment, components side by side ( empty when there is nothing to animate ) */
+    SegmentValues segment_end_values;
+
+    /** Contiguous buffer of interpolated values, components side by side */
+    Interpolated interpolated_values;
+
+    /** Index of the next interpolated frame to play */
+    size_t baked_cursor {};
+
+    /** Runtime calculation flag */
+    bool runtime_calculation {};
+
+public:
+
+    /** Constructor */
+    explicit MotionVectorCore( bool runtime_calculation = true )
+        : runtime_calculation( runtime_calculation )
+    {}
+
+    /** Reset animation */
+    inline void Reset()
+    {
+        current_value = start_value;
+        segment_index = 0;
+        elapsed_time = 0;
+        baked_cursor = 0;
+        segment_end_values.clear();
+
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            current_start_value[c] = Math::FromDouble( start_value[c] );
+            current_end_value[c] = Math::FromDouble( end_value[c] );
+        }
+
+        if( !plan || plan->IsEmpty() )
+        {
+            return;
+        }
+
+        // Components with nothing to animate stay put, like a finished MotionCore
+        bool moving = false;
+        std::array<bool, Dimension> still {};
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            const double first = start_value[c] + (end_value[c]-start_value[c]) * (*plan)[0].length;
+            still[c] = ( std::fabs(start_value[c] - first) <= std::numeric_limits<double>::epsilon() );
+            moving = moving || !still[c];
+        }
+
+        if( !moving )
+        {
+            segment_index = plan->GetSegmentCount();
+            return;
+        }
+
+        // Segment ending values, accumulated exactly as MotionCore does
+        segment_end_values.reserve( std::max( plan->GetSegmentCount(), MotionQueueCapacity ) * Dimension );
+        segment_end_values.resize( plan->GetSegmentCount() * Dimension );
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            double value = start_value[c] + (end_value[c]-start_value[c]) * (*plan)[0].length;
+            segment_end_values[c] = ( still[c] ? current_start_value[c] : Math::FromDouble( value ) );
+
+            for( size_t i = 1; i < plan->GetSegmentCount(); ++i )
+            {
+                value += (end_value[c]-start_value[c]) * (*plan)[i].length;
+                segment_end_values[i*Dimension + c] = ( still[c] ? current_start_value[c] : Math::FromDouble( value ) );
+            }
+
+            current_end_value[c] = segment_end_values[c];
+        }
+
+        elapsed_time = plan->GetInitialElapsed();
+    }
+
+    /** Check if the plan has been played through */
+    inline bool HasPlanFinished() const
+    {
+        return !plan || segment_index >= plan->GetSegmentCount();
+    }
+
+    /** Check if animation has finished */
+    inline bool HasFinished() const
+    {
+        if( runtime_calculation )
+        {
+            return HasPlanFinished();
+        }
+        else
+        {
+            return baked_cursor * Dimension >= interpolated_values.size();
+        }
+    }
+
+    /** Advance to next frame */
+    void AdvanceToNext()
+    {
+        if( runtime_calculation )
+        {
+            CalculateNext();
+        }
+        else
+        {
+            if( baked_cursor * Dimension < interpolated_values.size() )
+            {
+                const auto* frame = &interpolated_values[baked_cursor++ * Dimension];
+                for( size_t c = 0; c < Dimension; ++c )
+                {
+                    current_value[c] = frame[c];
+                }
+            }
+        }
+    }
+
+    /** Calculate next value */
+    void CalculateNext()
+    {
+        if( HasPlanFinished() )
+        {
+            return;
+        }
+
+        const StatsTimer timer( StatsCounter::CALCULATION_NS );
+        Stats::Add( StatsCounter::CALCULATIONS );
+
+        elapsed_time++;
+        const auto& segment = (*plan)[segment_index];
+
+        // Check for progress completion
+        if( elapsed_time == segment.end_frame )
+        {
+            for( size_t c = 0; c < Dimension; ++c )
+            {
+                current_value[c] = Math::template ToValue<ValueType>( current_end_value[c] );
+            }
+
+            Stats::Add( StatsCounter::SEGMENT_TRANSITIONS );
+            if( ++segment_index < plan->GetSegmentCount() )
+            {
+                elapsed_time = 0;
+                current_start_value = current_end_value;
+                for( size_t c = 0; c < Dimension; ++c )
+                {
+                    current_end_value[c] = segment_end_values[segment_index*Dimension + c];
+                }
+            }
+            return;
+        }
+
+        // One easing call for all components
+        const auto step = math.Step( *plan, segment_index, elapsed_time );
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            current_value[c] = Math::template ToValue<ValueType>( Math::Apply( step, current_start_value[c], current_end_value[c] ) );
+        }
+    }
+
+    /** Fill interpolation vector */
+    void FillInterpolationVector()
+    {
+        const StatsTimer timer( StatsCounter::BAKE_NS );
+        Stats::Add( StatsCounter::BAKES );
+        Stats::Add( StatsCounter::BAKE_BYTES, static_cast<size_t>(total_duration) * Dimension * sizeof(ValueType) );
+
+        interpolated_values.clear();
+        interpolated_values.reserve( static_cast<size_t>(total_duration) * Dimension );
+
+        // Calculate easing values
+        for( decltype(total_duration) t = 0; t < total_duration; ++t )
+        {
+            CalculateNext();
+            interpolated_values.insert( interpolated_values.end(), current_value.begin(), current_value.end() );
+        }
+
+        Reset();
+    }
+
+    /** Get velocity or acceleration per frame of each component at the current frame ( analytic, one easing call for all components ) */
+    std::array<double, Dimension> GetCurrentRates( bool acceleration ) const
+    {
+        std::array<double, Dimension> rates {};
+        if( HasFinished() || segment_end_values.empty() )
+        {
+            return rates;
+        }
+
+        auto i = segment_index;
+        auto elapsed = elapsed_time;
+        if( !runtime_calculation )
+        {
+            if( baked_cursor >= plan->GetPlayedDuration() )
+            {
+                return rates;
+            }
+
+            // Segment completed on this very frame, the next one is due
+            i = plan->FindSegment( static_cast<TimeType>( baked_cursor ) );
+            elapsed = plan->GetSegmentElapsed( i, static_cast<TimeType>( baked_cursor ) );
+            if( elapsed == (*plan)[i].end_frame )
+            {
+                ++i;
+                elapsed = 0;
+            }
+        }
+
+        const auto step = (*plan)[i].template Derivatives<EasingPolicy>( elapsed );
+        const auto rate = ( acceleration ? step.second : step.first );
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            const auto segment_start = ( i == 0 ? Math::FromDouble( start_value[c] ) : segment_end_values[(i-1)*Dimension + c] );
+            rates[c] = rate * ( Math::ToDouble( segment_end_values[i*Dimension + c] ) - Math::ToDouble( segment_start ) );
+        }
+        return rates;
+    }
+
+
+/** ACCESSORS */
+
+
+    /** Get current value */
+    inline const Vector& GetCurrentValue() const
+    {
+        return current_value;
+    }
+
+    /** Get current velocity of each component, in value per frame */
+    inline std::array<double, Dimension> GetCurrentVelocity() const
+    {
+        return GetCurrentRates( false );
+    }
+
+    /** Get current acceleration of each component, in value per frame squared */
+    inline std::array<double, Dimension> GetCurrentAcceleration() const
+    {
+        return GetCurrentRates( true );
+    }
+
+    /** Set starting value */
+    inline void SetStartingValue( const Vector& startingValue )
+    {
+        start_value = startingValue;
+    }
+
+    /** Get starting value */
+    inline const Vector& GetStartingValue() const
+    {
+        return start_value;
+    }
+
+    /** Set ending value */
+    inline void SetEndingValue( const Vector& endingValue )
+    {
+        end_value = endingValue;
+    }
+
+    /** Get ending value */
+    inline const Vector& GetEndingValue() const
+    {
+        return end_value;
+    }
+
+    /** Set frame duration value */
+    inline void SetFrameDuration( TimeType frameDuration )
+    {
+        total_duration = frameDuration;
+    }
+
+    /** Get frame duration */
+    inline TimeType GetFrameDuration() const
+    {
+        return total_duration;
+    }
+
+    /** Set motion parameters queue, shared by all components ( compiled into the plan, which keeps it ) */
+    inline void SetMotionQueue( const MotionQueue<ValueType>& params )
+    {
+        SetMotionPlan( own_plan.Compile<EasingPolicy>( params, total_duration, plan ) );
+    }
+
+    /** Set precompiled motion plan ( may be shared, sets the frame duration too ) */
+    inline void SetMotionPlan( MotionPlanPtr motion_plan )
+    {
+        plan = std::move( motion_plan );
+        math.Prepare( *plan );
+        total_duration = plan->GetFrameDuration();
+        Reset();
+
+        if( HasPlanFinished() )
+        {
+            interpolated_values.clear();
+            return;
+        }
+
+        if( !runtime_calculation )
+        {
+            FillInterpolationVector();
+        }
+    }
+
+    /** Get motion parameters queue, rebuilt from the plan ( empty without one ) */
+    inline MotionQueue<ValueType> GetMotionQueue() const
+    {
+        return plan ? plan->template GetQueue<ValueType>() : MotionQueue<ValueType>();
+    }
+
+    /** Get precompiled motion plan ( a copy when compiled from the own queue, later parameter changes don't touch it ) */
+    inline MotionPlanPtr GetMotionPlan() const
+    {
+        return own_plan.Share( plan );
+    }
+
+    /** Get interpolated values, components side by side */
+    inline const Interpolated& GetInterpolatedValues() const
+    {
+        return interpolated_values;
+    }
+
+    /** Set parameters */
+    inline void SetParameters(
+        const Vector& start_value,
+        const Vector& end_value,
+        TimeType frame_duration,
+        const MotionQueue<ValueType>& params )
+    {
+        SetStartingValue( start_value );
+        SetEndingValue( end_value );
+        SetFrameDuration( frame_duration );
+        current_value = start_value;
+        SetMotionQueue( params );
+    }
+
+    /** Set linear parameters */
+    inline void SetParameters(
+        const Vector& start_value,
+        const Vector& end_value,
+        TimeType frame_duration,
+        Type type = Type::SINE,
+        double duration_split = 0.5,
+        double modifier = 4,
+        double gravity = 2 )
+    {
+        SetParameters( start_value, end_value, frame_duration,
+            {
+                {type, Acceleration::OUT, 1-duration_split, 0.5, 0, 1, modifier, gravity},
+                {type, Acceleration::IN,    duration_split, 0.5, 0, 1, modifier, gravity},
+            }
+        );
+    }
+
+    /** Set runtime calculation flag */
+    inline void SetRuntimeCalculation( bool runtime )
+    {
+        runtime_calculation = runtime;
+    }
+
+}; // class MotionVectorCore
+
+} // namespace Motion
+
+#endif /** MOTION_VECTOR_CORE_H */
@@ -0,0 +1,421 @@
+/** --------------------------------------------------------
+ *
+ *                   SPRING CORE
+ *
+ * Damped spring motion towards a target, evaluated from the
+ *   closed-form solution of m*x'' + c*x' + k*x = 0 for
+ *    under-, critically- and over-damped springs, so any
+ *     time is one evaluation away and nothing is baked.
+ *
+ * The target can move mid-flight: the current position and
+ *   velocity become the initial conditions of a new solution,
+ *    which costs O(1) per component and keeps both continuous.
+ *
+ * All components share the spring constants, so the decay
+ *   and oscillation terms are evaluated once per frame.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_SPRING_CORE_H
+#define MOTION_SPRING_CORE_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace Motion
+{
+
+/** Spring constants, per second as designers give them ( react-spring / CSS spring defaults ) */
+struct SpringParameters
+{
+    /** Stiffness k */
+    double stiffness {170.0};
+
+    /** Damping c */
+    double damping {26.0};
+
+    /** Mass m */
+    double mass {1.0};
+
+    /** Frames per second the constants are converted with */
+    double frame_rate {60.0};
+
+    /** Distance to the target, and speed in value per frame, below which the spring is at rest */
+    double rest_threshold {0.01};
+};
+
+/** Damping regime of a spring */
+enum class SpringRegime : uint8_t
+{
+    UNDERDAMPED,    // Oscillates around the target with decaying amplitude
+    CRITICAL,       // Fastest approach without overshoot
+    OVERDAMPED,     // Creeps towards the target without overshoot
+};
+
+/** Damping ratio within which a spring is treated as critically damped */
+constexpr double SpringCriticalTolerance = 1e-6;
+
+/** Spring easing class ( components spring independently with shared constants ) */
+template<typename ValueType, size_t Dimension = 1>
+class SpringCore
+{
+    using Vector = std::array<ValueType, Dimension>;
+    using Components = std::array<double, Dimension>;
+
+    /** Basis functions of the solution and their derivatives at one time, x = a*f1 + b*f2 */
+    struct Basis
+    {
+        double f1 {};
+        double f2 {};
+        double df1 {};
+        double df2 {};
+    };
+
+private:
+
+    /** Spring constants */
+    SpringParameters parameters;
+
+    /** Damping regime */
+    SpringRegime regime {};
+
+    /** Undamped angular frequency, per frame */
+    double omega {};
+
+    /** Damping ratio */
+    double zeta {};
+
+    /** Decay rate ( underdamped ) or slow root ( overdamped ), per frame */
+    double rate_1 {};
+
+    /** Damped frequency ( underdamped ) or fast root ( overdamped ), per frame */
+    double rate_2 {};
+
+    /** Target value of each component */
+    Components target {};
+
+    /** First coefficient of each component's offset from the target */
+    Components coefficient_a {};
+
+    /** Second coefficient of each component's offset from the target */
+    Components coefficient_b {};
+
+    /** Frames since the solution started */
+    double elapsed {};
+
+    /** Current value */
+    Vector current_value {};
+
+    /** Current offset from the target */
+    Components current_offset {};
+
+    /** Current velocity, in value per frame */
+    Components current_velocity {};
+
+    /** Initial position, restored by Reset() */
+    Components start_position {};
+
+    /** Initial velocity, restored by Reset() */
+    Components start_velocity {};
+
+    /** Initial target, restored by Reset() */
+    Components start_target {};
+
+    /** Rest flag */
+    bool at_rest {true};
+
+public:
+
+    /** Constructor */
+    explicit SpringCore( const SpringParameters& spring = {} )
+    {
+        SetSpringParameters( spring );
+    }
+
+    /** Reset animation to its initial position, velocity and target */
+    inline void Reset()
+    {
+        Solve( start_position, start_velocity, start_target );
+    }
+
+    /** Check if the spring has come to rest on its target */
+    inline bool HasFinished() const
+    {
+        return at_rest;
+    }
+
+    /** Advance to next frame */
+    inline void AdvanceToNext()
+    {
+        AdvanceBy( 1.0 );
+    }
+
+    /** Advance by a number of frames, which may be fractional ( O(1) ) */
+    inline void AdvanceBy( double frames )
+    {
+        if( at_rest || !(frames > 0) )
+        {
+            return;
+        }
+
+        elapsed += frames;
+        Update();
+    }
+
+    /** Jump to a number of frames since the solution started, the last Reset() or SetTarget() */
+    inline void Seek( double frames )
+    {
+        elapsed = std::fmax( frames, 0.0 );
+        at_rest = false;
+        Update();
+    }
+
+    /** Get value of each component at a number of frames since the solution started, without moving */
+    inline Components EvaluateAt( double frames ) const
+    {
+        const auto basis = BasisAt( std::fmax( frames, 0.0 ) );
+        Components position;
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            position[c] = target[c] + ( coefficient_a[c] * basis.f1 + coefficient_b[c] * basis.f2 );
+        }
+        return position;
+    }
+
+    /** Start springing from a position and velocity ( in value per frame ) towards a target */
+    inline void Start( const Components& position, const Components& velocity, const Components& spring_target )
+    {
+        start_position = position;
+        start_velocity = velocity;
+        start_target = spring_target;
+        Solve( position, velocity, spring_target );
+    }
+
+    /** Move the target mid-flight ( O(1) per component, position and velocity stay continuous ) */
+    inline void SetTarget( const Vector& new_target )
+    {
+        Components position;
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            position[c] = target[c] + current_offset[c];
+        }
+
+        Components spring_target;
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            spring_target[c] = static_cast<double>( new_target[c] );
+        }
+
+        Solve( position, current_velocity, spring_target );
+    }
+
+    /** Get target value */
+    inline Vector GetTarget() const
+    {
+        Vector value;
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            value[c] = static_cast<ValueType>( target[c] );
+        }
+        return value;
+    }
+
+    /** Get current value */
+    inline const Vector& GetCurrentValue() const
+    {
+        return current_value;
+    }
+
+    /** Get current velocity of each component, in value per frame */
+    inline const Components& GetCurrentVelocity() const
+    {
+        return current_velocity;
+    }
+
+    /** Get current acceleration of each component, in value per frame squared */
+    inline Components GetCurrentAcceleration() const
+    {
+        Components acceleration;
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            acceleration[c] = -omega * omega * current_offset[c] - 2 * zeta * omega * current_velocity[c];
+        }
+        return acceleration;
+    }
+
+    /** Set spring constants, the motion goes on from its current position and velocity ( stiffness, mass and frame
+     *  rate must be positive, damping and rest threshold not negative, all finite: others throw std::invalid_argument
+     *  and the current constants are kept ) */
+    inline void SetSpringParameters( const SpringParameters& spring )
+    {
+        if( !( spring.stiffness > 0 && spring.mass > 0 && spring.frame_rate > 0 && spring.damping >= 0 && spring.rest_threshold >= 0 )
+         || !std::isfinite( spring.stiffness * spring.mass * spring.frame_rate * spring.damping ) )
+        {
+            throw std::invalid_argument( "SpringCore: invalid spring parameters" );
+        }
+
+        parameters = spring;
+        omega = std::sqrt( spring.stiffness / spring.mass ) / spring.frame_rate;
+        zeta = spring.damping / ( 2 * std::sqrt( spring.stiffness * spring.mass ) );
+
+        if( std::fabs( zeta - 1 ) <= SpringCriticalTolerance )
+        {
+            regime = SpringRegime::CRITICAL;
+            rate_1 = -omega;
+            rate_2 = 0;
+        }
+        else if( zeta < 1 )
+        {
+            regime = SpringRegime::UNDERDAMPED;
+            rate_1 = zeta * omega;
+            rate_2 = omega * std::sqrt( 1 - zeta * zeta );
+        }
+        else
+        {
+            // Slow root first, written to avoid cancellation
+            regime = SpringRegime::OVERDAMPED;
+            const auto root = std::sqrt( zeta * zeta - 1 );
+            rate_1 = -omega / ( zeta + root );
+            rate_2 = -omega * ( zeta + root );
+        }
+
+        Components position;
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            position[c] = target[c] + current_offset[c];
+        }
+        Solve( position, current_velocity, target );
+    }
+
+    /** Get spring constants */
+    inline const SpringParameters& GetSpringParameters() const
+    {
+        return parameters;
+    }
+
+    /** Get damping regime */
+    inline SpringRegime GetRegime() const
+    {
+        return regime;
+    }
+
+    /** Get damping ratio */
+    inline double GetDampingRatio() const
+    {
+        return zeta;
+    }
+
+    /** Set parameters */
+    inline void SetParameters(
+        const Vector& start_value,
+        const Vector& end_value,
+        const SpringParameters& spring = {} )
+    {
+        SetSpringParameters( spring );
+        current_offset = {};
+        current_velocity = {};
+
+        Components position;
+        Components spring_target;
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            position[c] = static_cast<double>( start_value[c] );
+            spring_target[c] = static_cast<double>( end_value[c] );
+        }
+        Start( position, {}, spring_target );
+    }
+
+private:
+
+    /** Restart the solution from a position and velocity towards a target */
+    inline void Solve( const Components& position, const Components& velocity, const Components& spring_target )
+    {
+        target = spring_target;
+        elapsed = 0;
+
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            const auto x0 = position[c] - target[c];
+            const auto v0 = velocity[c];
+            switch( regime )
+            {
+                case SpringRegime::UNDERDAMPED:
+                    coefficient_a[c] = x0;
+                    coefficient_b[c] = ( v0 + rate_1 * x0 ) / rate_2;
+                    break;
+                case SpringRegime::CRITICAL:
+                    coefficient_a[c] = x0;
+                    coefficient_b[c] = v0 + omega * x0;
+                    break;
+                case SpringRegime::OVERDAMPED:
+                    coefficient_a[c] = ( v0 - rate_2 * x0 ) / ( rate_1 - rate_2 );
+                    coefficient_b[c] = x0 - coefficient_a[c];
+                    break;
+            }
+        }
+
+        at_rest = false;
+        Update();
+    }
+
+    /** Basis functions at a number of frames since the solution started */
+    inline Basis BasisAt( double t ) const
+    {
+        switch( regime )
+        {
+            case SpringRegime::UNDERDAMPED:
+            {
+                const auto decay = std::exp( -rate_1 * t );
+                const auto cosine = decay * std::cos( rate_2 * t );
+                const auto sine = decay * std::sin( rate_2 * t );
+                return { cosine, sine, -rate_1 * cosine - rate_2 * sine, rate_2 * cosine - rate_1 * sine };
+            }
+            case SpringRegime::CRITICAL:
+            {
+                const auto decay = std::exp( rate_1 * t );
+                return { decay, t * decay, rate_1 * decay, decay * ( 1 + rate_1 * t ) };
+            }
+            case SpringRegime::OVERDAMPED:
+            default:
+            {
+                const auto slow = std::exp( rate_1 * t );
+                const auto fast = std::exp( rate_2 * t );
+                return { slow, fast, rate_1 * slow, rate_2 * fast };
+            }
+        }
+    }
+
+    /** Evaluate the solution at the elapsed time, settling on the target once at rest */
+    inline void Update()
+    {
+        const auto basis = BasisAt( elapsed );
+
+        bool rest = true;
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            current_offset[c] = coefficient_a[c] * basis.f1 + coefficient_b[c] * basis.f2;
+            current_velocity[c] = coefficient_a[c] * basis.df1 + coefficient_b[c] * basis.df2;
+            rest = rest && std::fabs( current_offset[c] ) <= parameters.rest_threshold && std::fabs( current_velocity[c] ) <= parameters.rest_threshold;
+        }
+
+        if( rest )
+        {
+            current_offset = {};
+            current_velocity = {};
+        }
+        at_rest = rest;
+
+        for( size_t c = 0; c < Dimension; ++c )
+        {
+            current_value[c] = static_cast<ValueType>( target[c] + current_offset[c] );
+        }
+    }
+
+}; // class SpringCore
+
+} // namespace Motion
+
+#endif /** MOTION_SPRING_CORE_H */
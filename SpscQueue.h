@@ -0,0 +1,137 @@
+/** --------------------------------------------------------
+ *
+ *                    SPSC QUEUE
+ *
+ * Bounded lock-free queue for one producer thread and one
+ *   consumer thread, used to hand motion events over to
+ *    another thread without locking the update path.
+ *
+ * The ring holds a power of two slots. Each side owns one
+ *   index on its own cache line and keeps a cached copy of
+ *    the other one, so an uncontended push or pop touches no
+ *     shared cache line beyond the slots themselves.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_SPSC_QUEUE_H
+#define MOTION_SPSC_QUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include "AlignedAllocator.h"
+
+namespace Motion
+{
+
+/** Single-producer single-consumer ring buffer ( T must be trivially copyable ) */
+template<typename T>
+class SpscQueue
+{
+    static_assert( std::is_trivially_copyable<T>::value, "SpscQueue holds trivially copyable values" );
+
+private:
+
+    /** Slots */
+    std::unique_ptr<T[]> slots;
+
+    /** Slot count minus one */
+    size_t mask {};
+
+    /** Next slot to write, owned by the producer */
+    alignas(CacheLineSize) std::atomic<size_t> head {};
+
+    /** Consumer position last seen by the producer */
+    size_t cached_tail {};
+
+    /** Next slot to read, owned by the consumer */
+    alignas(CacheLineSize) std::atomic<size_t> tail {};
+
+    /** Producer position last seen by the consumer */
+    size_t cached_head {};
+
+public:
+
+    /** Constructor, capacity is rounded up to a power of two */
+    explicit SpscQueue( size_t capacity = 4096 )
+    {
+        size_t size = 1;
+        while( size < capacity )
+        {
+            size *= 2;
+        }
+        slots.reset( new T[size] );
+        mask = size - 1;
+    }
+
+    SpscQueue( const SpscQueue& ) = delete;
+    SpscQueue& operator=( const SpscQueue& ) = delete;
+
+    /** Push a value ( producer only ), returns false when full */
+    inline bool Push( const T& value )
+    {
+        return Push( &value, 1 ) == 1;
+    }
+
+    /** Push as many values as fit ( producer only ), returns how many were pushed */
+    size_t Push( const T* values, size_t count )
+    {
+        const auto h = head.load( std::memory_order_relaxed );
+        if( h + count - cached_tail > mask + 1 )
+        {
+            cached_tail = tail.load( std::memory_order_acquire );
+        }
+
+        const auto n = std::min( count, mask + 1 - (h - cached_tail) );
+        for( size_t i = 0; i < n; ++i )
+        {
+            slots[(h + i) & mask] = values[i];
+        }
+        head.store( h + n, std::memory_order_release );
+        return n;
+    }
+
+    /** Pop a value ( consumer only ), returns false when empty */
+    inline bool Pop( T& value )
+    {
+        return Pop( &value, 1 ) == 1;
+    }
+
+    /** Pop up to a number of values ( consumer only ), returns how many were popped */
+    size_t Pop( T* values, size_t count )
+    {
+        const auto t = tail.load( std::memory_order_relaxed );
+        if( cached_head - t < count )
+        {
+            cached_head = head.load( std::memory_order_acquire );
+        }
+
+        const auto n = std::min( count, cached_head - t );
+        for( size_t i = 0; i < n; ++i )
+        {
+            values[i] = slots[(t + i) & mask];
+        }
+        tail.store( t + n, std::memory_order_release );
+        return n;
+    }
+
+    /** Get number of values waiting ( exact only on a quiet queue ) */
+    inline size_t GetSize() const
+    {
+        return head.load( std::memory_order_acquire ) - tail.load( std::memory_order_acquire );
+    }
+
+    /** Get number of slots */
+    inline size_t GetCapacity() const
+    {
+        return mask + 1;
+    }
+
+}; // class SpscQueue
+
+} // namespace Motion
+
+#endif /** MOTION_SPSC_QUEUE_H */
@@ -0,0 +1,268 @@
+/** --------------------------------------------------------
+ *
+ *                   THREAD POOL
+ *
+ * Minimal work-stealing pool for data parallel loops over
+ *   large motion collections, built on std::thread only.
+ *
+ * A loop is cut into fixed size chunks, which are dealt to
+ *   the workers as contiguous ranges. Workers run their own
+ *    range front to back and, once done, steal half of the
+ *     remaining range of another worker. Chunk boundaries
+ *      never depend on scheduling, so loops writing disjoint
+ *       data give the same results on any number of threads.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_THREAD_POOL_H
+#define MOTION_THREAD_POOL_H
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+
+#include "AlignedAllocator.h"
+
+namespace Motion
+{
+
+/** Work-stealing thread pool */
+class ThreadPool
+{
+    /** Range of chunks owned by a worker */
+    struct alignas(CacheLineSize) ChunkRange
+    {
+        /** Guards the range */
+        std::mutex mutex;
+
+        /** First chunk left */
+        size_t begin {};
+
+        /** Past the last chunk left */
+        size_t end {};
+    };
+
+private:
+
+    /** Worker threads ( the calling thread works as worker 0 ) */
+    std::vector<std::thread> threads;
+
+    /** Chunk range of each worker */
+    std::unique_ptr<ChunkRange[]> ranges;
+
+    /** Number of workers, calling thread included */
+    size_t worker_count {};
+
+    /** Guards the job state below */
+    std::mutex mutex;
+
+    /** Signals a new job or shutdown to the workers */
+    std::condition_variable wake;
+
+    /** Signals the end of a job to the caller */
+    std::condition_variable done;
+
+    /** Current job, called per chunk */
+    std::function<void( size_t )> job;
+
+    /** Job counter, workers run each job once */
+    uint64_t generation {};
+
+    /** Worker threads still running the current job */
+    size_t busy {};
+
+    /** Shutdown flag */
+    bool stopping {};
+
+public:
+
+    /** Constructor ( 0 workers means one per hardware thread ) */
+    explicit ThreadPool( size_t workers = 0 )
+    {
+        worker_count = ( workers ? workers : std::max<size_t>( 1, std::thread::hardware_concurrency() ) );
+        ranges.reset( new ChunkRange[worker_count] );
+
+        threads.reserve( worker_count - 1 );
+        for( size_t w = 1; w < worker_count; ++w )
+        {
+            threads.emplace_back( [this, w]() { WorkerLoop( w ); } );
+        }
+    }
+
+    /** Destructor */
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            stopping = true;
+        }
+        wake.notify_all();
+
+        for( auto& thread : threads )
+        {
+            thread.join();
+        }
+    }
+
+    ThreadPool( const ThreadPool& ) = delete;
+    ThreadPool& operator=( const ThreadPool& ) = delete;
+
+    /** Get number of workers, calling thread included */
+    inline size_t GetWorkerCount() const
+    {
+        return worker_count;
+    }
+
+    /** Call func( begin, end ) over [0, count) in chunks of 'grain' items, returns once all are done */
+    template<typename Func>
+    void ParallelFor( size_t count, size_t grain, Func&& func )
+    {
+        if( count == 0 )
+        {
+            return;
+        }
+
+        grain = std::max<size_t>( grain, 1 );
+        const auto chunks = ( count + grain - 1 ) / grain;
+
+        if( worker_count == 1 || chunks == 1 )
+        {
+            func( size_t{}, count );
+            return;
+        }
+
+        // Deal contiguous chunk ranges, workers are idle at this point
+        for( size_t w = 0; w < worker_count; ++w )
+        {
+            std::lock_guard<std::mutex> lock( ranges[w].mutex );
+            ranges[w].begin = chunks * w / worker_count;
+            ranges[w].end = chunks * (w+1) / worker_count;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            job = [&func, count, grain]( size_t chunk )
+            {
+                const auto begin = chunk * grain;
+                func( begin, std::min( count, begin + grain ) );
+            };
+            busy = worker_count - 1;
+            generation++;
+        }
+        wake.notify_all();
+
+        RunChunks( 0 );
+
+        std::unique_lock<std::mutex> lock( mutex );
+        done.wait( lock, [this]() { return busy == 0; } );
+        job = nullptr;
+    }
+
+    /** Call func( item ) for every item of a random access container, e.g. AdvanceToNext() on a vector of MotionCore */
+    template<typename Container, typename Func>
+    void ForEach( Container& items, Func&& func, size_t grain = 256 )
+    {
+        ParallelFor( items.size(), grain,
+            [&items, &func]( size_t begin, size_t end )
+            {
+                for( auto i = begin; i < end; ++i )
+                {
+                    func( items[i] );
+                }
+            }
+        );
+    }
+
+private:
+
+    /** Worker thread body */
+    void WorkerLoop( size_t worker )
+    {
+        uint64_t seen = 0;
+        while( true )
+        {
+            {
+                std::unique_lock<std::mutex> lock( mutex );
+                wake.wait( lock, [this, seen]() { return stopping || generation != seen; } );
+                if( stopping )
+                {
+                    return;
+                }
+                seen = generation;
+            }
+
+            RunChunks( worker );
+
+            std::lock_guard<std::mutex> lock( mutex );
+            if( --busy == 0 )
+            {
+                done.notify_one();
+            }
+        }
+    }
+
+    /** Run own chunks, then steal until no worker has any left */
+    void RunChunks( size_t worker )
+    {
+        size_t chunk;
+        while( TakeChunk( worker, chunk ) || StealChunks( worker, chunk ) )
+        {
+            job( chunk );
+        }
+    }
+
+    /** Take the next chunk of own range */
+    inline bool TakeChunk( size_t worker, size_t& chunk )
+    {
+        auto& range = ranges[worker];
+        std::lock_guard<std::mutex> lock( range.mutex );
+        if( range.begin == range.end )
+        {
+            return false;
+        }
+
+        chunk = range.begin++;
+        return true;
+    }
+
+    /** Steal the back half of another worker's range, returns its first chunk and keeps the rest */
+    bool StealChunks( size_t worker, size_t& chunk )
+    {
+        for( size_t k = 1; k < worker_count; ++k )
+        {
+            auto& victim = ranges[( worker + k ) % worker_count];
+
+            size_t begin, end;
+            {
+                std::lock_guard<std::mutex> lock( victim.mutex );
+                const auto left = victim.end - victim.begin;
+                if( left == 0 )
+                {
+                    continue;
+                }
+
+                end = victim.end;
+                begin = end - ( left + 1 ) / 2;
+                victim.end = begin;
+            }
+
+            auto& own = ranges[worker];
+            std::lock_guard<std::mutex> lock( own.mutex );
+            own.begin = begin + 1;
+            own.end = end;
+            chunk = begin;
+            return true;
+        }
+
+        return false;
+    }
+
+}; // class ThreadPool
+
+} // namespace Motion
+
+#endif /** MOTION_THREAD_POOL_H */
@@ -0,0 +1,489 @@
+/** --------------------------------------------------------
+ *
+ *                     TIMELINE
+ *
+ * Scheduler of motions with start delays, staggered starts
+ *   and repeats, on top of a MotionSystem.
+ *
+ * Motions that have not started yet wait in a min-heap of
+ *   start frames, outside the system, so a frame only pops
+ *    the starts that are due and advances the motions that
+ *     are playing. The cost of a frame follows the number
+ *      of live motions, not the number of scheduled ones.
+ *
+ * Finished motions are found from the completion events of
+ *   the system update instead of polling the live ones. A
+ *    motion that finishes leaves the system, and goes back to
+ *     the heap if it has runs left.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_TIMELINE_H
+#define MOTION_TIMELINE_H
+
+#include <vector>
+#include <memory>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+
+#include "MotionSystem.h"
+
+namespace Motion
+{
+
+/** Stable handle of a timeline motion */
+struct TimelineHandle
+{
+    /** Entry slot index */
+    uint32_t index { std::numeric_limits<uint32_t>::max() };
+
+    /** Slot generation at the time of scheduling */
+    uint32_t generation {};
+};
+
+/** Repeat count of a motion that loops until it is removed */
+constexpr uint32_t TimelineRepeatForever = std::numeric_limits<uint32_t>::max();
+
+/** When a timeline motion plays, in frames */
+struct TimelineTiming
+{
+    /** Frames before the first run starts */
+    TimeType delay {};
+
+    /** Runs after the first one ( TimelineRepeatForever to loop ) */
+    uint32_t repeat_count {};
+
+    /** Frames between the end of a run and the start of the next */
+    TimeType repeat_delay {};
+};
+
+/** State of a timeline motion */
+enum class TimelineState : uint8_t
+{
+    SCHEDULED,      // Waiting for its start frame, at its starting value ( ending value between repeats )
+    ACTIVE,         // Playing in the motion system
+    FINISHED,       // Played all its runs, at its ending value
+};
+
+/** Event of a timeline motion during one update */
+struct TimelineEvent
+{
+    /** Motion */
+    TimelineHandle handle;
+
+    /** Segment that started ( SEGMENT ), or the segment count ( FINISHED ), zero for STARTED */
+    uint32_t segment {};
+
+    /** Kind of event ( FINISHED ends a run, the motion is done once its state is FINISHED ) */
+    MotionEventType type {};
+};
+
+/** Motion scheduler ( EasingPolicy as in MotionCore ) */
+template<typename ValueType, typename EasingPolicy = DynamicEasing>
+class Timeline
+{
+    using SlotIdx = uint32_t;
+
+    static constexpr SlotIdx InvalidIdx = std::numeric_limits<SlotIdx>::max();
+
+    /** Scheduled motion */
+    struct Entry
+    {
+        /** Compiled queue, shared by staggered motions */
+        MotionPlanPtr plan;
+
+        /** Starting value of every run */
+        ValueType start_value {};
+
+        /** Ending value of every run */
+        ValueType end_value {};
+
+        /** Value while not playing */
+        ValueType value {};
+
+        /** Motion system channel while playing */
+        ChannelHandle channel {};
+
+        /** Runs left after the current one */
+        uint32_t repeats_left {};
+
+        /** Frames between runs */
+        TimeType repeat_delay {};
+
+        /** Generation of the slot, bumped on removal */
+        uint32_t generation {};
+
+        /** Playback state */
+        TimelineState state {};
+
+        /** Slot in use flag */
+        bool used {};
+    };
+
+    /** Pending start of a run */
+    struct Start
+    {
+        /** Timeline frame the run starts on */
+        uint64_t frame;
+
+        /** Entry slot */
+        SlotIdx slot;
+
+        /** Slot generation when scheduled ( stale starts of removed motions are skipped ) */
+        uint32_t generation;
+    };
+
+private:
+
+    /** Motions that are playing */
+    MotionSystem<ValueType, EasingPolicy> system;
+
+    /** Scheduled motions by slot */
+    std::vector<Entry> entries;
+
+    /** Released slots */
+    std::vector<SlotIdx> free_slots;
+
+    /** Min-heap of pending starts, earliest frame first */
+    std::vector<Start> starts;
+
+    /** Starts of removed motions still in the heap */
+    size_t stale_starts {};
+
+    /** Entry slot of each motion system handle slot */
+    std::vector<SlotIdx> channel_slots;
+
+    /** Slots of motions that finished as they started ( empty plans ) */
+    std::vector<SlotIdx> instant;
+
+    /** Events of the last update */
+    std::vector<TimelineEvent> events;
+
+    /** Frames played since the timeline started */
+    uint64_t frame {};
+
+public:
+
+    /** Reserve storage for a number of motions, of which a number play at once */
+    void Reserve( size_t motions, size_t live_motions = 0 )
+    {
+        entries.reserve( motions );
+        free_slots.reserve( motions );
+        starts.reserve( motions );
+        channel_slots.reserve( live_motions );
+        system.Reserve( live_motions );
+    }
+
+    /** Schedule a motion following a precompiled plan */
+    TimelineHandle Schedule(
+        ValueType start_value,
+        ValueType end_value,
+        MotionPlanPtr plan,
+        const TimelineTiming& timing = {} )
+    {
+        const auto slot = AcquireSlot();
+        auto& entry = entries[slot];
+        entry.plan = std::move( plan );
+        entry.start_value = start_value;
+        entry.end_value = end_value;
+        entry.value = start_value;
+        entry.repeats_left = timing.repeat_count;
+        entry.repeat_delay = timing.repeat_delay;
+        entry.state = TimelineState::SCHEDULED;
+
+        PushStart( frame + timing.delay, slot );
+        return { slot, entry.generation };
+    }
+
+    /** Schedule a motion with complex parameters ( queue is consumed from the back, as in MotionCore ) */
+    TimelineHandle Schedule(
+        ValueType start_value,
+        ValueType end_value,
+        TimeType frame_duration,
+        const MotionQueue<ValueType>& params,
+        const TimelineTiming& timing = {} )
+    {
+        return Schedule( start_value, end_value, CompileQueue( params, frame_duration ), timing );
+    }
+
+    /** Schedule a number of motions sharing a plan, each starting stagger frames after the previous, appending their handles */
+    void Stagger(
+        size_t count,
+        TimeType stagger,
+        ValueType start_value,
+        ValueType end_value,
+        const MotionPlanPtr& plan,
+        TimelineTiming timing,
+        std::vector<TimelineHandle>& handles )
+    {
+        handles.reserve( handles.size() + count );
+        for( size_t i = 0; i < count; ++i )
+        {
+            handles.emplace_back( Schedule( start_value, end_value, plan, timing ) );
+            timing.delay += stagger;
+        }
+    }
+
+    /** Remove a motion, invalidating its handle ( a pending start is dropped once it is due, or once stale starts fill half the heap ) */
+    bool Remove( TimelineHandle handle )
+    {
+        if( !IsValid( handle ) )
+        {
+            return false;
+        }
+
+        auto& entry = entries[handle.index];
+        if( entry.state == TimelineState::ACTIVE )
+        {
+            system.Remove( entry.channel );
+        }
+        else if( entry.state == TimelineState::SCHEDULED )
+        {
+            stale_starts++;
+        }
+
+        entry.plan.reset();
+        entry.used = false;
+        entry.generation++;
+        free_slots.emplace_back( handle.index );
+
+        if( stale_starts > starts.size() / 2 )
+        {
+            CompactStarts();
+        }
+        return true;
+    }
+
+    /** Remove all motions and restart the frame count */
+    void Clear()
+    {
+        for( SlotIdx slot = 0; slot < entries.size(); ++slot )
+        {
+            if( entries[slot].used )
+            {
+                Remove( { slot, entries[slot].generation } );
+            }
+        }
+
+        system.Clear();
+        starts.clear();
+        stale_starts = 0;
+        instant.clear();
+        events.clear();
+        frame = 0;
+    }
+
+    /** Check if handle refers to a scheduled, playing or finished motion */
+    inline bool IsValid( TimelineHandle handle ) const
+    {
+        return handle.index < entries.size()
+            && entries[handle.index].used
+            && entries[handle.index].generation == handle.generation;
+    }
+
+    /** Advance the timeline to the next frame, starting due motions and retiring finished ones, recording their events */
+    void Update()
+    {
+        events.clear();
+
+        // Motions start on their frame and take their first step on it, like a MotionCore advanced after that many frames
+        while( !starts.empty() && starts.front().frame <= frame )
+        {
+            std::pop_heap( starts.begin(), starts.end(), Later );
+            const auto start = starts.back();
+            starts.pop_back();
+
+            if( IsLive( start ) )
+            {
+                Activate( start.slot );
+            }
+            else
+            {
+                stale_starts--;
+            }
+        }
+
+        system.Update();
+        ++frame;
+
+        for( const auto& event : system.GetEvents() )
+        {
+            const auto slot = channel_slots[event.handle.index];
+            if( event.type == MotionEventType::FINISHED )
+            {
+                Retire( slot, event.segment );
+            }
+            else
+            {
+                events.push_back( { { slot, entries[slot].generation }, event.segment, event.type } );
+            }
+        }
+
+        for( const auto slot : instant )
+        {
+            Retire( slot, 0 );
+        }
+        instant.clear();
+    }
+
+
+/** ACCESSORS */
+
+
+    /** Get motion state */
+    inline TimelineState GetState( TimelineHandle handle ) const
+    {
+        assert( IsValid( handle ) && "stale or removed timeline handle" );
+        return entries[handle.index].state;
+    }
+
+    /** Check if motion has played all its runs */
+    inline bool HasFinished( TimelineHandle handle ) const
+    {
+        assert( IsValid( handle ) && "stale or removed timeline handle" );
+        return entries[handle.index].state == TimelineState::FINISHED;
+    }
+
+    /** Get motion current value */
+    inline ValueType GetCurrentValue( TimelineHandle handle ) const
+    {
+        assert( IsValid( handle ) && "stale or removed timeline handle" );
+        const auto& entry = entries[handle.index];
+        return entry.state == TimelineState::ACTIVE ? system.GetCurrentValue( entry.channel ) : entry.value;
+    }
+
+    /** Get frames played since the timeline started */
+    inline uint64_t GetFrame() const
+    {
+        return frame;
+    }
+
+    /** Get number of motions playing */
+    inline size_t GetLiveCount() const
+    {
+        return system.GetChannelCount();
+    }
+
+    /** Get events of the last update */
+    inline const std::vector<TimelineEvent>& GetEvents() const
+    {
+        return events;
+    }
+
+    /** Get number of pending starts */
+    inline size_t GetPendingCount() const
+    {
+        return starts.size() - stale_starts;
+    }
+
+    /** Get motion system of the playing motions */
+    inline const MotionSystem<ValueType, EasingPolicy>& GetMotionSystem() const
+    {
+        return system;
+    }
+
+private:
+
+    /** Heap order, the earliest start on top */
+    static inline bool Later( const Start& a, const Start& b )
+    {
+        return a.frame > b.frame || ( a.frame == b.frame && a.slot > b.slot );
+    }
+
+    /** Compile a queue into a plan of its own */
+    static MotionPlanPtr CompileQueue( const MotionQueue<ValueType>& params, TimeType frame_duration )
+    {
+        auto plan = std::make_shared<MotionPlan>();
+        plan->Rebuild<EasingPolicy>( params, frame_duration );
+        return plan;
+    }
+
+    /** Take a free entry slot */
+    SlotIdx AcquireSlot()
+    {
+        SlotIdx slot;
+        if( !free_slots.empty() )
+        {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        }
+        else
+        {
+            slot = static_cast<SlotIdx>( entries.size() );
+            entries.emplace_back();
+        }
+
+        entries[slot].used = true;
+        return slot;
+    }
+
+    /** Add a pending start */
+    void PushStart( uint64_t start_frame, SlotIdx slot )
+    {
+        starts.push_back( { start_frame, slot, entries[slot].generation } );
+        std::push_heap( starts.begin(), starts.end(), Later );
+    }
+
+    /** Check if a pending start still belongs to its motion */
+    inline bool IsLive( const Start& start ) const
+    {
+        return entries[start.slot].used && entries[start.slot].generation == start.generation;
+    }
+
+    /** Drop the starts of removed motions from the heap */
+    void CompactStarts()
+    {
+        starts.erase( std::remove_if( starts.begin(), starts.end(), [this]( const Start& start ) { return !IsLive( start ); } ), starts.end() );
+        std::make_heap( starts.begin(), starts.end(), Later );
+        stale_starts = 0;
+    }
+
+    /** Start a run in the motion system */
+    void Activate( SlotIdx slot )
+    {
+        auto& entry = entries[slot];
+        entry.channel = system.Add( entry.start_value, entry.end_value, *entry.plan );
+        entry.state = TimelineState::ACTIVE;
+
+        if( entry.channel.index >= channel_slots.size() )
+        {
+            channel_slots.resize( entry.channel.index + 1, InvalidIdx );
+        }
+        channel_slots[entry.channel.index] = slot;
+        events.push_back( { { slot, entry.generation }, 0, MotionEventType::STARTED } );
+
+        // A channel that is done as it starts never shows up in the system events
+        if( system.HasFinished( entry.channel ) )
+        {
+            instant.emplace_back( slot );
+        }
+    }
+
+    /** Take a finished run out of the system, scheduling the next one if any */
+    void Retire( SlotIdx slot, uint32_t segment_count )
+    {
+        auto& entry = entries[slot];
+        entry.value = system.GetCurrentValue( entry.channel );
+        system.Remove( entry.channel );
+        events.push_back( { { slot, entry.generation }, segment_count, MotionEventType::FINISHED } );
+
+        if( entry.repeats_left == 0 )
+        {
+            entry.state = TimelineState::FINISHED;
+            return;
+        }
+
+        if( entry.repeats_left != TimelineRepeatForever )
+        {
+            entry.repeats_left--;
+        }
+        entry.state = TimelineState::SCHEDULED;
+        PushStart( frame + entry.repeat_delay, slot );
+    }
+
+}; // class Timeline
+
+} // namespace Motion
+
+#endif /** MOTION_TIMELINE_H */
@@ -0,0 +1,163 @@
+/** --------------------------------------------------------
+ *
+ *                    MOTION TEXT
+ *
+ * Parser of the motion definition text format shared by
+ *   MotionTool and libmotion.
+ *
+ * The first line holds the starting value, the ending value
+ *   and the duration in frames. Every following line is one
+ *    queue element: type, acceleration, duration, length,
+ *     start and end of the easing window, then the modifier
+ *      and gravity ( or the four control points of BEZIER ).
+ *       Lines starting with # are comments.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_TEXT_H
+#define MOTION_TEXT_H
+
+#include <istream>
+#include <sstream>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include "../Motion.h"
+
+namespace MotionText
+{
+
+/** Motion definition read from text */
+struct Definition
+{
+    /** Starting value */
+    double start_value { 0 };
+
+    /** Ending value */
+    double end_value { 1 };
+
+    /** Duration in frames */
+    double duration { 1 };
+
+    /** Queue elements, in file order */
+    Motion::MotionQueue<double> queue;
+};
+
+/** Parse a number, INFINITESIMAL being the smallest step */
+inline double ParseValue( const std::string& s )
+{
+    if( s == "INFINITESIMAL" ) return std::numeric_limits<double>::epsilon();
+    return std::stod( s );
+}
+
+/** Parse one queue element line */
+inline Motion::MotionParameters<double> ParseElement( const std::string& line )
+{
+    Motion::MotionParameters<double> param {};
+
+    std::istringstream str( line );
+    std::string s;
+    uint8_t count = 0;
+    while( std::getline( str, s, ',' ) )
+    {
+        s.erase( std::remove_if(s.begin(), s.end(), ::isspace), s.end());
+
+        const auto set_value = [&s]( double& val )
+        {
+            val = ParseValue( s );
+        };
+
+        const bool is_bezier = ( param.motion_type == Motion::Type::BEZIER );
+
+        switch( count )
+        {
+            case 0:
+            {
+                if( s == "POW" )                param.motion_type = Motion::Type::POW;
+                else if( s == "QUAD" )          param.motion_type = Motion::Type::QUAD;
+                else if( s == "CUBIC" )         param.motion_type = Motion::Type::CUBIC;
+                else if( s == "SINE" )          param.motion_type = Motion::Type::SINE;
+                else if( s == "BACK" )          param.motion_type = Motion::Type::BACK;
+                else if( s == "CIRCULAR" )      param.motion_type = Motion::Type::CIRCULAR;
+                else if( s == "ELASTIC" )       param.motion_type = Motion::Type::ELASTIC;
+                else if( s == "BOUNCE" )        param.motion_type = Motion::Type::BOUNCE;
+                else if( s == "EXPONENTIAL" )   param.motion_type = Motion::Type::EXPONENTIAL;
+                else if( s == "BEZIER" )        param.motion_type = Motion::Type::BEZIER;
+                else                            param.motion_type = Motion::Type::LINEAR;
+            }
+            break;
+            case 1:
+            {
+                if( s == "OUT" )    param.accel_type = Motion::Acceleration::OUT;
+                else                param.accel_type = Motion::Acceleration::IN;
+            }
+            break;
+            case 2: set_value( param.duration );        break;
+            case 3: set_value( param.length );          break;
+            case 4: set_value( param.start_value );     break;
+            case 5: set_value( param.end_value );       break;
+            // BEZIER takes its control points instead of the modifier and gravity
+            case 6: set_value( is_bezier ? param.bezier.x1 : param.modifier );  break;
+            case 7: set_value( is_bezier ? param.bezier.y1 : param.gravity );   break;
+            case 8: if( is_bezier ) set_value( param.bezier.x2 );              break;
+            case 9: if( is_bezier ) set_value( param.bezier.y2 );              break;
+            default: break;
+        }
+
+        count++;
+    }
+
+    return param;
+}
+
+/** Read the next line that is not empty or a comment, stripped of whitespace ( empty at the end, lines of any length,
+ *  throws std::invalid_argument if the stream can't be read ) */
+inline std::string NextLine( std::istream& in )
+{
+    std::string str;
+    while( std::getline( in, str ) )
+    {
+        str.erase( std::remove_if(str.begin(), str.end(), ::isspace), str.end());
+        if( str.size() > 0 && str.at(0) != '#' && str.at(0) != '\0' ) return str;
+    }
+
+    if( in.bad() )
+    {
+        throw std::invalid_argument( "MotionText: unreadable input" );
+    }
+    return "";
+}
+
+/** Parse a whole definition, throws std::invalid_argument or std::out_of_range on a malformed number */
+inline Definition Parse( std::istream& in )
+{
+    Definition definition;
+    double* init[] = { &definition.start_value, &definition.end_value, &definition.duration };
+
+    std::string str = NextLine( in );
+
+    std::istringstream ss( str );
+    std::string param;
+    unsigned char count = 0;
+    while( std::getline( ss, param, ',' ) && count < 3 )
+    {
+        *init[count++] = ParseValue( param );
+    }
+
+    // NextLine() is empty only at the end, a last line without a line break included
+    str = NextLine( in );
+    while( !str.empty() )
+    {
+        definition.queue.emplace_back( ParseElement( str ) );
+        str = NextLine( in );
+    }
+
+    return definition;
+}
+
+} // namespace MotionText
+
+#endif /** MOTION_TEXT_H */
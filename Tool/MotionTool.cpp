@@ -4,32 +4,49 @@
 #include <iomanip>
 #include <algorithm>
 #include <functional>
+#include <filesystem>
+#include <chrono>
+#include <set>
 
 #include "../Motion.h"
+#include "../MotionTrace.h"
+#include "../ThreadPool.h"
+#include "MotionText.h"
 
 namespace
 {
     Motion::MotionCore<double> motion(false);
     Motion::MotionQueue<double> queue;
     constexpr auto filename = "motion_in.txt";
+    constexpr auto curve_filename = "motion_curve.bin";
+    constexpr auto trace_filename = "motion_trace.json";
+    constexpr double default_max_error = 0.01;
+    constexpr auto batch_directory = "batch_out";
+    constexpr auto batch_format = "f64";
+
+    constexpr const char* type_names[] =
+    {
+        "LINEAR", "POW", "QUAD", "CUBIC", "BACK", "CIRCULAR", "ELASTIC", "BOUNCE", "SINE", "EXPONENTIAL", "BEZIER"
+    };
 }
 
-void ContinuityCheck()
+void ContinuityCheck( Motion::MotionCore<double>& motion, std::ostream& out )
 {
-    double threshold = 2000.0/motion.GetInterpolatedValues().size();
+    const auto& values = motion.GetInterpolatedValues();
+    double threshold = 2000.0/values.size();
     
-    for( uint32_t i = 1; i < motion.GetInterpolatedValues().size()-1; ++i )
+    for( uint32_t i = 1; i + 1 < values.size(); ++i )
     {
-        double l = std::abs( motion.GetInterpolatedValues()[i]-motion.GetInterpolatedValues()[i-1] );
-        double r = std::abs( motion.GetInterpolatedValues()[i]-motion.GetInterpolatedValues()[i+1] );
+        double l = std::abs( values[i]-values[i-1] );
+        double r = std::abs( values[i]-values[i+1] );
         if( std::abs(l-r) > threshold )
         {
-            std::cout << "- WARNING: Visual discontinuity on frame " << +i << std::endl;
+            out << "- WARNING: Visual discontinuity on frame " << +i << std::endl;
         }
     }
 }
 
-void AnalyzeMotion()
+void AnalyzeMotion( const Motion::MotionQueue<double>& queue, std::ostream& out )
 {
     double total = 0;
     for( const auto& m : queue )
@@ -39,12 +56,12 @@ void AnalyzeMotion()
     
     if( std::fabs( 1.0-total ) > std::numeric_limits<double>::epsilon() )
     {
-        std::cout << "- WARNING: Total duration != 1.0. Check first parameters!" << std::endl;
-        std::cout << "- Remaining value: " << std::setprecision(5) << std::fixed << (1-total) << std::endl;
-        std::cout << "- Suggested new parameters: " << std::endl;
+        out << "- WARNING: Total duration != 1.0. Check first parameters!" << std::endl;
+        out << "- Remaining value: " << std::setprecision(5) << std::fixed << (1-total) << std::endl;
+        out << "- Suggested new parameters: " << std::endl;
         for( uint8_t i = 0; i < queue.size(); ++i )
         {
-            std::cout << "- " << +i << ": " << std::setprecision(4) << std::fixed << queue[i].duration << " -> " << (queue[i].duration + (1.0-total)/queue.size()) << std::endl;
+            out << "- " << +i << ": " << std::setprecision(4) << std::fixed << queue[i].duration << " -> " << (queue[i].duration + (1.0-total)/queue.size()) << std::endl;
         }
     }
     
@@ -56,154 +73,432 @@ void AnalyzeMotion()
     
     if( std::fabs( 1-total ) > std::numeric_limits<double>::epsilon() )
     {
-        std::cout << "- WARNING: Total path != 1.0. Check second parameters!" << std::endl;
-        std::cout << "- Remaining value: " << std::setprecision(10) << std::fixed << (1-total) << std::endl;
-        std::cout << "- Suggested new parameters: " << std::endl;
+        out << "- WARNING: Total path != 1.0. Check second parameters!" << std::endl;
+        out << "- Remaining value: " << std::setprecision(10) << std::fixed << (1-total) << std::endl;
+        out << "- Suggested new parameters: " << std::endl;
         for( uint8_t i = 0; i < queue.size(); ++i )
         {
-            std::cout << "- " << +i << ": " << std::setprecision(4) << std::fixed << queue[i].length << " -> " << (queue[i].length + (1-total)/queue.size()) << std::endl;
+            out << "- " << +i << ": " << std::setprecision(4) << std::fixed << queue[i].length << " -> " << (queue[i].length + (1-total)/queue.size()) << std::endl;
         }
     }
     
 }
 
 
-void AddToQueue( std::string line )
+void ReadFile( const char* filename )
 {
-    Motion::MotionParameters<double> param {};
+    std::ifstream file( filename );
+    
+    if( !file )
+    {
+        std::cerr << "- ERROR: " << filename << " does not exist!" << std::endl;
+        exit(1);
+    }
     
-    std::istringstream str( line );
-    std::string s;
-    uint8_t count = 0;
-    while( std::getline( str, s, ',' ) )
+    MotionText::Definition definition;
+    try
     {
-        s.erase( remove_if(s.begin(), s.end(), isspace), s.end());
+        definition = MotionText::Parse( file );
+    }
+    catch( const std::logic_error& )
+    {
+        std::cerr << "- ERROR: " << filename << " has a malformed number!" << std::endl;
+        exit(1);
+    }
+    
+    queue = definition.queue;
+    motion.SetParameters( definition.start_value, definition.end_value, static_cast<Motion::TimeType>(definition.duration), queue );
+    
+    file.close();
+    
+    std::cout << "File parsed successfully" << std::endl;
+    
+}
 
-        const auto set_value = [&s]( double& val )
+Motion::SampleFormat ParseFormat( const std::string& format )
+{
+    if( format == "f32" ) return Motion::SampleFormat::F32;
+    if( format == "i16" ) return Motion::SampleFormat::I16;
+    if( format != "f64" )
+    {
+        std::cerr << "- ERROR: Unknown sample format " << format << ", expected f32, f64 or i16!" << std::endl;
+        exit(1);
+    }
+    return Motion::SampleFormat::F64;
+}
+
+/** Play the motion frame by frame, as a runtime calculated motion would, recording every frame */
+void TracePlayback( Motion::TraceRecorder& trace )
+{
+    Motion::MotionCore<double> player;
+    player.SetParameters( motion.GetStartingValue(), motion.GetEndingValue(), motion.GetFrameDuration(), motion.GetMotionQueue() );
+
+    const Motion::TraceRecorder::Scope scope( trace, "play", "tool" );
+    for( uint32_t frame = 1; !player.HasFinished(); ++frame )
+    {
+        const auto segment = player.GetSegmentIndex();
+        const auto begin = trace.Now();
+        player.AdvanceToNext();
+        const auto end = trace.Now();
+
+        trace.Complete( "frame", "motion", begin, end,
+            Motion::TraceRecorder::Arg( "frame", frame ) + "," + Motion::TraceRecorder::Arg( "value", player.GetCurrentValue() ) + "," + Motion::TraceRecorder::Arg( "segment", segment ) );
+        trace.Counter( "value", end, player.GetCurrentValue() );
+
+        if( player.GetSegmentIndex() != segment )
         {
-            if( s == "INFINITESIMAL" ) val = std::numeric_limits<double>::epsilon();
-            else val = std::stod(s);
-        };
+            trace.Instant( "segment " + std::to_string( segment ) + " done", "motion", end, Motion::TraceRecorder::Arg( "frame", frame ) );
+        }
+    }
+}
+
+/** Fit the baked values with a compressed curve and report what it saves */
+void ReportCompression( double max_error )
+{
+    const auto& values = motion.GetInterpolatedValues();
+    const auto curve = Motion::CompressedCurve::Fit( values.begin(), values.end(), max_error );
+    const auto raw_bytes = values.size() * sizeof(double);
 
-        switch( count )
+    std::cout << "- Compression: " << curve.GetSegmentCount() << " segments, ratio " << std::setprecision(1) << std::fixed
+              << ( curve.GetByteSize() ? double(raw_bytes) / curve.GetByteSize() : 0.0 ) << ":1, max error "
+              << std::setprecision(6) << curve.GetMaxError() << " ( bound " << max_error << " )" << std::endl;
+}
+
+/** Print the instrumentation counters */
+void PrintStats( const Motion::StatsSnapshot& stats )
+{
+    if( !Motion::StatsEnabled )
+    {
+        std::cout << "- Stats: not compiled in, build with -DMOTION_STATS=1" << std::endl;
+        return;
+    }
+
+    std::cout << "- Stats:" << std::endl;
+    for( size_t t = 0; t < sizeof(type_names) / sizeof(type_names[0]); ++t )
+    {
+        if( stats.evaluations[t] > 0 )
         {
-            case 0:
-            {
-                if( s == "POW" )                param.motion_type = Motion::Type::POW;
-                else if( s == "QUAD" )          param.motion_type = Motion::Type::QUAD;
-                else if( s == "CUBIC" )         param.motion_type = Motion::Type::CUBIC;
-                else if( s == "SINE" )          param.motion_type = Motion::Type::SINE;
-                else if( s == "BACK" )          param.motion_type = Motion::Type::BACK;
-                else if( s == "CIRCULAR" )      param.motion_type = Motion::Type::CIRCULAR;
-                else if( s == "ELASTIC" )       param.motion_type = Motion::Type::ELASTIC;
-                else if( s == "BOUNCE" )        param.motion_type = Motion::Type::BOUNCE;
-                else if( s == "EXPONENTIAL" )   param.motion_type = Motion::Type::EXPONENTIAL;
-                else                            param.motion_type = Motion::Type::LINEAR;
-            }
-            break;
-            case 1:
+            std::cout << "-   " << std::left << std::setw(22) << std::string( type_names[t] ) + " evaluations" << std::right << stats.evaluations[t] << std::endl;
+        }
+    }
+    for( size_t c = 0; c < Motion::StatsCounterCount; ++c )
+    {
+        std::cout << "-   " << std::left << std::setw(22) << Motion::StatsCounterNames[c] << std::right << stats.counters[c] << std::endl;
+    }
+    std::cout << "-   " << std::left << std::setw(22) << "ns/calculation" << std::right << std::setprecision(1) << std::fixed << stats.GetCalculationNanoseconds() << std::endl;
+}
+
+/** Add the instrumentation counters to a trace */
+void TraceStats( Motion::TraceRecorder& trace, const Motion::StatsSnapshot& stats )
+{
+    std::string args;
+    for( size_t c = 0; c < Motion::StatsCounterCount; ++c )
+    {
+        args += ( c ? "," : "" ) + Motion::TraceRecorder::Arg( Motion::StatsCounterNames[c], stats.counters[c] );
+    }
+    args += "," + Motion::TraceRecorder::Arg( "evaluations", stats.GetEvaluations() );
+    trace.Instant( "stats", "tool", trace.Now(), args );
+}
+
+/** One input of a batch run */
+struct BatchItem
+{
+    /** Definition file */
+    std::string input;
+
+    /** Baked curve written for it */
+    std::string output;
+
+    /** Warnings and errors, printed in input order once all are done */
+    std::string report;
+
+    /** Samples baked */
+    size_t samples {};
+
+    /** Failure flag */
+    bool failed {};
+};
+
+/** List the inputs of a batch: every .txt file of a directory, or every line of a manifest ( relative to it ) */
+std::vector<std::string> ListBatchInputs( const std::string& source )
+{
+    namespace fs = std::filesystem;
+
+    std::vector<std::string> inputs;
+    std::error_code error;
+    if( fs::is_directory( source, error ) )
+    {
+        for( const auto& entry : fs::directory_iterator( source, error ) )
+        {
+            if( entry.is_regular_file() && entry.path().extension() == ".txt" )
             {
-                if( s == "OUT" )    param.accel_type = Motion::Acceleration::OUT;
-                else                param.accel_type = Motion::Acceleration::IN;
+                inputs.push_back( entry.path().string() );
             }
-            break;
-            case 2: set_value( param.duration );        break;
-            case 3: set_value( param.length );          break;
-            case 4: set_value( param.start_value );     break;
-            case 5: set_value( param.end_value );       break;
-            case 6: set_value( param.modifier );        break;
-            case 7: set_value( param.gravity );         break;
-            default: break;
         }
+        std::sort( inputs.begin(), inputs.end() );
+        return inputs;
+    }
 
-        count++;
+    std::ifstream manifest( source );
+    if( !manifest )
+    {
+        std::cerr << "- ERROR: " << source << " is neither a directory nor a manifest!" << std::endl;
+        exit(1);
     }
 
-    queue.emplace_back( std::move(param) );
+    const auto base = fs::path( source ).parent_path();
+    std::string line;
+    while( std::getline( manifest, line ) )
+    {
+        line.erase( 0, line.find_first_not_of( " \t\r" ) );
+        line.erase( line.find_last_not_of( " \t\r" ) + 1 );
+        if( line.empty() || line[0] == '#' )
+        {
+            continue;
+        }
+
+        const fs::path path( line );
+        inputs.push_back( ( path.is_absolute() ? path : base / path ).string() );
+    }
+    return inputs;
 }
 
-std::string FilterComments( std::ifstream& file )
+/** Output of a batch input: its path under the batch source, or just its name when it lies outside */
+std::string GetBatchOutput( const std::string& input, const std::string& source, const std::string& directory, const std::string& format )
 {
-    char tmp[1024];
-    std::string str;
-    while(1)
+    namespace fs = std::filesystem;
+
+    std::error_code error;
+    const auto base = ( fs::is_directory( source, error ) ? fs::path( source ) : fs::path( source ).parent_path() );
+    auto relative = fs::path( input ).lexically_relative( base );
+    if( relative.empty() || *relative.begin() == ".." )
     {
-        file.getline( tmp, 256 );
-        str = tmp;
-        str.erase( remove_if(str.begin(), str.end(), isspace), str.end());
-        if( str.size() > 0 && str.at(0) != '#' && str.at(0) != '\0' ) return str;
-        else if( file.eof() ) return "";
+        relative = fs::path( input ).filename();
     }
-    
+    return ( fs::path( directory ) / relative ).replace_extension( format == "csv" ? ".csv" : ".bin" ).string();
 }
 
-void ReadFile( const char* filename )
+/** Write baked values as CSV, one frame per row */
+bool WriteCsv( const std::string& path, Motion::MotionCore<double>& motion )
 {
-    std::ifstream file( filename );
-    
-    if( !file )
+    std::ofstream file( path );
+    file << "frame,value\n" << std::setprecision( std::numeric_limits<double>::max_digits10 );
+    for( size_t i = 0; i < motion.GetBakedCount(); ++i )
     {
-        std::cerr << "- ERROR: " << filename << " does not exist!" << std::endl;
-        exit(1);
+        file << i + 1 << ',' << motion.GetBakedValue( i ) << '\n';
     }
-    
-    double init[] =
+    return static_cast<bool>( file );
+}
+
+/** Bake and analyze one batch input, writing its output */
+void BakeBatchItem( BatchItem& item, const std::string& format )
+{
+    std::ostringstream report;
+    std::ifstream file( item.input );
+    MotionText::Definition definition;
+    try
     {
-        0,  // Start
-        1,  // End
-        1   // Duration
-    };
-    
-    
-    std::string str = FilterComments( file ); 
-    
-    std::istringstream ss( str );
-    std::string param;
-    unsigned char count = 0;
-    while( std::getline( ss, param, ',' ) )
+        item.failed = !file;
+        if( file )
+        {
+            definition = MotionText::Parse( file );
+        }
+    }
+    catch( const std::logic_error& )
+    {
+        item.failed = true;
+    }
+
+    if( item.failed )
+    {
+        item.report = "- ERROR: Could not parse " + item.input + "!\n";
+        return;
+    }
+
+    Motion::MotionCore<double> motion( false );
+    motion.SetParameters( definition.start_value, definition.end_value, static_cast<Motion::TimeType>(definition.duration), definition.queue );
+    AnalyzeMotion( definition.queue, report );
+    ContinuityCheck( motion, report );
+    item.samples = motion.GetBakedCount();
+
+    const auto written = ( format == "csv" ? WriteCsv( item.output, motion ) : motion.SaveCurveFile( item.output, ParseFormat( format ) ) );
+    if( !written )
     {
-        if( param == "INFINITESIMAL" )
+        item.failed = true;
+        report << "- ERROR: Could not write " << item.output << "!" << std::endl;
+    }
+    item.report = report.str();
+}
+
+/** Bake every input of a directory or manifest in parallel, one output each at the same relative path, returns the exit code */
+int RunBatch( const std::string& source, const std::string& directory, const std::string& format, size_t jobs )
+{
+    namespace fs = std::filesystem;
+
+    // Validate the format once, before any worker runs
+    if( format != "csv" )
+    {
+        ParseFormat( format );
+    }
+
+    std::error_code error;
+    fs::create_directories( directory, error );
+    if( error )
+    {
+        std::cerr << "- ERROR: Could not create " << directory << "!" << std::endl;
+        return 1;
+    }
+
+    // Outputs keep the layout of the inputs, an output that would be written twice fails instead of overwriting
+    std::vector<BatchItem> items;
+    std::set<std::string> outputs;
+    for( auto& input : ListBatchInputs( source ) )
+    {
+        BatchItem item;
+        item.output = GetBatchOutput( input, source, directory, format );
+        item.input = std::move( input );
+        if( !outputs.insert( item.output ).second )
         {
-            init[count] = std::numeric_limits<double>::epsilon();
+            item.failed = true;
+            item.report = "- ERROR: " + item.output + " is already written for another input!\n";
         }
         else
         {
-            init[count] = std::stod( param );
+            fs::create_directories( fs::path( item.output ).parent_path(), error );
         }
-        count++;
+        items.push_back( std::move( item ) );
     }
-    
-    str = FilterComments( file ); 
-    
-    while(1)
+
+    Motion::ThreadPool pool( jobs );
+    const auto begin = std::chrono::steady_clock::now();
+    pool.ForEach( items, [&format]( BatchItem& item ) { if( !item.failed ) BakeBatchItem( item, format ); }, 1 );
+    const auto seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+
+    size_t failed = 0;
+    size_t samples = 0;
+    uintmax_t bytes = 0;
+    for( const auto& item : items )
     {
-        if( file.eof() ) break;
-        AddToQueue( str );
-        str = FilterComments( file ); 
+        if( !item.report.empty() )
+        {
+            std::cout << item.input << ":" << std::endl << item.report;
+        }
+
+        failed += item.failed;
+        samples += item.samples;
+        bytes += ( item.failed ? 0 : fs::file_size( item.output, error ) );
     }
-    
-    motion.SetParameters( init[0], init[1], static_cast<Motion::TimeType>(init[2]), queue );
-    
-    file.close();
-    
-    std::cout << "File parsed successfully" << std::endl;
-    
+
+    std::cout << "Batch: " << items.size() << " files ( " << failed << " failed ) in " << std::setprecision(1) << std::fixed << seconds * 1000 << " ms on " << pool.GetWorkerCount() << " threads" << std::endl;
+    std::cout << "- Throughput: " << std::setprecision(0) << items.size() / seconds << " files/s, " << samples / seconds << " samples/s, "
+              << std::setprecision(1) << bytes / seconds / (1 << 20) << " MiB/s" << std::endl;
+    std::cout << "- Output: " << directory << " ( " << format << " )" << std::endl;
+
+    return failed == 0 ? 0 : 1;
 }
 
 int main( int argc, const char* argv[] )
 {
-    if( argc < 2 )
+    // Positional arguments are the input file and the curve sample format, options may go anywhere
+    std::vector<std::string> args;
+    std::string trace_path;
+    double max_error = default_max_error;
+    bool stats = false;
+    std::string batch_source;
+    std::string batch_out = batch_directory;
+    std::string format = batch_format;
+    size_t jobs = 0;
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+        // The trace path is only ever given as --trace=path, so the option can't take the input file
+        if( arg == "--trace" )
+        {
+            trace_path = trace_filename;
+        }
+        else if( arg.compare( 0, 8, "--trace=" ) == 0 )
+        {
+            trace_path = arg.substr( 8 );
+        }
+        else if( arg == "--max-error" && i + 1 < argc )
+        {
+            max_error = std::stod( argv[++i] );
+        }
+        else if( arg == "--stats" )
+        {
+            stats = true;
+        }
+        else if( arg == "--batch" && i + 1 < argc )
+        {
+            batch_source = argv[++i];
+        }
+        else if( arg == "--out" && i + 1 < argc )
+        {
+            batch_out = argv[++i];
+        }
+        else if( arg == "--format" && i + 1 < argc )
+        {
+            format = argv[++i];
+        }
+        else if( arg == "--jobs" && i + 1 < argc )
+        {
+            jobs = std::stoul( argv[++i] );
+        }
+        else
+        {
+            args.push_back( arg );
+        }
+    }
+
+    if( !batch_source.empty() )
+    {
+        return RunBatch( batch_source, batch_out, format, jobs );
+    }
+
+    Motion::TraceRecorder trace;
+    {
+        const Motion::TraceRecorder::Scope scope( trace, "read and bake", "tool" );
+        ReadFile( args.empty() ? filename : args[0].c_str() );
+    }
+
+    {
+        const Motion::TraceRecorder::Scope scope( trace, "dump", "tool" );
+        motion.DumpToFile( "motion_plot.xls" );
+    }
+
+    {
+        const Motion::TraceRecorder::Scope scope( trace, "save curve", "tool" );
+        if( !motion.SaveCurveFile( curve_filename, ParseFormat( args.size() > 1 ? args[1] : "f64" ) ) )
+        {
+            std::cerr << "- ERROR: Could not write " << curve_filename << "!" << std::endl;
+            exit(1);
+        }
+    }
+    AnalyzeMotion( queue, std::cout );
+    ContinuityCheck( motion, std::cout );
+    ReportCompression( max_error );
+
+    if( !trace_path.empty() )
+    {
+        TracePlayback( trace );
+        TraceStats( trace, Motion::Stats::Snapshot() );
+        if( !trace.Write( trace_path ) )
+        {
+            std::cerr << "- ERROR: Could not write " << trace_path << "!" << std::endl;
+            exit(1);
+        }
+        std::cout << "Open " << trace_path << " in ui.perfetto.dev or chrome://tracing to see the timeline." << std::endl;
+    }
+
+    if( stats && !Motion::StatsEnabled )
     {
-        ReadFile( filename );
+        std::cerr << "- WARNING: Built without stats, rebuild with make STATS=1 to count them!" << std::endl;
     }
-    else
+    else if( stats )
     {
-        ReadFile( argv[1] );
+        PrintStats( Motion::Stats::Snapshot() );
     }
 
-    motion.DumpToFile( "motion_plot.xls" );
-    AnalyzeMotion();
-    ContinuityCheck();
     std::cout << "Open motion_plot.xls in MS Excel or LibreOffice Calc to chart the data." << std::endl;
     
     return 0;
@@ -3,8 +3,17 @@
 from Tkinter import *
 from PIL import Image, ImageTk
 import time
+import mmap
+import struct
+import os
+import ctypes
 from subprocess import call
 
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
 fps_del = 1000/60
 
 root = Tk()
@@ -22,6 +31,7 @@ animW = 300
 animH = 300
     
 filename = 'motion_plot.xls'
+curveFilename = 'motion_curve.bin'
 
 examples = [ 'linear', 
              'pow', 
@@ -33,7 +43,8 @@ examples = [ 'linear',
              'bounce', 
              'sbounce', 
              'sine', 
-             'exp'
+             'exp',
+             'bezier'
             ]
 example_dir = [ 'in', 'out', 'both' ]
 
@@ -43,8 +54,11 @@ example_dir = [ 'in', 'out', 'both' ]
 def Interpolate():
     file = 'examples/' + examples[selected] + '_' + example_dir[accel] + '.txt'
     SetText( file )
-    call(["./MotionTool", file])
-    ReadFile()
+    with open( file ) as f:
+        text = f.read()
+    if not Preview( text ):
+        call(["./MotionTool", file])
+        ReadFile()
   
 # Read values file
 
@@ -54,6 +68,79 @@ graphValues = []
 currentLine = 0
 currentIntersect = 0
 
+# Binary curve file, see CurveFile.h ( header, queue table, aligned samples )
+
+curveHeader = struct.Struct( '=4sHBBIIQQdddd' )
+sampleFormats = [ 'f', 'd', 'h' ]
+
+def ReadCurveFile( path ):
+    with open( path, 'rb' ) as f:
+        data = mmap.mmap( f.fileno(), 0, access=mmap.ACCESS_READ )
+    try:
+        magic, version, format, _, segments, offset, count, _, _, _, quantOffset, quantScale = curveHeader.unpack_from( data, 0 )
+        if magic != b'MCRV' or version not in ( 1, 2 ) or format >= len(sampleFormats):
+            raise ValueError( 'not a curve file' )
+        samples = struct.unpack_from( '=%d%s' % (count, sampleFormats[format]), data, offset )
+    finally:
+        data.close()
+    if format == 2:
+        return [ quantOffset + quantScale * x for x in samples ]
+    return list( samples )
+
+# In-process baking through libmotion.so, see libmotion.h ( MotionTool is run instead when it is missing )
+
+def LoadLibrary():
+    try:
+        lib = ctypes.CDLL( os.path.abspath( 'libmotion.so' ) )
+    except OSError:
+        return None
+    lib.motion_parse.restype = ctypes.c_void_p
+    lib.motion_parse.argtypes = [ ctypes.c_char_p ]
+    lib.motion_destroy.restype = None
+    lib.motion_destroy.argtypes = [ ctypes.c_void_p ]
+    lib.motion_get_sample_count.restype = ctypes.c_size_t
+    lib.motion_get_sample_count.argtypes = [ ctypes.c_void_p ]
+    lib.motion_bake.restype = ctypes.c_size_t
+    lib.motion_bake.argtypes = [ ctypes.c_void_p, ctypes.POINTER( ctypes.c_double ), ctypes.c_size_t ]
+    return lib
+
+libmotion = LoadLibrary()
+
+def BakeText( text ):
+    curve = libmotion.motion_parse( text.encode( 'ascii', 'ignore' ) )
+    if not curve:
+        raise ValueError( 'malformed motion definition' )
+    try:
+        count = libmotion.motion_get_sample_count( curve )
+        # Samples are written straight into the returned buffer
+        if numpy is not None:
+            samples = numpy.empty( count, dtype=numpy.float64 )
+            buffer = samples.ctypes.data_as( ctypes.POINTER( ctypes.c_double ) )
+        else:
+            samples = ( ctypes.c_double * count )()
+            buffer = samples
+        libmotion.motion_bake( curve, buffer, count )
+    finally:
+        libmotion.motion_destroy( curve )
+    return samples
+
+def Preview( text ):
+    
+    global interpolatedValues
+    global currentValue
+    
+    if libmotion is None:
+        return False
+    
+    try:
+        interpolatedValues = BakeText( text )
+    except ValueError:
+        return False
+    
+    currentValue = 0
+    Plot()
+    return True
+
 def ReadFile():
     
     global interpolatedValues
@@ -61,9 +148,12 @@ def ReadFile():
     
     currentValue = 0
     
-    with open( filename ) as f:
-        interpolatedValues = f.readlines()
-        interpolatedValues = [float(x.strip()) for x in interpolatedValues] 
+    try:
+        interpolatedValues = ReadCurveFile( curveFilename )
+    except (IOError, ValueError):
+        with open( filename ) as f:
+            interpolatedValues = f.readlines()
+            interpolatedValues = [float(x.strip()) for x in interpolatedValues] 
     
     Plot()
     
@@ -238,6 +328,7 @@ def SelectBounce(): global selected; selected = 7; Interpolate()
 def SelectSBounce(): global selected; selected = 8; Interpolate()
 def SelectSine(): global selected; selected = 9; Interpolate()
 def SelectExp(): global selected; selected = 10; Interpolate()
+def SelectBezier(): global selected; selected = 11; Interpolate()
 linButton = Button( bf, text="Linear", command=SelectLinear )
 powButton = Button( bf, text="Pow", command=SelectPow )
 quadButton = Button( bf, text="Quad", command=SelectQuad )
@@ -249,6 +340,7 @@ bounceButton = Button( bf, text="Bounce", command=SelectBounce )
 sBounceButton = Button( bf, text="Single Bounce", command=SelectSBounce )
 sineButton = Button( bf, text="Sine", command=SelectSine )
 expButton = Button( bf, text="Exponential", command=SelectExp )
+bezierButton = Button( bf, text="Bezier", command=SelectBezier )
 linButton.pack( fill=X )
 powButton.pack( fill=X )
 quadButton.pack( fill=X )
@@ -260,6 +352,7 @@ bounceButton.pack( fill=X )
 sBounceButton.pack( fill=X )
 sineButton.pack( fill=X )
 expButton.pack( fill=X )
+bezierButton.pack( fill=X )
 
 
 # Parameters
@@ -465,6 +558,9 @@ gravEntry.pack( side = LEFT )
     
 def Compile():
     
+    if Preview( textBox.get("1.0",END) ):
+        return
+    
     file = 'motion_input.txt'
     f = open( file, 'w' )
     f.write( textBox.get("1.0",END) )
@@ -0,0 +1,208 @@
+#include <cmath>
+#include <new>
+#include <limits>
+#include <sstream>
+
+#include "libmotion.h"
+#include "MotionText.h"
+
+struct motion_curve
+{
+    /** Runtime calculated motion, stepped frame by frame into the caller's buffer */
+    Motion::MotionCore<double> core;
+
+    /** Queue elements, in definition order */
+    Motion::MotionQueue<double> queue;
+
+    /** Starting value */
+    double start_value {};
+
+    /** Ending value */
+    double end_value {};
+
+    /** Duration in frames */
+    uint32_t frames {};
+
+    /** Queue or range changed since the plan was compiled */
+    bool dirty { true };
+
+    /** Compile the plan if anything changed */
+    void Prepare()
+    {
+        if( dirty )
+        {
+            core.SetParameters( start_value, end_value, frames, queue );
+            dirty = false;
+        }
+    }
+};
+
+namespace
+{
+    /** Append a queue element to a curve */
+    int AddElement( motion_curve* curve, const Motion::MotionParameters<double>& param )
+    {
+        if( !curve )
+        {
+            return MOTION_ERROR_ARGUMENT;
+        }
+
+        curve->queue.push_back( param );
+        curve->dirty = true;
+        return MOTION_OK;
+    }
+}
+
+extern "C" {
+
+uint32_t motion_api_version( void )
+{
+    return MOTION_API_VERSION;
+}
+
+motion_curve* motion_create( double start_value, double end_value, uint32_t frames )
+{
+    auto curve = new (std::nothrow) motion_curve;
+    if( curve )
+    {
+        motion_set_range( curve, start_value, end_value, frames );
+    }
+    return curve;
+}
+
+motion_curve* motion_parse( const char* text )
+{
+    if( !text )
+    {
+        return nullptr;
+    }
+
+    MotionText::Definition definition;
+    try
+    {
+        std::istringstream in( text );
+        definition = MotionText::Parse( in );
+    }
+    catch( const std::logic_error& )
+    {
+        return nullptr;
+    }
+
+    auto curve = motion_create( definition.start_value, definition.end_value, static_cast<uint32_t>( definition.duration ) );
+    if( curve )
+    {
+        curve->queue = std::move( definition.queue );
+    }
+    return curve;
+}
+
+void motion_destroy( motion_curve* curve )
+{
+    delete curve;
+}
+
+int motion_set_range( motion_curve* curve, double start_value, double end_value, uint32_t frames )
+{
+    if( !curve )
+    {
+        return MOTION_ERROR_ARGUMENT;
+    }
+
+    curve->start_value = start_value;
+    curve->end_value = end_value;
+    curve->frames = frames;
+    curve->dirty = true;
+    return MOTION_OK;
+}
+
+int motion_add_segment( motion_curve* curve, int type, int accel, double duration, double length,
+                        double window_start, double window_end, double modifier, double gravity )
+{
+    if( type < MOTION_LINEAR || type > MOTION_BEZIER || ( accel != MOTION_IN && accel != MOTION_OUT ) )
+    {
+        return MOTION_ERROR_ARGUMENT;
+    }
+
+    Motion::MotionParameters<double> param {};
+    param.motion_type = static_cast<Motion::Type>( type );
+    param.accel_type = static_cast<Motion::Acceleration>( accel );
+    param.duration = duration;
+    param.length = length;
+    param.start_value = window_start;
+    param.end_value = window_end;
+    param.modifier = modifier;
+    param.gravity = gravity;
+    return AddElement( curve, param );
+}
+
+int motion_add_bezier( motion_curve* curve, double duration, double length,
+                       double x1, double y1, double x2, double y2 )
+{
+    Motion::MotionParameters<double> param {};
+    param.motion_type = Motion::Type::BEZIER;
+    param.accel_type = Motion::Acceleration::IN;
+    param.duration = duration;
+    param.length = length;
+    param.start_value = 0;
+    param.end_value = 1;
+    param.bezier.x1 = x1;
+    param.bezier.y1 = y1;
+    param.bezier.x2 = x2;
+    param.bezier.y2 = y2;
+    return AddElement( curve, param );
+}
+
+int motion_clear( motion_curve* curve )
+{
+    if( !curve )
+    {
+        return MOTION_ERROR_ARGUMENT;
+    }
+
+    curve->queue.clear();
+    curve->dirty = true;
+    return MOTION_OK;
+}
+
+size_t motion_get_sample_count( motion_curve* curve )
+{
+    return curve ? curve->frames : 0;
+}
+
+size_t motion_bake( motion_curve* curve, double* samples, size_t capacity )
+{
+    if( !curve )
+    {
+        return 0;
+    }
+
+    // Same frames as a baked MotionCore, without the intermediate vector
+    curve->Prepare();
+    curve->core.Reset();
+
+    const size_t count = ( samples ? std::min<size_t>( capacity, curve->frames ) : 0 );
+    for( size_t i = 0; i < count; ++i )
+    {
+        curve->core.AdvanceToNext();
+        samples[i] = curve->core.GetCurrentValue();
+    }
+    return curve->frames;
+}
+
+double motion_evaluate( motion_curve* curve, double frame )
+{
+    if( !curve )
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    curve->Prepare();
+
+    const auto clamped = ( frame > 0 ? std::fmin( frame, curve->frames ) : 0.0 );
+    const auto whole = std::floor( clamped );
+    curve->core.Seek( static_cast<Motion::TimeType>( whole ) );
+    curve->core.AdvanceBy( clamped - whole );
+    return curve->core.GetCurrentValue();
+}
+
+} // extern "C"
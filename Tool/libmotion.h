@@ -0,0 +1,102 @@
+/** --------------------------------------------------------
+ *
+ *                     LIBMOTION
+ *
+ * C interface of the motion library, built as libmotion.so
+ *   so tools in other languages can build, bake and evaluate
+ *    motions in process instead of running MotionTool.
+ *
+ * A curve is an opaque handle owning a motion queue and its
+ *   compiled plan. Baking writes straight into a buffer owned
+ *    by the caller. Functions returning int give MOTION_OK or
+ *     a negative error code. A curve is not thread safe, but
+ *      separate curves may be used from separate threads.
+ *
+ * The interface only grows: functions keep their signature
+ *   once released, and MOTION_API_VERSION is bumped whenever
+ *    one is added.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_LIBMOTION_H
+#define MOTION_LIBMOTION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #define MOTION_API __declspec(dllexport)
+#else
+    #define MOTION_API __attribute__((visibility("default")))
+#endif
+
+#define MOTION_API_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Result codes */
+enum
+{
+    MOTION_OK = 0,
+    MOTION_ERROR_ARGUMENT = -1,     /* Null curve or buffer, or an unknown type */
+    MOTION_ERROR_PARSE = -2,        /* Malformed definition text */
+};
+
+/** Easing types, same values as Motion::Type */
+enum
+{
+    MOTION_LINEAR, MOTION_POW, MOTION_QUAD, MOTION_CUBIC, MOTION_BACK, MOTION_CIRCULAR,
+    MOTION_ELASTIC, MOTION_BOUNCE, MOTION_SINE, MOTION_EXPONENTIAL, MOTION_BEZIER,
+};
+
+/** Acceleration types, same values as Motion::Acceleration */
+enum
+{
+    MOTION_IN, MOTION_OUT,
+};
+
+/** Motion curve */
+typedef struct motion_curve motion_curve;
+
+/** Get version of the interface the library implements */
+MOTION_API uint32_t motion_api_version( void );
+
+/** Create an empty curve ( NULL when out of memory ) */
+MOTION_API motion_curve* motion_create( double start_value, double end_value, uint32_t frames );
+
+/** Create a curve from definition text in the MotionTool format ( NULL on a parse error ) */
+MOTION_API motion_curve* motion_parse( const char* text );
+
+/** Destroy a curve ( NULL is ignored ) */
+MOTION_API void motion_destroy( motion_curve* curve );
+
+/** Set starting value, ending value and duration in frames */
+MOTION_API int motion_set_range( motion_curve* curve, double start_value, double end_value, uint32_t frames );
+
+/** Append a queue element ( duration and length are shares of the whole motion ) */
+MOTION_API int motion_add_segment( motion_curve* curve, int type, int accel, double duration, double length,
+                                   double window_start, double window_end, double modifier, double gravity );
+
+/** Append a cubic-bezier queue element with control points ( x1, y1 ) and ( x2, y2 ) */
+MOTION_API int motion_add_bezier( motion_curve* curve, double duration, double length,
+                                  double x1, double y1, double x2, double y2 );
+
+/** Remove every queue element */
+MOTION_API int motion_clear( motion_curve* curve );
+
+/** Get number of samples a bake produces, one per frame */
+MOTION_API size_t motion_get_sample_count( motion_curve* curve );
+
+/** Bake up to capacity samples into a caller buffer, returns the number of samples of the curve */
+MOTION_API size_t motion_bake( motion_curve* curve, double* samples, size_t capacity );
+
+/** Evaluate the curve at a frame since the start, which may be fractional */
+MOTION_API double motion_evaluate( motion_curve* curve, double frame );
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /** MOTION_LIBMOTION_H */
@@ -0,0 +1,91 @@
+/** --------------------------------------------------------
+ *
+ *                   TRIPLE BUFFER
+ *
+ * Wait-free hand-over of whole frames from one writer thread
+ *   to one reader thread, used to publish motion values to a
+ *    render thread without locking either side.
+ *
+ * The writer fills its back buffer and swaps it with the
+ *   middle one in a single atomic exchange. The reader swaps
+ *    its front buffer with the middle one only when a newer
+ *     frame was published, so it always holds a complete frame
+ *      that the writer will not touch until it is given back.
+ *
+-------------------------------------------------------- **/
+
+#ifndef MOTION_TRIPLE_BUFFER_H
+#define MOTION_TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "AlignedAllocator.h"
+
+namespace Motion
+{
+
+/** Single-writer single-reader frame publication ( T is filled in place and reused ) */
+template<typename T>
+class TripleBuffer
+{
+    /** Middle index flag set by a publish and cleared by the read taking it */
+    static constexpr uint8_t FreshBit = 4;
+
+    /** Middle index bits */
+    static constexpr uint8_t IndexMask = 3;
+
+private:
+
+    /** Buffers, one owned by each side and one in between */
+    T buffers[3];
+
+    /** Buffer in between, with FreshBit while unread */
+    alignas(CacheLineSize) std::atomic<uint8_t> middle { 1 };
+
+    /** Buffer being written, owned by the writer */
+    alignas(CacheLineSize) uint8_t back { 0 };
+
+    /** Buffer being read, owned by the reader */
+    alignas(CacheLineSize) uint8_t front { 2 };
+
+public:
+
+    TripleBuffer() = default;
+
+    TripleBuffer( const TripleBuffer& ) = delete;
+    TripleBuffer& operator=( const TripleBuffer& ) = delete;
+
+    /** Get buffer to fill for the next publish ( writer only, holds an older frame ) */
+    inline T& GetWriteBuffer()
+    {
+        return buffers[back];
+    }
+
+    /** Hand the write buffer over to the reader ( writer only ) */
+    inline void Publish()
+    {
+        back = middle.exchange( back | FreshBit, std::memory_order_acq_rel ) & IndexMask;
+    }
+
+    /** Get the latest published frame ( reader only, stays intact until the next call ) */
+    inline const T& Acquire()
+    {
+        if( middle.load( std::memory_order_relaxed ) & FreshBit )
+        {
+            front = middle.exchange( front, std::memory_order_acq_rel ) & IndexMask;
+        }
+        return buffers[front];
+    }
+
+    /** Check if a frame was published since the last acquire */
+    inline bool HasNewFrame() const
+    {
+        return middle.load( std::memory_order_relaxed ) & FreshBit;
+    }
+
+}; // class TripleBuffer
+
+} // namespace Motion
+
+#endif /** MOTION_TRIPLE_BUFFER_H */